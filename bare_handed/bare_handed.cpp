@@ -7,6 +7,7 @@
 
 #include "bare_handed_debug.cpp"
 #include "bare_handed_config.cpp"
+#include "../common/party_snapshot.cpp"
 
 /**
  * @namespace BareHanded
@@ -21,20 +22,47 @@ namespace BareHanded
     bool weaponsEquipped = false;
 
     /**
-     * @brief Finds an actor ID based on its associated variable ID.
-     * @param variableId The variable ID to search for.
-     * @return The actor ID if found, 0 if not found.
-     * @details Searches through the actor-variable mapping to find which actor
-     *          is associated with a given variable ID for weapon configuration.
-     * @see BareHandedConfig::actorVariableMap
+     * @brief Last checked state of one party slot.
+     * @details The variable-based equip logic only reruns for a slot when
+     *          one of these values differs from the current state.
      */
-    int findActorByVariableId(int variableId) {
-        for (auto const& pair : BareHandedConfig::actorVariableMap) {
-            if (pair.second == variableId) {
-                return pair.first; // Return the actor ID
+    struct SlotFingerprint {
+        int actorId;        ///< Actor in the slot, 0 if empty, -1 if never checked
+        int variableId;     ///< Cached weapon variable ID of the actor, 0 if none
+        int weaponId;       ///< Weapon ID after the last check
+        int shieldId;       ///< Shield ID after the last check
+        int variableValue;  ///< Weapon variable value at the last check
+        bool dirty;         ///< Forces a check on the next map frame
+    };
+
+    /** @brief Fingerprints of the 4 party slots. */
+    SlotFingerprint slotFingerprints[4] = {
+        { -1, 0, 0, 0, 0, true }, { -1, 0, 0, 0, 0, true },
+        { -1, 0, 0, 0, 0, true }, { -1, 0, 0, 0, 0, true }
+    };
+
+    /**
+     * @brief Forces all party slots to be checked on the next map frame.
+     * @details Used after the plugin itself changed equipment outside the
+     *          map scene, e.g. in menus or through comment commands.
+     */
+    void invalidateSlotFingerprints() {
+        for (int i = 0; i < 4; ++i) {
+            slotFingerprints[i].actorId = -1;
+            slotFingerprints[i].dirty = true;
+        }
+    }
+
+    /**
+     * @brief Marks the party slot of an actor for checking on the next map frame.
+     * @param actorId The actor whose slot is marked.
+     */
+    void markActorDirty(int actorId) {
+        for (int i = 0; i < 4; ++i) {
+            if (slotFingerprints[i].actorId == actorId) {
+                slotFingerprints[i].dirty = true;
             }
         }
-        return 0; // Not found
     }
 
     /**
@@ -50,7 +78,7 @@ namespace BareHanded
      */
     bool onStartup(char *pluginName) {
         // Load configuration from DynRPG.ini
-        std::map<std::string, std::string> configuration = RPG::loadConfiguration(pluginName);
+        std::map<std::string, std::string> configuration = IniCache::loadConfiguration(pluginName);
 
         // Configure debug console based on settings
         Debug::enableConsole = false;
@@ -60,6 +88,7 @@ namespace BareHanded
 
         // Initialize debug console if enabled
         if (Debug::enableConsole) {
+            Debug::loadOutputSettings(configuration);
             Debug::initConsole();
         }
 
@@ -70,9 +99,9 @@ namespace BareHanded
         if (BareHandedConfig::enableDebugConfig && Debug::enableConsole) {
             std::cout << "[BareHanded - Configuration]" << std::endl;
             std::cout << "BareHanded Plugin Initialized" << std::endl;
-            std::cout << "Configured actors with fixed weapon IDs: " << BareHandedConfig::actorWeaponMap.size() << std::endl;
-            std::cout << "Configured actors with variable-based weapon IDs: " << BareHandedConfig::actorVariableMap.size() << std::endl;
-            std::cout << "Total configured actors: " << (BareHandedConfig::actorWeaponMap.size() + BareHandedConfig::actorVariableMap.size()) << std::endl;
+            std::cout << "Configured actors with fixed weapon IDs: " << BareHandedConfig::fixedWeaponActorCount << std::endl;
+            std::cout << "Configured actors with variable-based weapon IDs: " << BareHandedConfig::variableWeaponActorCount << std::endl;
+            std::cout << "Total configured actors: " << (BareHandedConfig::fixedWeaponActorCount + BareHandedConfig::variableWeaponActorCount) << std::endl;
             std::cout << std::endl;
         }
 
@@ -98,8 +127,10 @@ namespace BareHanded
      *          - In map scenes: Equips configured weapons to unarmed actors
      *          - In menu/shop scenes: Removes bare hand weapons to allow equipment changes
      * @note Handles both fixed weapon IDs and variable-based weapon configurations.
-     * @see BareHandedConfig::actorWeaponMap
-     * @see BareHandedConfig::actorVariableMap
+     *       Variable-based weapons are only checked for party slots whose
+     *       fingerprint changed since the last map frame.
+     * @see BareHandedConfig::getFixedWeaponId
+     * @see BareHandedConfig::getWeaponVariableId
      */
     void onFrame(RPG::Scene scene) {
         // Process map scene - equip bare hand weapons
@@ -107,7 +138,7 @@ namespace BareHanded
             if (!weaponsEquipped) {
                 // Process each party member (max 4 in RPG Maker 2003)
                 for (int i = 0; i < 4; ++i) {
-                    RPG::Actor* actor = RPG::Actor::partyMember(i);
+                    RPG::Actor* actor = PartySnapshot::member(i);
 
                     // Check for empty weapon slots, considering dual-wielding
                     bool hasNoWeapons = (actor && actor->weaponId == 0);
@@ -120,56 +151,75 @@ namespace BareHanded
                     if (hasNoWeapons) {
                         // Process fixed weapon configuration
                         int actorId = actor->id;
-                        if (BareHandedConfig::actorWeaponMap.find(actorId) != BareHandedConfig::actorWeaponMap.end()) {
-                            int weaponId = BareHandedConfig::actorWeaponMap[actorId];
-                            if (weaponId > 0) {
-                                actor->weaponId = weaponId;
-
-                                // Log weapon equip if debug enabled
-                                if (BareHandedConfig::enableDebugRuntime && Debug::enableConsole) {
-                                    std::cout << "[BareHanded - Runtime Debug]" << std::endl;
-                                    std::cout << "Equipped actor " << actorId << " with fixed bare hand weapon ID " << weaponId << std::endl;
-                                    std::cout << std::endl;
-                                }
-                            }
+                        int weaponId = BareHandedConfig::getFixedWeaponId(actorId);
+                        if (weaponId > 0) {
+                            actor->weaponId = weaponId;
+
+                            // Log weapon equip if debug enabled
+                            ASYNC_LOGF(BareHandedConfig::enableDebugRuntime && Debug::enableConsole, "BareHanded - Runtime Debug",
+                                       "Equipped actor %d with fixed bare hand weapon ID %d", actorId, weaponId);
                         }
                     }
                 }
                 weaponsEquipped = true;
+                invalidateSlotFingerprints();
             }
 
-            // Process variable-based weapon configurations
+            // Process variable-based weapon configurations for changed party slots
             for (int i = 0; i < 4; ++i) {
-                RPG::Actor* actor = RPG::Actor::partyMember(i);
-                if (actor) {
-                    int actorId = actor->id;
+                RPG::Actor* actor = PartySnapshot::member(i);
+                SlotFingerprint& slot = slotFingerprints[i];
 
-                    // Check for variable-based weapon configuration
-                    if (BareHandedConfig::actorVariableMap.find(actorId) != BareHandedConfig::actorVariableMap.end()) {
-                        int variableId = BareHandedConfig::actorVariableMap[actorId];
-                        int weaponId = RPG::variables[variableId];
+                if (!actor) {
+                    slot.actorId = 0;
+                    continue;
+                }
 
-                        // Check for empty weapon slots and valid weapon ID
-                        bool hasNoWeapons = (actor->weaponId == 0);
+                int actorId = actor->id;
 
-                        // Check shield slot for dual-wielding actors
-                        if (hasNoWeapons && actor->twoWeapons && actor->shieldId > 0) {
-                            hasNoWeapons = false; // Actor has weapon in shield slot
-                        }
+                // Resolve the variable configuration only when the slot holds a new actor
+                if (slot.actorId != actorId) {
+                    slot.actorId = actorId;
+                    slot.variableId = BareHandedConfig::getWeaponVariableId(actorId);
+                    slot.dirty = true;
+                }
 
-                        if (hasNoWeapons && weaponId > 0) {
-                            actor->weaponId = weaponId;
+                // Check for variable-based weapon configuration
+                if (slot.variableId <= 0) {
+                    continue;
+                }
 
-                            // Log variable-based weapon equip if debug enabled
-                            if (BareHandedConfig::enableDebugRuntime && Debug::enableConsole) {
-                                std::cout << "[BareHanded - Runtime Debug]" << std::endl;
-                                std::cout << "Equipped actor " << actorId << " with variable-based weapon ID " << weaponId
-                                        << " from variable ID " << variableId << std::endl;
-                                std::cout << std::endl;
-                            }
-                        }
-                    }
+                int variableId = slot.variableId;
+                int weaponId = RPG::variables[variableId];
+
+                // Skip the slot if nothing changed since the last check
+                if (!slot.dirty && slot.weaponId == actor->weaponId && slot.shieldId == actor->shieldId
+                    && slot.variableValue == weaponId) {
+                    continue;
                 }
+
+                // Check for empty weapon slots and valid weapon ID
+                bool hasNoWeapons = (actor->weaponId == 0);
+
+                // Check shield slot for dual-wielding actors
+                if (hasNoWeapons && actor->twoWeapons && actor->shieldId > 0) {
+                    hasNoWeapons = false; // Actor has weapon in shield slot
+                }
+
+                if (hasNoWeapons && weaponId > 0) {
+                    actor->weaponId = weaponId;
+
+                    // Log variable-based weapon equip if debug enabled
+                    ASYNC_LOGF(BareHandedConfig::enableDebugRuntime && Debug::enableConsole, "BareHanded - Runtime Debug",
+                               "Equipped actor %d with variable-based weapon ID %d from variable ID %d",
+                               actorId, weaponId, variableId);
+                }
+
+                // Remember the state after the check
+                slot.weaponId = actor->weaponId;
+                slot.shieldId = actor->shieldId;
+                slot.variableValue = weaponId;
+                slot.dirty = false;
             }
         }
         // Process menu/shop scenes - remove bare hand weapons
@@ -177,45 +227,38 @@ namespace BareHanded
             if (weaponsEquipped) {
                 // Process each party member (max 4 in RPG Maker 2003)
                 for (int i = 0; i < 4; ++i) {
-                    RPG::Actor* actor = RPG::Actor::partyMember(i);
+                    RPG::Actor* actor = PartySnapshot::member(i);
                     if (actor) {
                         int actorId = actor->id;
 
                         // Process fixed weapon configuration
-                        if (BareHandedConfig::actorWeaponMap.find(actorId) != BareHandedConfig::actorWeaponMap.end()) {
-                            int weaponId = BareHandedConfig::actorWeaponMap[actorId];
-                            if (weaponId > 0 && actor->weaponId == weaponId) {
-                                actor->weaponId = 0;
+                        int fixedWeaponId = BareHandedConfig::getFixedWeaponId(actorId);
+                        if (fixedWeaponId > 0 && actor->weaponId == fixedWeaponId) {
+                            actor->weaponId = 0;
 
-                                // Log weapon unequip if debug enabled
-                                if (BareHandedConfig::enableDebugRuntime && Debug::enableConsole) {
-                                    std::cout << "[BareHanded - Runtime Debug]" << std::endl;
-                                    std::cout << "Unequipped fixed bare hand weapon ID " << weaponId << " from actor " << actorId << std::endl;
-                                    std::cout << std::endl;
-                                }
-                            }
+                            // Log weapon unequip if debug enabled
+                            ASYNC_LOGF(BareHandedConfig::enableDebugRuntime && Debug::enableConsole, "BareHanded - Runtime Debug",
+                                       "Unequipped fixed bare hand weapon ID %d from actor %d", fixedWeaponId, actorId);
                         }
 
                         // Process variable-based weapon configuration
-                        if (BareHandedConfig::actorVariableMap.find(actorId) != BareHandedConfig::actorVariableMap.end()) {
-                            int variableId = BareHandedConfig::actorVariableMap[actorId];
+                        int variableId = BareHandedConfig::getWeaponVariableId(actorId);
+                        if (variableId > 0) {
                             int weaponId = RPG::variables[variableId];
 
                             if (weaponId > 0 && actor->weaponId == weaponId) {
                                 actor->weaponId = 0;
 
                                 // Log variable-based weapon unequip if debug enabled
-                                if (BareHandedConfig::enableDebugRuntime && Debug::enableConsole) {
-                                    std::cout << "[BareHanded - Runtime Debug]" << std::endl;
-                                    std::cout << "Unequipped variable-based weapon ID " << weaponId
-                                            << " from variable ID " << variableId << " from actor " << actorId << std::endl;
-                                    std::cout << std::endl;
-                                }
+                                ASYNC_LOGF(BareHandedConfig::enableDebugRuntime && Debug::enableConsole, "BareHanded - Runtime Debug",
+                                           "Unequipped variable-based weapon ID %d from variable ID %d from actor %d",
+                                           weaponId, variableId, actorId);
                             }
                         }
                     }
                 }
                 weaponsEquipped = false;
+                invalidateSlotFingerprints();
             }
         }
     }
@@ -228,13 +271,25 @@ namespace BareHanded
      * @details Handles unequipping of variable-based bare hand weapons when their
      *          associated variable is set to 0 or negative, preventing invalid states.
      * @note Only processes variables that are mapped to actor weapon configurations.
-     * @see BareHandedConfig::actorVariableMap
+     *       Unrelated variables are rejected with one bitmap test. Every actor
+     *       sharing the variable is handled, and its party slot is marked for
+     *       checking on the next map frame.
+     * @see BareHandedConfig::buildVariableIndex
      */
     bool onSetVariable(int id, int value) {
-        // Check for actor using this variable
-        int actorId = findActorByVariableId(id);
+        // Reject variables not used by any actor
+        if (!BareHandedConfig::isWeaponVariable(id)) {
+            return true;
+        }
+
+        // Process each actor using this variable
+        int actorCount = 0;
+        const int* actorIds = BareHandedConfig::getVariableActors(id, actorCount);
+
+        for (int a = 0; a < actorCount; ++a) {
+            int actorId = actorIds[a];
+            markActorDirty(actorId);
 
-        if (actorId > 0) {
             // Unequip weapon if variable value is invalid
             if (value <= 0) {
                 // Find actor in party
@@ -248,13 +303,9 @@ namespace BareHanded
                             actor->weaponId = 0;
 
                             // Log weapon unequip if debug enabled
-                            if (BareHandedConfig::enableDebugRuntime && Debug::enableConsole) {
-                                std::cout << "[BareHanded - Runtime Debug]" << std::endl;
-                                std::cout << "Variable ID " << id << " set to " << value
-                                        << ". Unequipped variable-based weapon ID " << currentWeaponId
-                                        << " from variable ID " << id << " from actor " << actorId << std::endl;
-                                std::cout << std::endl;
-                            }
+                            ASYNC_LOGF(BareHandedConfig::enableDebugRuntime && Debug::enableConsole, "BareHanded - Runtime Debug",
+                                       "Variable ID %d set to %d. Unequipped variable-based weapon ID %d from variable ID %d from actor %d",
+                                       id, value, currentWeaponId, id, actorId);
                         }
                         break; // Actor found, exit loop
                     }
@@ -350,16 +401,14 @@ namespace BareHanded
                 bool isPrimaryBareHandWeapon = false;
 
                 // Check fixed weapon configuration
-                if (BareHandedConfig::actorWeaponMap.find(actorId) != BareHandedConfig::actorWeaponMap.end()) {
-                    int bareHandWeaponId = BareHandedConfig::actorWeaponMap[actorId];
-                    if (currentWeaponId == bareHandWeaponId) {
-                        isPrimaryBareHandWeapon = true;
-                    }
+                int bareHandWeaponId = BareHandedConfig::getFixedWeaponId(actorId);
+                if (bareHandWeaponId > 0 && currentWeaponId == bareHandWeaponId) {
+                    isPrimaryBareHandWeapon = true;
                 }
 
                 // Check variable-based weapon configuration
-                if (!isPrimaryBareHandWeapon && BareHandedConfig::actorVariableMap.find(actorId) != BareHandedConfig::actorVariableMap.end()) {
-                    int variableId = BareHandedConfig::actorVariableMap[actorId];
+                int variableId = BareHandedConfig::getWeaponVariableId(actorId);
+                if (!isPrimaryBareHandWeapon && variableId > 0) {
                     int variableWeaponId = RPG::variables[variableId];
 
                     if (variableWeaponId > 0 && currentWeaponId == variableWeaponId) {
@@ -395,16 +444,14 @@ namespace BareHanded
                 bool isSecondaryBareHandWeapon = false;
 
                 // Check fixed weapon configuration
-                if (BareHandedConfig::actorWeaponMap.find(actorId) != BareHandedConfig::actorWeaponMap.end()) {
-                    int bareHandWeaponId = BareHandedConfig::actorWeaponMap[actorId];
-                    if (currentShieldId == bareHandWeaponId) {
-                        isSecondaryBareHandWeapon = true;
-                    }
+                int bareHandWeaponId = BareHandedConfig::getFixedWeaponId(actorId);
+                if (bareHandWeaponId > 0 && currentShieldId == bareHandWeaponId) {
+                    isSecondaryBareHandWeapon = true;
                 }
 
                 // Check variable-based weapon configuration
-                if (!isSecondaryBareHandWeapon && BareHandedConfig::actorVariableMap.find(actorId) != BareHandedConfig::actorVariableMap.end()) {
-                    int variableId = BareHandedConfig::actorVariableMap[actorId];
+                int variableId = BareHandedConfig::getWeaponVariableId(actorId);
+                if (!isSecondaryBareHandWeapon && variableId > 0) {
                     int variableWeaponId = RPG::variables[variableId];
 
                     if (variableWeaponId > 0 && currentShieldId == variableWeaponId) {
@@ -434,6 +481,10 @@ namespace BareHanded
                 std::cout << std::endl;
             }
 
+            if (weaponUnequipped || shieldUnequipped) {
+                markActorDirty(actorId);
+            }
+
             return false;
         }
 
@@ -458,23 +509,21 @@ namespace BareHanded
                     int actorId = actor->id;
 
                     // Process fixed weapon configuration
-                    if (BareHandedConfig::actorWeaponMap.find(actorId) != BareHandedConfig::actorWeaponMap.end()) {
-                        int weaponId = BareHandedConfig::actorWeaponMap[actorId];
-                        if (weaponId > 0) {
-                            actor->weaponId = weaponId;
-
-                            // Log weapon equip if debug enabled
-                            if (BareHandedConfig::enableDebugRuntime && Debug::enableConsole) {
-                                std::cout << "[BareHanded - Runtime Debug]" << std::endl;
-                                std::cout << "Equipped actor " << actorId << " with fixed bare hand weapon ID " << weaponId << std::endl;
-                                std::cout << std::endl;
-                            }
+                    int fixedWeaponId = BareHandedConfig::getFixedWeaponId(actorId);
+                    if (fixedWeaponId > 0) {
+                        actor->weaponId = fixedWeaponId;
+
+                        // Log weapon equip if debug enabled
+                        if (BareHandedConfig::enableDebugRuntime && Debug::enableConsole) {
+                            std::cout << "[BareHanded - Runtime Debug]" << std::endl;
+                            std::cout << "Equipped actor " << actorId << " with fixed bare hand weapon ID " << fixedWeaponId << std::endl;
+                            std::cout << std::endl;
                         }
                     }
 
                     // Process variable-based weapon configuration
-                    if (BareHandedConfig::actorVariableMap.find(actorId) != BareHandedConfig::actorVariableMap.end()) {
-                        int variableId = BareHandedConfig::actorVariableMap[actorId];
+                    int variableId = BareHandedConfig::getWeaponVariableId(actorId);
+                    if (variableId > 0) {
                         int weaponId = RPG::variables[variableId];
 
                         // Check for empty weapon slot and valid weapon ID
@@ -493,6 +542,7 @@ namespace BareHanded
                 }
             }
             weaponsEquipped = true;
+            invalidateSlotFingerprints();
 
             return false;
         }
@@ -5,6 +5,8 @@
  *          and debug options.
  */
 
+#include "../common/ini_cache.cpp"
+
 /**
  * @namespace BareHandedConfig
  * @brief Contains configuration settings and loading functionality for the BareHanded plugin.
@@ -17,19 +19,209 @@ namespace BareHandedConfig
     /** @brief Flag to enable runtime debug output. */
     bool enableDebugRuntime = false;
     
+    /** @brief Actor flag: the actor has a valid fixed bare hand weapon. */
+    const unsigned char ACTOR_FIXED_WEAPON = 0x01;
+
+    /** @brief Actor flag: the actor has a valid weapon variable. */
+    const unsigned char ACTOR_VARIABLE_WEAPON = 0x02;
+
+    /** @brief Actor flag used while parsing: an UnarmedWeaponId key was found. */
+    const unsigned char ACTOR_WEAPON_KEY = 0x04;
+
+    /** @brief Actor flag used while parsing: a VariableId key was found. */
+    const unsigned char ACTOR_VARIABLE_KEY = 0x08;
+
+    /** @brief Highest actor ID covered by the actor tables. */
+    int maxActorId = 0;
+
     /**
-     * @brief Maps actor IDs to fixed bare hand weapon IDs.
-     * @details Positive values indicate weapon IDs to equip when the actor is unarmed.
+     * @brief Highest accepted MaxActorId and Actor<N>_VariableId.
+     * @details The actor tables and the variable reverse index are sized from
+     *          these values, so a mistyped ID must not allocate huge tables.
+     *          Matches the database limit of RPG Maker 2003.
      */
-    std::map<int, int> actorWeaponMap;
-    
+    const int MAX_CONFIG_ID = 5000;
+
+    /**
+     * @brief Fixed bare hand weapon IDs, indexed by actor ID.
+     * @details Only valid if ACTOR_FIXED_WEAPON is set for the actor.
+     */
+    std::vector<int> actorWeaponIds;
+
     /**
-     * @brief Maps actor IDs to variable IDs containing weapon IDs.
-     * @details Variables contain weapon IDs to equip when the actor is unarmed.
+     * @brief Variable IDs containing weapon IDs, indexed by actor ID.
+     * @details Only valid if ACTOR_VARIABLE_WEAPON is set for the actor.
      *          Variable values must be positive to be considered valid.
      */
-    std::map<int, int> actorVariableMap;
-    
+    std::vector<int> actorVariableIds;
+
+    /** @brief ACTOR_* flags, indexed by actor ID. */
+    std::vector<unsigned char> actorFlags;
+
+    /** @brief Number of actors with a fixed bare hand weapon. */
+    int fixedWeaponActorCount = 0;
+
+    /** @brief Number of actors with a weapon variable. */
+    int variableWeaponActorCount = 0;
+
+    /**
+     * @brief Gets the fixed bare hand weapon ID of an actor.
+     * @param actorId The actor ID.
+     * @return The weapon ID, 0 if the actor has none.
+     */
+    inline int getFixedWeaponId(int actorId) {
+        if (actorId <= 0 || actorId > maxActorId || !(actorFlags[actorId] & ACTOR_FIXED_WEAPON)) {
+            return 0;
+        }
+        return actorWeaponIds[actorId];
+    }
+
+    /**
+     * @brief Gets the weapon variable ID of an actor.
+     * @param actorId The actor ID.
+     * @return The variable ID, 0 if the actor has none.
+     */
+    inline int getWeaponVariableId(int actorId) {
+        if (actorId <= 0 || actorId > maxActorId || !(actorFlags[actorId] & ACTOR_VARIABLE_WEAPON)) {
+            return 0;
+        }
+        return actorVariableIds[actorId];
+    }
+
+    /**
+     * @brief Bitmap of variable IDs used as weapon variables.
+     * @details Bit (id % 32) of word (id / 32) is set if any actor uses variable id.
+     *          Lets unrelated variable writes be rejected with a single bit test.
+     */
+    std::vector<uint32_t> weaponVariableBits;
+
+    /**
+     * @brief Start offsets into variableActors, indexed by variable ID.
+     * @details The actors using variable id are
+     *          variableActors[variableActorOffsets[id]] to variableActors[variableActorOffsets[id + 1] - 1].
+     */
+    std::vector<int> variableActorOffsets;
+
+    /** @brief Actor IDs grouped by their weapon variable ID. */
+    std::vector<int> variableActors;
+
+    /**
+     * @brief Checks whether a variable is used as a weapon variable.
+     * @param variableId The variable ID to check.
+     * @return True if at least one actor uses the variable.
+     */
+    inline bool isWeaponVariable(int variableId) {
+        if (variableId <= 0 || static_cast<size_t>(variableId / 32) >= weaponVariableBits.size()) {
+            return false;
+        }
+        return (weaponVariableBits[variableId / 32] >> (variableId % 32)) & 1;
+    }
+
+    /**
+     * @brief Gets the actors that use a weapon variable.
+     * @param variableId The variable ID, must pass isWeaponVariable.
+     * @param count Receives the number of actors.
+     * @return Pointer to the first actor ID.
+     */
+    inline const int* getVariableActors(int variableId, int& count) {
+        int offset = variableActorOffsets[variableId];
+        count = variableActorOffsets[variableId + 1] - offset;
+        return &variableActors[offset];
+    }
+
+    /**
+     * @brief Builds the variable ID to actor reverse index from the actor tables.
+     * @details Counts the actors per variable, turns the counts into offsets and
+     *          then fills the actor list, so several actors can share one variable.
+     */
+    void buildVariableIndex() {
+        weaponVariableBits.clear();
+        variableActorOffsets.clear();
+        variableActors.clear();
+
+        if (variableWeaponActorCount == 0) {
+            return;
+        }
+
+        int maxVariableId = 0;
+        for (int actorId = 1; actorId <= maxActorId; ++actorId) {
+            if (actorFlags[actorId] & ACTOR_VARIABLE_WEAPON) {
+                maxVariableId = std::max(maxVariableId, actorVariableIds[actorId]);
+            }
+        }
+
+        weaponVariableBits.assign(maxVariableId / 32 + 1, 0);
+        variableActorOffsets.assign(maxVariableId + 2, 0);
+        variableActors.resize(variableWeaponActorCount);
+
+        // Count actors per variable
+        for (int actorId = 1; actorId <= maxActorId; ++actorId) {
+            if (actorFlags[actorId] & ACTOR_VARIABLE_WEAPON) {
+                int variableId = actorVariableIds[actorId];
+                variableActorOffsets[variableId + 1]++;
+                weaponVariableBits[variableId / 32] |= (1u << (variableId % 32));
+            }
+        }
+
+        // Turn counts into start offsets
+        for (int id = 1; id <= maxVariableId + 1; ++id) {
+            variableActorOffsets[id] += variableActorOffsets[id - 1];
+        }
+
+        // Fill actor lists, keeping actors in ascending ID order
+        std::vector<int> fillPos(variableActorOffsets.begin(), variableActorOffsets.end() - 1);
+        for (int actorId = 1; actorId <= maxActorId; ++actorId) {
+            if (actorFlags[actorId] & ACTOR_VARIABLE_WEAPON) {
+                variableActors[fillPos[actorVariableIds[actorId]]++] = actorId;
+            }
+        }
+    }
+
+    /**
+     * @brief Parses an integer setting the same way std::stoi is used elsewhere.
+     * @param text The setting value.
+     * @return The parsed value, 0 if the value does not start with a number
+     *         or does not fit in an int.
+     */
+    inline int parseInt(const std::string& text) {
+        errno = 0;
+        long value = strtol(text.c_str(), nullptr, 10);
+        if (errno == ERANGE || value > INT_MAX || value < INT_MIN) {
+            return 0;
+        }
+        return static_cast<int>(value);
+    }
+
+    /**
+     * @brief Parses an actor key of the form Actor<N>_<Setting>.
+     * @param key The configuration key.
+     * @param actorId Receives N.
+     * @return The part after the underscore, or nullptr if the key is not an actor key.
+     * @details Works on the key characters directly, so no key strings are built.
+     */
+    const char* parseActorKey(const std::string& key, int& actorId) {
+        const char* text = key.c_str();
+        if (strncmp(text, "Actor", 5) != 0) {
+            return nullptr;
+        }
+
+        text += 5;
+        if (*text < '0' || *text > '9') {
+            return nullptr;
+        }
+
+        actorId = 0;
+        while (*text >= '0' && *text <= '9') {
+            actorId = actorId * 10 + (*text - '0');
+            if (actorId > 1000000) {
+                return nullptr; // Far beyond any valid actor ID
+            }
+            ++text;
+        }
+
+        return (*text == '_') ? text + 1 : nullptr;
+    }
+
     /**
      * @brief Loads and validates configuration settings from DynRPG.ini.
      * @param pluginName Name of the plugin section in DynRPG.ini.
@@ -37,18 +229,15 @@ namespace BareHandedConfig
      * @details This function:
      *          - Clears existing configuration
      *          - Loads debug settings
-     *          - Loads actor-to-weapon mappings
+     *          - Loads actor-to-weapon mappings in one pass over the settings
      *          - Validates weapon and variable IDs
+     *          - Builds the variable reverse index
      * @note Both fixed weapon IDs and variable IDs must be positive values
      *       to be considered valid configurations.
      */
     bool LoadConfig(char *pluginName) {
-        // Reset configuration state
-        actorWeaponMap.clear();
-        actorVariableMap.clear();
-        
         // Load plugin configuration
-        std::map<std::string, std::string> config = RPG::loadConfiguration(pluginName);
+        std::map<std::string, std::string> config = IniCache::loadConfiguration(pluginName);
         
         // Parse debug settings
         enableDebugConfig = false;
@@ -63,7 +252,7 @@ namespace BareHandedConfig
         }
         
         // Parse maximum actor ID to check
-        int maxActorId = 20; // Default value
+        maxActorId = 20; // Default value
         if (config.find("MaxActorId") != config.end()) {
             try {
                 maxActorId = std::stoi(config["MaxActorId"]);
@@ -71,31 +260,59 @@ namespace BareHandedConfig
                 // Skip invalid actor ID configuration
             }
         }
+        maxActorId = std::max(0, maxActorId);
+        if (maxActorId > MAX_CONFIG_ID) {
+            if (enableDebugConfig && Debug::enableConsole) {
+                std::cout << "[BareHanded - Configuration Conflict]" << std::endl;
+                std::cout << "MaxActorId=" << maxActorId << " exceeds " << MAX_CONFIG_ID
+                         << ", using " << MAX_CONFIG_ID << std::endl;
+                std::cout << std::endl;
+            }
+            maxActorId = MAX_CONFIG_ID;
+        }
         
         if (enableDebugConfig && Debug::enableConsole) {
             std::cout << "[BareHanded - Configuration]" << std::endl;
             std::cout << "Loading configuration with MaxActorId=" << maxActorId << std::endl;
             std::cout << std::endl;
         }
+
+        // Reset configuration state
+        actorWeaponIds.assign(maxActorId + 1, 0);
+        actorVariableIds.assign(maxActorId + 1, 0);
+        actorFlags.assign(maxActorId + 1, 0);
+        fixedWeaponActorCount = 0;
+        variableWeaponActorCount = 0;
+
+        // Collect actor settings in one pass over the configuration
+        for (auto const& entry : config) {
+            int actorId = 0;
+            const char* setting = parseActorKey(entry.first, actorId);
+            if (!setting || actorId < 1 || actorId > maxActorId) {
+                continue;
+            }
+
+            if (strcmp(setting, "UnarmedWeaponId") == 0) {
+                actorWeaponIds[actorId] = parseInt(entry.second);
+                actorFlags[actorId] |= ACTOR_WEAPON_KEY;
+            } else if (strcmp(setting, "VariableId") == 0) {
+                actorVariableIds[actorId] = parseInt(entry.second);
+                actorFlags[actorId] |= ACTOR_VARIABLE_KEY;
+            }
+        }
         
-        // Process actor configurations
+        // Validate actor configurations in actor order
         for (int actorId = 1; actorId <= maxActorId; ++actorId) {
-            std::stringstream keyPrefix;
-            keyPrefix << "Actor" << actorId;
-            
+            unsigned char& flags = actorFlags[actorId];
+
             // Process fixed weapon ID configuration
-            std::string weaponKey = keyPrefix.str() + "_UnarmedWeaponId";
-            if (config.find(weaponKey) != config.end()) {
-                int weaponId = 0;
-                try {
-                    weaponId = std::stoi(config[weaponKey]);
-                } catch (...) {
-                    // Skip invalid weapon ID configuration
-                }
+            if (flags & ACTOR_WEAPON_KEY) {
+                int weaponId = actorWeaponIds[actorId];
                 
                 // Store valid weapon IDs
                 if (weaponId > 0) {
-                    actorWeaponMap[actorId] = weaponId;
+                    flags |= ACTOR_FIXED_WEAPON;
+                    fixedWeaponActorCount++;
                     
                     if (enableDebugConfig && Debug::enableConsole) {
                         std::cout << "[BareHanded - Configuration]" << std::endl;
@@ -113,19 +330,13 @@ namespace BareHandedConfig
             }
             
             // Process variable-based weapon ID configuration
-            std::string varKey = keyPrefix.str() + "_VariableId";
-            bool hasVarKey = (config.find(varKey) != config.end());
-            if (hasVarKey) {
-                int variableId = 0;
-                try {
-                    variableId = std::stoi(config[varKey]);
-                } catch (...) {
-                    // Skip invalid variable ID configuration
-                }
+            if (flags & ACTOR_VARIABLE_KEY) {
+                int variableId = actorVariableIds[actorId];
                 
                 // Store valid variable IDs
-                if (variableId > 0) {
-                    actorVariableMap[actorId] = variableId;
+                if (variableId > 0 && variableId <= MAX_CONFIG_ID) {
+                    flags |= ACTOR_VARIABLE_WEAPON;
+                    variableWeaponActorCount++;
                     
                     if (enableDebugConfig && Debug::enableConsole) {
                         std::cout << "[BareHanded - Configuration]" << std::endl;
@@ -138,11 +349,16 @@ namespace BareHandedConfig
                     // Log invalid variable ID configuration
                     std::cout << "[BareHanded - Configuration Conflict]" << std::endl;
                     std::cout << "Conflict detected: Skipping Actor " << actorId << " variable-based weapon ID: "
-                             << "Invalid VariableId=" << variableId << " (must be > 0)" << std::endl;
+                             << "Invalid VariableId=" << variableId << " (must be 1-" << MAX_CONFIG_ID << ")" << std::endl;
                     std::cout << std::endl;
                 }
             }
+
+            // Parse-only flags are no longer needed
+            flags &= (ACTOR_FIXED_WEAPON | ACTOR_VARIABLE_WEAPON);
         }
+
+        buildVariableIndex();
         
         return true;
     }
@@ -10,19 +10,28 @@
 #include <DynRPG/DynRPG.h>
 
 // Standard library headers
+#include <algorithm>  // For std::max
 #include <fstream>    // For file operations
 #include <map>        // For storing configurations and state data
 #include <sstream>    // For string formatting
 #include <string>     // For text processing
+#include <vector>     // For the variable reverse index
 #include <iostream>   // For console output
+#include <errno.h>    // For strtol range errors
+#include <limits.h>   // For INT_MAX, INT_MIN
 #include <stdio.h>    // For freopen
-#include <stdlib.h>   // For atoi
+#include <stdlib.h>   // For atoi, strtol
+#include <string.h>   // For strcmp, strncmp
 #include <stdint.h>   // For standard integer types
 #include <windows.h>  // For Windows API
 
 // Main implementation file - contains all namespaced code
 #include "bare_handed.cpp"
 
+// Opt-in callback profiler and trace recorder
+#include "../common/profiler.cpp"
+#include "../common/trace_recorder.cpp"
+
 /**
  * @defgroup callbacks DynRPG Plugin Callbacks
  * @brief Global callback functions called by the DynRPG system
@@ -37,6 +46,8 @@
  * @see BareHanded::onStartup
  */
 bool onStartup(char *pluginName) {
+    Profiler::start(pluginName);
+    TraceRecorder::start(pluginName);
     return BareHanded::onStartup(pluginName);
 }
 
@@ -47,6 +58,8 @@ bool onStartup(char *pluginName) {
  */
 void onExit() {
     BareHanded::onExit();
+    Profiler::stop();
+    TraceRecorder::stop();
 }
 
 /**
@@ -57,6 +70,8 @@ void onExit() {
  * @see BareHanded::onFrame
  */
 void onFrame(RPG::Scene scene) {
+    TraceRecorder::Call trace(TraceRecorder::TR_FRAME, scene);
+    Profiler::Scope scope(Profiler::PC_ON_FRAME);
     BareHanded::onFrame(scene);
 }
 
@@ -70,7 +85,9 @@ void onFrame(RPG::Scene scene) {
  * @see BareHanded::onSetVariable
  */
 bool onSetVariable(int id, int value) {
-    return BareHanded::onSetVariable(id, value);
+    TraceRecorder::Call trace(TraceRecorder::TR_SET_VARIABLE, id, value);
+    Profiler::Scope scope(Profiler::PC_ON_SET_VARIABLE);
+    return trace.result(BareHanded::onSetVariable(id, value));
 }
 
 /**
@@ -90,7 +107,18 @@ bool onSetVariable(int id, int value) {
 bool onComment(const char *text, const RPG::ParsedCommentData *parsedData, 
               RPG::EventScriptLine *nextScriptLine, RPG::EventScriptData *scriptData, 
               int eventId, int pageId, int lineId, int *nextLineId) {
-    return BareHanded::onComment(text, parsedData, nextScriptLine, scriptData, eventId, pageId, lineId, nextLineId);
+    TraceRecorder::Call trace(parsedData);
+    Profiler::Scope scope(Profiler::PC_ON_COMMENT);
+    return trace.result(BareHanded::onComment(text, parsedData, nextScriptLine, scriptData, eventId, pageId, lineId, nextLineId));
+}
+
+/**
+ * @brief Called after the screen was drawn.
+ * @note Draws the profiler overlay while it is enabled and its switch is ON.
+ * @see Profiler::drawOverlay
+ */
+void onDrawScreen() {
+    Profiler::drawOverlay();
 }
 
 /** @} */ // end of callbacks group
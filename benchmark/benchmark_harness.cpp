@@ -0,0 +1,74 @@
+/**
+ * @file benchmark_harness.cpp
+ * @brief Timing and allocation counting for the host benchmark.
+ * @details Replaces the global allocation operators with counting versions and
+ *          runs workloads with QueryPerformanceCounter, reporting ns/op and
+ *          allocations/op for each one.
+ */
+
+#include <new>        // For std::bad_alloc
+
+/**
+ * @namespace Bench
+ * @brief Minimal micro-benchmark runner.
+ */
+namespace Bench
+{
+    /** @brief Number of heap allocations since program start. */
+    static unsigned long long allocations = 0;
+
+    /** @brief Calls run before timing starts, to fill caches and lazy state. */
+    const int BENCH_WARMUP_OPS = 64;
+
+    /** @brief Counts one allocation and forwards to malloc. */
+    inline void* allocate(size_t size) {
+        ++allocations;
+        void* memory = malloc(size ? size : 1);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    /**
+     * @brief Runs and reports one workload.
+     * @param name Workload name printed in the report.
+     * @param ops Number of timed operations.
+     * @param body Callable invoked as body(i) for each operation.
+     */
+    template<class Body>
+    void run(const char* name, int ops, Body body) {
+        for (int i = 0; i < BENCH_WARMUP_OPS; ++i) {
+            body(i);
+        }
+
+        LARGE_INTEGER frequency, start, end;
+        QueryPerformanceFrequency(&frequency);
+        unsigned long long startAllocations = allocations;
+        QueryPerformanceCounter(&start);
+        for (int i = 0; i < ops; ++i) {
+            body(i);
+        }
+        QueryPerformanceCounter(&end);
+        unsigned long long opAllocations = allocations - startAllocations;
+
+        double ns = (end.QuadPart - start.QuadPart) * 1000000000.0 / frequency.QuadPart;
+        printf("%-36s %10d ops %12.1f ns/op %10.2f allocs/op\n",
+               name, ops, ns / ops, static_cast<double>(opAllocations) / ops);
+        fflush(stdout);
+    }
+
+    /**
+     * @brief Prints a skipped workload.
+     * @param name Workload name.
+     * @param reason Why the workload could not run.
+     */
+    void skip(const char* name, const char* reason) {
+        printf("%-36s skipped: %s\n", name, reason);
+    }
+} // namespace Bench
+
+void* operator new(size_t size) { return Bench::allocate(size); }
+void* operator new[](size_t size) { return Bench::allocate(size); }
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
@@ -0,0 +1,321 @@
+/**
+ * @file benchmark_workloads.cpp
+ * @brief Synthetic workloads that drive the real plugin namespaces.
+ * @details The plugins are compiled as suite modules, so every workload calls
+ *          the same code the DLLs run inside RPG_RT.exe, against the mocked
+ *          game state set up here.
+ */
+
+/**
+ * @namespace Workloads
+ * @brief Game state setup and the benchmark workloads.
+ */
+namespace Workloads
+{
+    /** @brief Start of the scratch region that stands in for RPG_RT.exe code. */
+    const unsigned int WL_SCRATCH_ADDRESS = 0xE00000;
+
+    /** @brief Size of the scratch region. */
+    const unsigned int WL_SCRATCH_SIZE = 0x10000;
+
+    /** @brief Start of the watched values in the scratch region. */
+    const unsigned int WL_WATCH_ADDRESS = WL_SCRATCH_ADDRESS + 0x2000;
+
+    /** @brief Byte written by both overlapping patches QuickPatch5 and QuickPatch6. */
+    const unsigned int WL_OVERLAP_ADDRESS = WL_SCRATCH_ADDRESS + 0x201;
+
+    /** @brief Number of QuickWatch entries in the benchmark DynRPG.ini. */
+    const int WL_WATCH_COUNT = 8;
+
+    /** @brief Frames per simulated battle. */
+    const int WL_BATTLE_FRAMES = 1000;
+
+    /** @brief Frames between two battler actions in a simulated battle. */
+    const int WL_ACTION_INTERVAL = 20;
+
+    /** @brief Hits checked per battler action in lb_check_damage_and_apply_gain. */
+    const int WL_HITS_PER_ACTION = 4;
+
+    /** @brief Number of skills in the mocked database. */
+    const int WL_SKILL_COUNT = 200;
+
+    /** @brief Mocked party, monsters and skills. */
+    static RPG::Actor actors[4];
+    static RPG::Monster monsterParty[4];
+    static RPG::Action actions[8];
+    static RPG::Skill skillTable[WL_SKILL_COUNT];
+    static int battleCommands[4][7];
+    static RPG::Window commandWindow;
+    static RPG::Window partyWindow;
+    static RPG::BattleData battleData;
+    static RPG::BattleSettings battleSettings;
+
+    /** @brief Tracks whether the scratch region for patch writes is mapped. */
+    static bool scratchMapped = false;
+
+    /** @brief Load game replays that left the wrong bytes in overlapping patches. */
+    static int overlapMismatches = 0;
+
+    /**
+     * @brief Creates an empty file so the plugins' file checks succeed.
+     * @param path The file to create.
+     */
+    void touchFile(const char* path) {
+        FILE* file = fopen(path, "ab");
+        if (file) {
+            fclose(file);
+        }
+    }
+
+    /**
+     * @brief Sets up the party, monsters, database and screen.
+     */
+    void setupGameState() {
+        for (int i = 0; i < WL_SKILL_COUNT; ++i) {
+            skillTable[i].target = RPG::SKILL_TARGET_ENEMY;
+            RPG::skills.items.push_back(&skillTable[i]);
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            RPG::Actor& actor = actors[i];
+            memset(&actor, 0, sizeof(actor));
+            actor.id = i + 1;
+            actor.hp = actor.maxHp = 500;
+            actor.action = &actions[i];
+            actor.battleCommands = battleCommands[i];
+            battleCommands[i][0] = 1;
+            battleCommands[i][1] = 14;
+            battleCommands[i][2] = 15;
+            Mock::party[i] = &actor;
+
+            RPG::Monster& monster = monsterParty[i];
+            memset(&monster, 0, sizeof(monster));
+            monster.id = i + 1;
+            monster.hp = monster.maxHp = 2000;
+            monster.monster = true;
+            monster.action = &actions[4 + i];
+            RPG::monsters.items.push_back(&monster);
+        }
+
+        static RPG::BattleCommand commands[100];
+        for (int i = 0; i < 100; ++i) {
+            battleSettings.battleCommands[i] = &commands[i];
+        }
+        battleData.winCommand = &commandWindow;
+        battleData.winParty = &partyWindow;
+        battleData.currentHero = &actors[0];
+        RPG::battleData = &battleData;
+        RPG::battleSettings = &battleSettings;
+
+        Mock::canvas.surface = RPG::Image::create(320, 240);
+        Mock::screen.canvas = &Mock::canvas;
+        RPG::screen = &Mock::screen;
+
+        CreateDirectoryA("DynRessource", NULL);
+        CreateDirectoryA("DynRessource\\limit_break", NULL);
+        const char* layers[3][3] = {
+            { "DynRessource\\limit_break\\background.png", "128", "80" },
+            { "DynRessource\\limit_break\\bar.png", "120", "120" },
+            { "DynRessource\\limit_break\\foreground.png", "128", "20" }
+        };
+        for (int i = 0; i < 3; ++i) {
+            touchFile(layers[i][0]);
+            Mock::imageSizes[layers[i][0]] = std::make_pair(atoi(layers[i][1]), atoi(layers[i][2]));
+        }
+
+        // Patch addresses are limited to 24 bits, so map a writable region
+        // there in place of the game executable's code
+        scratchMapped = VirtualAlloc(reinterpret_cast<LPVOID>(WL_SCRATCH_ADDRESS), WL_SCRATCH_SIZE,
+                                     MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE) != NULL;
+    }
+
+    /**
+     * @brief Sets up the game state and starts the suite modules.
+     * @return False if a module failed to start or is not configured.
+     */
+    bool start() {
+        setupGameState();
+        char name[] = "suite";
+        const int allModules = Suite::MODULE_BARE_HANDED | Suite::MODULE_DIRECT_SKILLS
+                             | Suite::MODULE_DYNAMIC_QUICKPATCH | Suite::MODULE_LIMIT_BREAK;
+        return Suite::onStartup(name) && Suite::enabledModules == allModules;
+    }
+
+    /**
+     * @brief Simulates one frame of a battle for Limit Break.
+     * @param frame Frame number within the battle.
+     * @details Every WL_ACTION_INTERVAL frames an actor or monster acts and
+     *          deals damage; the actor heals the party on every fourth action.
+     */
+    void battleFrame(int frame) {
+        namespace LB = LimitBreakModule::LimitBreak;
+        if (frame == 0) {
+            for (int i = 0; i < 4; ++i) {
+                RPG::variables[10 + i] = 0;
+                actors[i].hp = actors[i].maxHp;
+                monsterParty[i].hp = monsterParty[i].maxHp;
+            }
+        }
+
+        if (frame % WL_ACTION_INTERVAL == 0) {
+            int turn = frame / WL_ACTION_INTERVAL;
+            RPG::Battler* battler = (turn & 1) ? static_cast<RPG::Battler*>(&monsterParty[turn % 4])
+                                               : static_cast<RPG::Battler*>(&actors[turn % 4]);
+            LB::onDoBattlerAction(battler, true);
+            if (!battler->isMonster()) {
+                if (turn % 4 == 3) {
+                    actors[0].hp = std::min(actors[0].maxHp, actors[0].hp + 40);
+                } else {
+                    RPG::Monster& target = monsterParty[turn % 4];
+                    target.hp = (target.hp > 25) ? target.hp - 25 : target.maxHp;
+                }
+            } else {
+                RPG::Actor& target = actors[turn % 4];
+                target.hp = (target.hp > 50) ? target.hp - 30 : target.maxHp;
+            }
+            LB::onBattlerActionDone(battler, true);
+        }
+
+        LB::onFrame(RPG::SCENE_BATTLE);
+        if (frame == WL_BATTLE_FRAMES - 1) {
+            LB::onFrame(RPG::SCENE_MAP);
+        }
+    }
+
+    /**
+     * @brief Runs all workloads and prints the report.
+     * @return False if a workload's result check failed.
+     */
+    bool runAll() {
+        namespace DQP = DynamicQuickPatchModule::DynamicQuickPatch;
+
+        Bench::run("dqp_set_variable_unpatched", 1000000, [](int i) {
+            DQP::onSetVariable(200 + (i % 800), i);
+        });
+
+        if (scratchMapped) {
+            Bench::run("dqp_set_variable_storm", 200000, [](int i) {
+                DQP::onSetVariable(101 + (i % 4), (i / 4) % 3);
+            });
+        } else {
+            Bench::skip("dqp_set_variable_storm", "scratch region at 0xE00000 is not available");
+        }
+
+        if (scratchMapped) {
+            Bench::run("dqp_watch_sweep", 1000000, [](int i) {
+                if ((i & 15) == 0) {
+                    int* watched = reinterpret_cast<int*>(WL_WATCH_ADDRESS);
+                    watched[(i >> 4) % WL_WATCH_COUNT] = i;
+                }
+                DQP::onFrame(RPG::SCENE_BATTLE);
+            });
+        } else {
+            Bench::skip("dqp_watch_sweep", "scratch region at 0xE00000 is not available");
+        }
+
+        // QuickPatch5 is set before QuickPatch6 and both are configured in
+        // that order, so after the replay the shared byte must hold QuickPatch6
+        if (scratchMapped) {
+            Bench::run("dqp_load_game_overlap", 100000, [](int i) {
+                int first = 0x11111111 * (1 + i % 8);
+                int second = i % 100;
+                RPG::variables[105] = first;
+                DQP::onSetVariable(105, first);
+                RPG::variables[106] = second;
+                DQP::onSetVariable(106, second);
+                DQP::onLoadGame(0, nullptr, 0);
+                DQP::onFrame(RPG::SCENE_MAP);
+                if (*reinterpret_cast<unsigned char*>(WL_OVERLAP_ADDRESS) != static_cast<unsigned char>(second)) {
+                    overlapMismatches++;
+                }
+            });
+            if (overlapMismatches > 0) {
+                printf("dqp_load_game_overlap: %d replays left QuickPatch5's byte at 0x%X\n",
+                       overlapMismatches, WL_OVERLAP_ADDRESS);
+            }
+        } else {
+            Bench::skip("dqp_load_game_overlap", "scratch region at 0xE00000 is not available");
+        }
+
+        Bench::run("lb_battle_frame", WL_BATTLE_FRAMES * 50, [](int i) {
+            battleFrame(i % WL_BATTLE_FRAMES);
+        });
+
+        // Alternates actor and monster actions of WL_HITS_PER_ACTION hits each,
+        // so both the damage dealt and the damage taken gain rules run; the
+        // party uses the Stoic, Warrior, Comrade and Knight modes (mode
+        // variables 21-24 in DynRPG.ini)
+        const int partyModes[4] = { 0, 1, 2, 4 };
+        for (int slot = 0; slot < 4; ++slot) {
+            RPG::variables[21 + slot] = partyModes[slot];
+        }
+        LimitBreakModule::LimitBreak::onFrame(RPG::SCENE_BATTLE);
+        Bench::run("lb_check_damage_and_apply_gain", 200000, [](int i) {
+            namespace LB = LimitBreakModule::LimitBreak;
+            int turn = i / WL_HITS_PER_ACTION;
+            bool monsterTurn = (turn & 1) != 0;
+            if (i % WL_HITS_PER_ACTION == 0) {
+                if (turn % 8 == 0) {
+                    // Keep the gauges below 100% so gains are not clamped away
+                    for (int v = 10; v < 14; ++v) {
+                        RPG::variables[v] = 0;
+                    }
+                }
+                // Every actor acts in turn, so each limit mode gets its gain rules run
+                int slot = (turn / 2) % 4;
+                RPG::Battler* battler = monsterTurn ? static_cast<RPG::Battler*>(&monsterParty[slot])
+                                                    : static_cast<RPG::Battler*>(&actors[slot]);
+                LB::onDoBattlerAction(battler, true);
+                LB::onBattlerActionDone(battler, true);
+            }
+
+            if (monsterTurn) {
+                RPG::Actor& target = actors[i % 4];
+                target.hp = (target.hp > 50) ? target.hp - 30 : target.maxHp;
+            } else {
+                // Hits large enough for the Warrior's damage dealt gain to round above 0
+                RPG::Monster& target = monsterParty[i % 4];
+                target.hp = (target.hp > 250) ? target.hp - 250 : target.maxHp;
+            }
+            LimitBreakModule::LimitBreakCalculate::checkDamageAndApplyGain();
+        });
+        LimitBreakModule::LimitBreak::onFrame(RPG::SCENE_MAP);
+        for (int slot = 0; slot < 4; ++slot) {
+            RPG::variables[21 + slot] = 0;
+        }
+
+        LimitBreakModule::LimitBreak::onFrame(RPG::SCENE_BATTLE);
+        Bench::run("lb_gauge_draw_every_fill", 101 * 1000, [](int i) {
+            RPG::variables[LimitBreakModule::LimitBreakConfig::ultimateLimitVarId] = i % 101;
+            LimitBreakModule::LimitBreakGraphics::drawUltimateLimitBar();
+        });
+
+        Bench::run("lb_gauge_draw_steady_fill", 100000, [](int i) {
+            (void)i;
+            RPG::variables[LimitBreakModule::LimitBreakConfig::ultimateLimitVarId] = 50;
+            LimitBreakModule::LimitBreakGraphics::drawUltimateLimitBar();
+        });
+        LimitBreakModule::LimitBreak::onFrame(RPG::SCENE_MAP);
+
+        Bench::run("bare_handed_map_frame", 1000000, [](int i) {
+            (void)i;
+            BareHandedModule::BareHanded::onFrame(RPG::SCENE_MAP);
+        });
+
+        Bench::run("direct_skills_battle_frame", 1000000, [](int i) {
+            commandWindow.selected = (i >> 6) % 3;
+            DirectSkillsModule::DirectSkills::onFrame(RPG::SCENE_BATTLE);
+        });
+
+        Bench::run("suite_map_frame", 1000000, [](int i) {
+            (void)i;
+            Suite::onFrame(RPG::SCENE_MAP);
+        });
+
+        Bench::run("suite_set_variable_unsubscribed", 1000000, [](int i) {
+            Suite::onSetVariable(500 + (i % 400), i);
+        });
+
+        return overlapMismatches == 0;
+    }
+} // namespace Workloads
@@ -0,0 +1,61 @@
+/**
+ * @file main.cpp
+ * @brief Entry point for the host-side plugin benchmark.
+ * @details Builds all plugins against the mocked DynRPG header in mock/ and
+ *          runs synthetic workloads through their real namespaces. Run it from
+ *          the benchmark folder so the plugins read benchmark/DynRPG.ini.
+ *          With --replay <file>, replays a callback trace recorded in the game
+ *          instead; run it next to that game's DynRPG.ini.
+ */
+
+// Mocked DynRPG header (mock/ is on the include path)
+#include <DynRPG/DynRPG.h>
+
+// Standard library headers
+#include <algorithm>  // For std::min, std::max
+#include <fstream>    // For file operations
+#include <limits>     // For numeric limits
+#include <map>        // For storing configurations and state data
+#include <sstream>    // For string formatting
+#include <string>     // For text processing
+#include <vector>     // For mocked lists and module state
+#include <iostream>   // For console output
+#include <ctype.h>    // For tolower
+#include <errno.h>    // For strtol range errors
+#include <limits.h>   // For INT_MAX, INT_MIN
+#include <stdio.h>    // For the report
+#include <stdlib.h>   // For atoi, malloc
+#include <string.h>   // For memcpy, memset
+#include <stdint.h>   // For standard integer types
+#include <windows.h>  // For QueryPerformanceCounter, VirtualAlloc
+
+// All plugins, compiled as suite modules
+#include "../suite/suite.cpp"
+
+// Trace format shared with the recorder in the plugins
+#include "../common/trace_recorder.cpp"
+
+// Benchmark runner and workloads
+#include "benchmark_harness.cpp"
+#include "benchmark_workloads.cpp"
+#include "trace_replay.cpp"
+
+/**
+ * @brief Starts the plugins and runs every workload, or replays a trace.
+ * @return 0 on success, 1 if a plugin failed to start, 2 on replay mismatches
+ *         or failed workload checks.
+ */
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--replay") == 0) {
+        return TraceReplay::run(argv[2]);
+    }
+
+    if (!Workloads::start()) {
+        printf("Plugin startup failed, check DynRPG.ini in the working directory\n");
+        return 1;
+    }
+
+    bool passed = Workloads::runAll();
+    Suite::onExit();
+    return passed ? 0 : 2;
+}
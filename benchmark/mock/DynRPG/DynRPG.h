@@ -0,0 +1,276 @@
+/**
+ * @file DynRPG.h
+ * @brief Host-side stand-in for the DynRPG 0.32 SDK header used by the benchmark.
+ * @details Declares the subset of the RPG namespace the plugins use, with
+ *          in-process storage instead of RPG_RT.exe memory. The benchmark fills
+ *          the game state through the Mock namespace and then drives the real
+ *          plugin code against it. Only the benchmark's single translation unit
+ *          includes this header, so the globals are defined here.
+ */
+
+#ifndef DYNRPG_BENCHMARK_MOCK_H
+#define DYNRPG_BENCHMARK_MOCK_H
+
+#include <map>
+#include <string>
+#include <string.h>
+#include <vector>
+
+namespace RPG
+{
+    enum Scene {
+        SCENE_MAP, SCENE_MENU, SCENE_BATTLE, SCENE_SHOP, SCENE_NAME,
+        SCENE_FILE, SCENE_TITLE, SCENE_GAME_OVER, SCENE_DEBUG
+    };
+    enum ActionKind { AK_BASIC, AK_SKILL, AK_TRANSFORM, AK_ITEM };
+    enum BasicAction { BA_ATTACK, BA_DOUBLE_ATTACK, BA_DEFEND };
+    enum Target { TARGET_NONE, TARGET_ACTOR, TARGET_ALL_ACTORS, TARGET_MONSTER, TARGET_ALL_MONSTERS };
+    enum SkillTarget {
+        SKILL_TARGET_ENEMY, SKILL_TARGET_ALL_ENEMIES, SKILL_TARGET_SELF,
+        SKILL_TARGET_ALLY, SKILL_TARGET_ALL_ALLIES
+    };
+    enum BattleEventUpdateMode { BEUM_BATTLE_START };
+
+    /** @brief Game string; a mock string is always set. */
+    struct DStringPtr {
+        std::string text;
+        operator bool() const { return true; }
+        std::string s_str() const { return text; }
+    };
+
+    struct Action {
+        ActionKind kind;
+        BasicAction basicActionId;
+        int skillId;
+        Target target;
+        int targetId;
+    };
+
+    struct Battler {
+        int id;
+        int hp;
+        int maxHp;
+        bool monster;
+        Action* action;
+        bool isMonster() { return monster; }
+        int getMaxHp() { return maxHp; }
+    };
+
+    struct Actor : Battler {
+        short weaponId, shieldId, armorId, helmetId, accessoryId;
+        bool twoWeapons;
+        int* battleCommands;
+        static Actor* partyMember(int index);
+    };
+
+    struct Monster : Battler {};
+
+    struct Skill {
+        SkillTarget target;
+    };
+
+    struct Window {
+        int selected;
+        int getSelected() { return selected; }
+    };
+
+    struct BattleData {
+        Window* winCommand;
+        Window* winParty;
+        Battler* currentHero;
+    };
+
+    struct BattleCommand {
+        DStringPtr name;
+    };
+
+    struct BattleSettings {
+        BattleCommand* battleCommands[100];
+    };
+
+    /** @brief 8-bit palette image with the blit semantics of the SDK. */
+    struct Image {
+        int width, height;
+        unsigned char* pixels;
+        int palette[256];
+        bool useMaskColor;
+        bool autoResize;
+        int alpha;
+
+        static Image* create() { return create(0, 0); }
+        static Image* create(int w, int h) {
+            Image* image = new Image();
+            image->pixels = nullptr;
+            image->useMaskColor = false;
+            image->autoResize = false;
+            image->alpha = 255;
+            memset(image->palette, 0, sizeof(image->palette));
+            image->width = image->height = 0;
+            image->init(w, h);
+            return image;
+        }
+        static void destroy(Image*& image) {
+            if (image) {
+                delete[] image->pixels;
+                delete image;
+                image = nullptr;
+            }
+        }
+
+        void init(int w, int h) {
+            delete[] pixels;
+            width = w;
+            height = h;
+            pixels = (w > 0 && h > 0) ? new unsigned char[w * h]() : nullptr;
+        }
+
+        void loadFromFile(std::string filename, bool throwErrors = true, bool resize = false);
+
+        void draw(int x, int y, Image* src, int srcX = 0, int srcY = 0,
+                  int srcWidth = -1, int srcHeight = -1, int maskColor = -1) {
+            if (!src || !src->pixels || !pixels) return;
+            if (srcWidth < 0) srcWidth = src->width;
+            if (srcHeight < 0) srcHeight = src->height;
+            for (int row = 0; row < srcHeight; ++row) {
+                int sy = srcY + row, dy = y + row;
+                if (sy < 0 || sy >= src->height || dy < 0 || dy >= height) continue;
+                for (int col = 0; col < srcWidth; ++col) {
+                    int sx = srcX + col, dx = x + col;
+                    if (sx < 0 || sx >= src->width || dx < 0 || dx >= width) continue;
+                    unsigned char color = src->pixels[sy * src->width + sx];
+                    if (color == 0 && (maskColor >= 0 || src->useMaskColor)) continue;
+                    pixels[dy * width + dx] = color;
+                }
+            }
+        }
+
+        void drawText(int x, int y, std::string text, int color) {
+            (void)x; (void)y; (void)text; (void)color;
+        }
+
+        void clear() {
+            if (pixels) memset(pixels, 0, width * height);
+        }
+    };
+
+    /** @brief The 320x240 game screen. */
+    struct Canvas {
+        Image* surface;
+        void draw(int x, int y, Image* image, int srcX = 0, int srcY = 0,
+                  int srcWidth = -1, int srcHeight = -1) {
+            surface->draw(x, y, image, srcX, srcY, srcWidth, srcHeight);
+        }
+    };
+
+    struct Screen {
+        Canvas* canvas;
+    };
+
+    struct Sound {
+        Sound(std::string, int, int, int) {}
+        void play() {}
+    };
+
+    struct ParsedCommentParameter {
+        int type;
+        double number;
+        char text[200];
+    };
+
+    struct ParsedCommentData {
+        char command[200];
+        int parametersCount;
+        ParsedCommentParameter parameters[100];
+    };
+
+    struct EventScriptLine {};
+    struct EventScriptData {};
+
+    /** @brief Variable storage, indexed by the game's 1-based IDs. */
+    struct Variables {
+        std::vector<int> values;
+        int& operator[](int id) {
+            if (id < 0) id = 0;
+            if (static_cast<size_t>(id) >= values.size()) values.resize(id + 1, 0);
+            return values[id];
+        }
+    };
+
+    /** @brief Switch storage, indexed by the game's 1-based IDs. */
+    struct Switches {
+        std::vector<char> values;
+        bool& operator[](int id) {
+            if (id < 0) id = 0;
+            if (static_cast<size_t>(id) >= values.size()) values.resize(id + 1, 0);
+            return reinterpret_cast<bool&>(values[id]);
+        }
+    };
+
+    template<class T> struct DList {
+        std::vector<T> items;
+        int count() { return static_cast<int>(items.size()); }
+        T operator[](int index) {
+            return (index >= 0 && index < count()) ? items[index] : T();
+        }
+    };
+
+    Variables variables;
+    Switches switches;
+    DList<Actor*> actors;
+    DList<Monster*> monsters;
+    DList<Skill*> skills;
+    BattleData* battleData = nullptr;
+    BattleSettings* battleSettings = nullptr;
+    Screen* screen = nullptr;
+
+    std::map<std::string, std::string> loadConfiguration(char* sectionName, char* filename = 0) {
+        (void)sectionName; (void)filename;
+        return std::map<std::string, std::string>();
+    }
+
+    void updateBattleEvents(BattleEventUpdateMode, Battler*) {}
+} // namespace RPG
+
+/**
+ * @namespace Mock
+ * @brief Game state behind the mocked RPG namespace.
+ */
+namespace Mock
+{
+    /** @brief Party members in slots 0-3, nullptr for empty slots. */
+    RPG::Actor* party[4] = { nullptr, nullptr, nullptr, nullptr };
+
+    /** @brief Size given to images loaded from a file, by file name. */
+    std::map<std::string, std::pair<int, int> > imageSizes;
+
+    /** @brief Screen surface behind RPG::screen. */
+    RPG::Canvas canvas;
+    RPG::Screen screen;
+} // namespace Mock
+
+RPG::Actor* RPG::Actor::partyMember(int index) {
+    return (index >= 0 && index < 4) ? Mock::party[index] : nullptr;
+}
+
+/**
+ * @note Files are not decoded. The image gets the size registered in
+ *       Mock::imageSizes and a pattern of palette indices so blits and
+ *       palette scans touch realistic data.
+ */
+void RPG::Image::loadFromFile(std::string filename, bool throwErrors, bool resize) {
+    (void)throwErrors;
+    std::map<std::string, std::pair<int, int> >::const_iterator size = Mock::imageSizes.find(filename);
+    if (size == Mock::imageSizes.end()) {
+        if (resize) init(0, 0);
+        return;
+    }
+    init(size->second.first, size->second.second);
+    for (int i = 0; i < width * height; ++i) {
+        pixels[i] = static_cast<unsigned char>(1 + (i % 15));
+    }
+    for (int i = 0; i < 256; ++i) {
+        palette[i] = i * 0x010101;
+    }
+}
+
+#endif // DYNRPG_BENCHMARK_MOCK_H
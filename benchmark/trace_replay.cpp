@@ -0,0 +1,536 @@
+/**
+ * @file trace_replay.cpp
+ * @brief Deterministic replay of callback traces recorded in the game.
+ * @details Reads a <plugin>_trace.bin written by TraceRecorder, restores the
+ *          recorded game state into the mock before every callback, calls the
+ *          recording plugin's namespace and compares the state and return value
+ *          afterwards with the recorded outputs. Reports mismatches and the
+ *          replay timings next to the timings measured in the game.
+ */
+
+/**
+ * @namespace TraceReplay
+ * @brief Trace decoding, state restore and comparison.
+ */
+namespace TraceReplay
+{
+    /** @brief Mismatches printed in detail before only counting the rest. */
+    const int RP_MAX_REPORTED_MISMATCHES = 20;
+
+    /** @brief Range mapped in place of RPG_RT.exe for quickpatch writes. */
+    const unsigned int RP_GAME_IMAGE_ADDRESS = 0x400000;
+    const unsigned int RP_GAME_IMAGE_SIZE = 0x200000;
+
+    /** @brief Callback entry points of one replay target. */
+    struct Target {
+        const char* name;   ///< DynRPG.ini section stored in the trace header
+        int module;         ///< Suite module flag, 0 for the suite itself
+        void (*onFrame)(RPG::Scene);
+        bool (*onSetVariable)(int, int);
+        bool (*onComment)(const char*, const RPG::ParsedCommentData*, RPG::EventScriptLine*,
+                          RPG::EventScriptData*, int, int, int, int*);
+        bool (*onDoBattlerAction)(RPG::Battler*, bool);
+        bool (*onBattlerActionDone)(RPG::Battler*, bool);
+        bool (*onDrawBattleStatusWindow)(int, int, bool, bool, bool);
+        bool (*onDrawBattleActionWindow)(int*, int*, int, bool, bool);
+        void (*onInitFinished)();
+        void (*onNewGame)();
+        void (*onLoadGame)(int, char*, int);
+    };
+
+    /** @brief Plugins a trace can be replayed into. */
+    static const Target targets[] = {
+        { "bare_handed", Suite::MODULE_BARE_HANDED,
+          BareHandedModule::BareHanded::onFrame, BareHandedModule::BareHanded::onSetVariable,
+          BareHandedModule::BareHanded::onComment, nullptr, nullptr, nullptr, nullptr,
+          nullptr, nullptr, nullptr },
+        { "direct_skills", Suite::MODULE_DIRECT_SKILLS,
+          DirectSkillsModule::DirectSkills::onFrame, DirectSkillsModule::DirectSkills::onSetVariable,
+          nullptr, DirectSkillsModule::DirectSkills::onDoBattlerAction,
+          DirectSkillsModule::DirectSkills::onBattlerActionDone, nullptr, nullptr,
+          nullptr, nullptr, nullptr },
+        { "dynamic_quickpatch", Suite::MODULE_DYNAMIC_QUICKPATCH,
+          DynamicQuickPatchModule::DynamicQuickPatch::onFrame,
+          DynamicQuickPatchModule::DynamicQuickPatch::onSetVariable,
+          nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+          DynamicQuickPatchModule::DynamicQuickPatch::onNewGame,
+          DynamicQuickPatchModule::DynamicQuickPatch::onLoadGame },
+        { "limit_break", Suite::MODULE_LIMIT_BREAK,
+          LimitBreakModule::LimitBreak::onFrame, LimitBreakModule::LimitBreak::onSetVariable,
+          nullptr, LimitBreakModule::LimitBreak::onDoBattlerAction,
+          LimitBreakModule::LimitBreak::onBattlerActionDone,
+          LimitBreakModule::LimitBreak::onDrawBattleStatusWindow,
+          LimitBreakModule::LimitBreak::onDrawBattleActionWindow,
+          LimitBreakModule::LimitBreak::onInitFinished, nullptr, nullptr },
+        { "suite", 0,
+          Suite::onFrame, Suite::onSetVariable, Suite::onComment, Suite::onDoBattlerAction,
+          Suite::onBattlerActionDone, Suite::onDrawBattleStatusWindow, Suite::onDrawBattleActionWindow,
+          Suite::onInitFinished, Suite::onNewGame, Suite::onLoadGame }
+    };
+
+    /** @brief Callback names, indexed by record type. */
+    static const char* const callbackNames[TraceRecorder::TR_CALLBACK_LAST + 1] = {
+        "", "onFrame", "onSetVariable", "onComment", "onDoBattlerAction", "onBattlerActionDone",
+        "onDrawBattleStatusWindow", "onDrawBattleActionWindow", "onInitFinished", "onNewGame", "onLoadGame"
+    };
+
+    /** @brief Replay and recorded timings of one callback. */
+    struct CallbackStats {
+        unsigned int calls;
+        double replayNs, replayMaxNs;
+        double recordedNs, recordedMaxNs;
+        unsigned int mismatches;
+    };
+
+    /** @brief Sequential reader over the trace bytes. */
+    struct Reader {
+        const unsigned char* p;
+        const unsigned char* end;
+        bool ok;
+
+        int getByte() {
+            if (p >= end) {
+                ok = false;
+                return -1;
+            }
+            return *p++;
+        }
+
+        int64_t getInt() {
+            uint64_t zigzag = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                int byte = getByte();
+                if (byte < 0) return 0;
+                zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) break;
+            }
+            return static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        }
+
+        std::string getString() {
+            int64_t length = getInt();
+            if (length < 0 || length > end - p) {
+                ok = false;
+                return std::string();
+            }
+            std::string text(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+            p += length;
+            return text;
+        }
+    };
+
+    /** @brief Mocked battlers and windows the trace state is restored into. */
+    static RPG::Actor actors[TraceRecorder::TR_PARTY_SLOTS];
+    static RPG::Monster monsters[TraceRecorder::TR_MONSTER_SLOTS];
+    static RPG::Action actorActions[TraceRecorder::TR_PARTY_SLOTS];
+    static RPG::Action monsterActions[TraceRecorder::TR_MONSTER_SLOTS];
+    static int commands[TraceRecorder::TR_PARTY_SLOTS][TraceRecorder::TR_COMMAND_SLOTS];
+    static RPG::Window commandWindow;
+    static RPG::Window partyWindow;
+    static RPG::BattleData battleData;
+
+    /** @brief Number of mismatches found so far. */
+    static int mismatchCount = 0;
+
+    /**
+     * @brief Restores an action from captured fields.
+     */
+    void restoreAction(RPG::Action& action, const int* fields) {
+        action.kind = static_cast<RPG::ActionKind>(fields[0]);
+        action.basicActionId = static_cast<RPG::BasicAction>(fields[1]);
+        action.skillId = fields[2];
+        action.target = static_cast<RPG::Target>(fields[3]);
+        action.targetId = fields[4];
+    }
+
+    /**
+     * @brief Restores the mock game state from a traced state.
+     * @param state The state to restore.
+     */
+    void restoreState(const TraceRecorder::State& state) {
+        using namespace TraceRecorder;
+
+        for (int slot = 0; slot < TR_PARTY_SLOTS; ++slot) {
+            const int* fields = state.actors[slot];
+            if (!fields[AF_PRESENT]) {
+                Mock::party[slot] = nullptr;
+                continue;
+            }
+            RPG::Actor& actor = actors[slot];
+            actor.id = fields[AF_ID];
+            actor.hp = fields[AF_HP];
+            actor.maxHp = fields[AF_MAX_HP];
+            actor.monster = false;
+            actor.weaponId = static_cast<short>(fields[AF_WEAPON]);
+            actor.shieldId = static_cast<short>(fields[AF_SHIELD]);
+            actor.armorId = static_cast<short>(fields[AF_ARMOR]);
+            actor.helmetId = static_cast<short>(fields[AF_HELMET]);
+            actor.accessoryId = static_cast<short>(fields[AF_ACCESSORY]);
+            actor.twoWeapons = fields[AF_TWO_WEAPONS] != 0;
+            actor.action = &actorActions[slot];
+            restoreAction(actorActions[slot], &fields[AF_ACTION_KIND]);
+            actor.battleCommands = commands[slot];
+            for (int i = 0; i < TR_COMMAND_SLOTS; ++i) {
+                commands[slot][i] = fields[AF_COMMANDS + i];
+            }
+            Mock::party[slot] = &actor;
+        }
+
+        RPG::monsters.items.clear();
+        for (int slot = 0; slot < TR_MONSTER_SLOTS; ++slot) {
+            const int* fields = state.monsters[slot];
+            if (!fields[MF_PRESENT]) continue;
+            RPG::Monster& monster = monsters[slot];
+            monster.id = fields[MF_ID];
+            monster.hp = fields[MF_HP];
+            monster.maxHp = fields[MF_MAX_HP];
+            monster.monster = true;
+            monster.action = &monsterActions[slot];
+            restoreAction(monsterActions[slot], &fields[MF_ACTION_KIND]);
+            RPG::monsters.items.resize(slot + 1, nullptr);
+            RPG::monsters.items[slot] = &monster;
+        }
+
+        if (state.battle[BF_PRESENT]) {
+            commandWindow.selected = state.battle[BF_COMMAND];
+            int hero = state.battle[BF_CURRENT_HERO];
+            battleData.winCommand = &commandWindow;
+            battleData.winParty = &partyWindow;
+            battleData.currentHero = (hero >= 0 && hero < TR_PARTY_SLOTS) ? &actors[hero] : nullptr;
+            RPG::battleData = &battleData;
+        } else {
+            RPG::battleData = nullptr;
+        }
+
+        for (size_t i = 0; i < watchedVariables.size(); ++i) {
+            RPG::variables[watchedVariables[i]] = state.variables[i];
+        }
+    }
+
+    /**
+     * @brief Applies one state delta record to a traced state.
+     * @param reader The trace reader, positioned after the record type.
+     * @param type The state record type.
+     * @param state The state to update.
+     */
+    void readStateDelta(Reader& reader, int type, TraceRecorder::State& state) {
+        using namespace TraceRecorder;
+
+        if (type == TR_STATE_VARIABLES) {
+            int64_t count = reader.getInt();
+            for (int64_t i = 0; i < count && reader.ok; ++i) {
+                int64_t index = reader.getInt();
+                int value = static_cast<int>(reader.getInt());
+                if (index >= 0 && static_cast<size_t>(index) < state.variables.size()) {
+                    state.variables[static_cast<size_t>(index)] = value;
+                }
+            }
+            return;
+        }
+
+        int slot = static_cast<int>(reader.getInt());
+        uint32_t mask = static_cast<uint32_t>(reader.getInt());
+        int* fields = nullptr;
+        int count = 0;
+        if (type == TR_STATE_ACTOR && slot >= 0 && slot < TR_PARTY_SLOTS) {
+            fields = state.actors[slot];
+            count = AF_COUNT;
+        } else if (type == TR_STATE_MONSTER && slot >= 0 && slot < TR_MONSTER_SLOTS) {
+            fields = state.monsters[slot];
+            count = MF_COUNT;
+        } else if (type == TR_STATE_BATTLE) {
+            fields = state.battle;
+            count = BF_COUNT;
+        }
+
+        for (int i = 0; i < 32; ++i) {
+            if (!(mask & (1u << i))) continue;
+            int value = static_cast<int>(reader.getInt());
+            if (fields && i < count) fields[i] = value;
+        }
+    }
+
+    /**
+     * @brief Reports one mismatch between the replayed and the recorded outputs.
+     */
+    void reportMismatch(int record, int callback, const char* what, int slot, int field, int expected, int actual) {
+        if (mismatchCount < RP_MAX_REPORTED_MISMATCHES) {
+            printf("mismatch at call %d (%s): %s %d field %d expected %d, replay %d\n",
+                   record, callbackNames[callback], what, slot, field, expected, actual);
+        }
+        ++mismatchCount;
+    }
+
+    /**
+     * @brief Compares field blocks and reports every difference.
+     * @return Number of differences.
+     */
+    int compareFields(int record, int callback, const char* what, int slot,
+                      const int* expected, const int* actual, int count) {
+        int differences = 0;
+        for (int i = 0; i < count; ++i) {
+            if (expected[i] != actual[i]) {
+                reportMismatch(record, callback, what, slot, i, expected[i], actual[i]);
+                ++differences;
+            }
+        }
+        return differences;
+    }
+
+    /**
+     * @brief Compares the replayed state with the recorded state after a call.
+     * @return Number of differences.
+     */
+    int compareState(int record, int callback, const TraceRecorder::State& expected,
+                     const TraceRecorder::State& actual) {
+        using namespace TraceRecorder;
+        int differences = 0;
+        for (int slot = 0; slot < TR_PARTY_SLOTS; ++slot) {
+            differences += compareFields(record, callback, "actor slot", slot,
+                                         expected.actors[slot], actual.actors[slot], AF_COUNT);
+        }
+        for (int slot = 0; slot < TR_MONSTER_SLOTS; ++slot) {
+            differences += compareFields(record, callback, "monster slot", slot,
+                                         expected.monsters[slot], actual.monsters[slot], MF_COUNT);
+        }
+        differences += compareFields(record, callback, "battle", 0, expected.battle, actual.battle, BF_COUNT);
+        for (size_t i = 0; i < expected.variables.size(); ++i) {
+            if (expected.variables[i] != actual.variables[i]) {
+                reportMismatch(record, callback, "variable", watchedVariables[i], 0,
+                               expected.variables[i], actual.variables[i]);
+                ++differences;
+            }
+        }
+        return differences;
+    }
+
+    /**
+     * @brief Resolves a traced battler reference to a mocked battler.
+     */
+    RPG::Battler* battlerFor(int ref) {
+        using namespace TraceRecorder;
+        if (ref >= 0 && ref < TR_PARTY_SLOTS) return &actors[ref];
+        if (ref >= TR_PARTY_SLOTS && ref < TR_PARTY_SLOTS + TR_MONSTER_SLOTS) return &monsters[ref - TR_PARTY_SLOTS];
+        return nullptr;
+    }
+
+    /**
+     * @brief Decodes one callback record and calls the target.
+     * @param reader The trace reader, positioned after the record type.
+     * @param type The callback record type.
+     * @param target The replay target.
+     * @param returned Receives the return value, 1 for void callbacks.
+     * @param outputs Receives the values written through pointer arguments,
+     *        see TraceRecorder::outputCount.
+     */
+    void invoke(Reader& reader, int type, const Target& target, int& returned, int* outputs) {
+        using namespace TraceRecorder;
+        returned = 1;
+
+        if (type == TR_COMMENT) {
+            static RPG::ParsedCommentData parsed;
+            memset(&parsed, 0, sizeof(parsed));
+            std::string command = reader.getString();
+            strncpy(parsed.command, command.c_str(), sizeof(parsed.command) - 1);
+            int64_t count = reader.getInt();
+            parsed.parametersCount = static_cast<int>(std::min<int64_t>(std::max<int64_t>(count, 0), 100));
+            for (int64_t i = 0; i < count && reader.ok; ++i) {
+                int parameterType = static_cast<int>(reader.getInt());
+                int64_t bits = reader.getInt();
+                std::string text = reader.getString();
+                if (i >= 100) continue;
+                RPG::ParsedCommentParameter& parameter = parsed.parameters[i];
+                parameter.type = parameterType;
+                memcpy(&parameter.number, &bits, sizeof(bits));
+                strncpy(parameter.text, text.c_str(), sizeof(parameter.text) - 1);
+            }
+            if (target.onComment) {
+                static RPG::EventScriptLine line;
+                static RPG::EventScriptData data;
+                int nextLineId = 0;
+                returned = target.onComment(command.c_str(), &parsed, &line, &data, 0, 0, 0, &nextLineId);
+            }
+            return;
+        }
+
+        int args[5] = { 0, 0, 0, 0, 0 };
+        for (int i = 0; i < argumentCount(static_cast<RecordType>(type)); ++i) {
+            args[i] = static_cast<int>(reader.getInt());
+        }
+
+        switch (type) {
+            case TR_FRAME:
+                if (target.onFrame) target.onFrame(static_cast<RPG::Scene>(args[0]));
+                break;
+            case TR_SET_VARIABLE:
+                if (target.onSetVariable) returned = target.onSetVariable(args[0], args[1]);
+                break;
+            case TR_DO_BATTLER_ACTION:
+                if (target.onDoBattlerAction && battlerFor(args[0])) {
+                    returned = target.onDoBattlerAction(battlerFor(args[0]), args[1] != 0);
+                }
+                break;
+            case TR_BATTLER_ACTION_DONE:
+                if (target.onBattlerActionDone && battlerFor(args[0])) {
+                    returned = target.onBattlerActionDone(battlerFor(args[0]), args[1] != 0);
+                }
+                break;
+            case TR_DRAW_BATTLE_STATUS_WINDOW:
+                if (target.onDrawBattleStatusWindow) {
+                    returned = target.onDrawBattleStatusWindow(args[0], args[1], args[2] != 0, args[3] != 0, args[4] != 0);
+                }
+                break;
+            case TR_DRAW_BATTLE_ACTION_WINDOW:
+                if (target.onDrawBattleActionWindow) {
+                    returned = target.onDrawBattleActionWindow(&args[0], &args[1], args[2], args[3] != 0, args[4] != 0);
+                }
+                outputs[0] = args[0];
+                outputs[1] = args[1];
+                break;
+            case TR_INIT_FINISHED:
+                if (target.onInitFinished) target.onInitFinished();
+                break;
+            case TR_NEW_GAME:
+                if (target.onNewGame) target.onNewGame();
+                break;
+            case TR_LOAD_GAME:
+                if (target.onLoadGame) target.onLoadGame(args[0], nullptr, 0);
+                break;
+        }
+    }
+
+    /**
+     * @brief Replays a trace file.
+     * @param path The trace file.
+     * @return 0 if every output matched, 1 on errors, 2 on mismatches.
+     */
+    int run(const char* path) {
+        using namespace TraceRecorder;
+
+        std::vector<unsigned char> data;
+        FILE* file = fopen(path, "rb");
+        if (!file) {
+            printf("Cannot open trace %s\n", path);
+            return 1;
+        }
+        unsigned char chunk[4096];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            data.insert(data.end(), chunk, chunk + read);
+        }
+        fclose(file);
+
+        Reader reader = { data.empty() ? nullptr : &data[0], data.empty() ? nullptr : &data[0] + data.size(), true };
+        if (static_cast<uint32_t>(reader.getInt()) != TR_MAGIC || static_cast<uint32_t>(reader.getInt()) != TR_VERSION) {
+            printf("%s is not a version %u trace\n", path, TR_VERSION);
+            return 1;
+        }
+        std::string plugin = reader.getString();
+        watchedVariables.resize(static_cast<size_t>(std::max<int64_t>(reader.getInt(), 0)));
+        for (size_t i = 0; i < watchedVariables.size(); ++i) {
+            watchedVariables[i] = static_cast<int>(reader.getInt());
+        }
+
+        const Target* target = nullptr;
+        for (size_t i = 0; i < sizeof(targets) / sizeof(targets[0]); ++i) {
+            if (plugin == targets[i].name) target = &targets[i];
+        }
+        if (!target) {
+            printf("Trace was recorded by unknown plugin %s\n", plugin.c_str());
+            return 1;
+        }
+
+        if (plugin == "dynamic_quickpatch" || plugin == "suite") {
+            if (!VirtualAlloc(reinterpret_cast<LPVOID>(RP_GAME_IMAGE_ADDRESS), RP_GAME_IMAGE_SIZE,
+                              MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)) {
+                printf("Cannot map the game image range for quickpatch writes\n");
+                return 1;
+            }
+        }
+
+        Workloads::setupGameState();
+        char suiteName[] = "suite";
+        Suite::onStartup(suiteName);
+        if (target->module && !(Suite::enabledModules & target->module)) {
+            printf("[%s] is missing from DynRPG.ini in the working directory\n", plugin.c_str());
+            return 1;
+        }
+
+        State expected, actual;
+        resetState(expected);
+        resetState(actual);
+        restoreState(expected);
+
+        CallbackStats stats[TR_CALLBACK_LAST + 1];
+        memset(stats, 0, sizeof(stats));
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+
+        int callIndex = 0;
+        int currentCallback = 0;
+        int returned = 1;
+        int outputs[2] = { 0, 0 };
+        double replayNs = 0.0;
+
+        while (reader.ok && reader.p < reader.end) {
+            int type = reader.getByte();
+            if (type >= TR_STATE_ACTOR && type <= TR_STATE_VARIABLES) {
+                readStateDelta(reader, type, expected);
+            } else if (type >= TR_FRAME && type <= TR_CALLBACK_LAST) {
+                restoreState(expected);
+                LARGE_INTEGER start, end;
+                QueryPerformanceCounter(&start);
+                invoke(reader, type, *target, returned, outputs);
+                QueryPerformanceCounter(&end);
+                replayNs = (end.QuadPart - start.QuadPart) * 1000000000.0 / frequency.QuadPart;
+                currentCallback = type;
+            } else if (type == TR_RESULT && currentCallback) {
+                int recordedReturn = static_cast<int>(reader.getInt());
+                double recordedNs = static_cast<double>(reader.getInt());
+
+                CallbackStats& s = stats[currentCallback];
+                s.calls++;
+                s.replayNs += replayNs;
+                s.replayMaxNs = std::max(s.replayMaxNs, replayNs);
+                s.recordedNs += recordedNs;
+                s.recordedMaxNs = std::max(s.recordedMaxNs, recordedNs);
+
+                captureState(actual);
+                int differences = compareState(callIndex, currentCallback, expected, actual);
+                if (recordedReturn != returned) {
+                    reportMismatch(callIndex, currentCallback, "return value", 0, 0, recordedReturn, returned);
+                    ++differences;
+                }
+                for (int i = 0; i < outputCount(static_cast<RecordType>(currentCallback)); ++i) {
+                    int recordedOutput = static_cast<int>(reader.getInt());
+                    if (recordedOutput != outputs[i]) {
+                        reportMismatch(callIndex, currentCallback, "output", i, 0, recordedOutput, outputs[i]);
+                        ++differences;
+                    }
+                }
+                s.mismatches += differences;
+
+                ++callIndex;
+                currentCallback = 0;
+            } else {
+                printf("Corrupt trace at byte %d\n", static_cast<int>(reader.p - &data[0]));
+                reader.ok = false;
+            }
+        }
+
+        printf("\nReplayed %d calls of %s from %s\n", callIndex, plugin.c_str(), path);
+        printf("%-26s %8s %12s %12s %12s %12s %10s\n", "callback", "calls", "game avg us",
+               "game max us", "replay avg", "replay max", "mismatches");
+        for (int i = TR_FRAME; i <= TR_CALLBACK_LAST; ++i) {
+            const CallbackStats& s = stats[i];
+            if (!s.calls) continue;
+            printf("%-26s %8u %12.2f %12.2f %12.2f %12.2f %10u\n", callbackNames[i], s.calls,
+                   s.recordedNs / s.calls / 1000.0, s.recordedMaxNs / 1000.0,
+                   s.replayNs / s.calls / 1000.0, s.replayMaxNs / 1000.0, s.mismatches);
+        }
+
+        Suite::onExit();
+        if (!reader.ok) return 1;
+        return mismatchCount ? 2 : 0;
+    }
+} // namespace TraceReplay
@@ -0,0 +1,369 @@
+/**
+ * @file async_log.cpp
+ * @brief Asynchronous debug log shared by the DynRPG plugins.
+ * @details Provides a lock-free single-producer ring buffer that is drained by a
+ *          background writer thread to the console and/or a log file. Plugins
+ *          include this file from their debug file; while the log is running,
+ *          std::cout is redirected into the ring so existing debug output and
+ *          std::endl no longer block the game thread on console writes.
+ */
+
+#ifndef DYNRPG_COMMON_ASYNC_LOG_CPP
+#define DYNRPG_COMMON_ASYNC_LOG_CPP
+
+#include <algorithm>  // For std::min
+#include <atomic>     // For lock-free ring positions
+#include <iostream>   // For std::cout redirection
+#include <stdarg.h>   // For formatted records
+#include <stdio.h>    // For console and file output
+#include <streambuf>  // For the std::cout ring buffer adapter
+#include <string.h>   // For memcpy
+#include <windows.h>  // For the writer thread and events
+
+/**
+ * @namespace AsyncLog
+ * @brief Background debug log writer.
+ * @details The game thread is the only producer. It copies records into the ring
+ *          and never waits: if the ring is full, the record is dropped and counted.
+ *          The writer thread is the only consumer and performs all blocking I/O.
+ */
+namespace AsyncLog
+{
+    /** @brief Output sink flags. */
+    enum Sink {
+        SINK_CONSOLE = 1,   ///< Write to the process console (stdout)
+        SINK_FILE = 2       ///< Append to a log file
+    };
+
+    /** @brief Ring buffer size in bytes (must be a power of two). */
+    const unsigned int AL_RING_SIZE = 1 << 16;
+
+    /** @brief Maximum size of one formatted record or buffered std::cout chunk. */
+    const unsigned int AL_RECORD_SIZE = 1024;
+
+    /** @brief Interval in milliseconds at which the writer thread drains the ring. */
+    const DWORD AL_DRAIN_INTERVAL = 15;
+
+    /** @brief Ring buffer storage. */
+    static char ring[AL_RING_SIZE];
+
+    /** @brief Total number of bytes produced (written by the game thread only). */
+    static std::atomic<unsigned int> writePos(0);
+
+    /** @brief Total number of bytes consumed (written by the writer thread only). */
+    static std::atomic<unsigned int> readPos(0);
+
+    /** @brief Bytes dropped because the ring was full. */
+    static std::atomic<unsigned int> droppedBytes(0);
+
+    /** @brief Tracks whether the writer thread is running. */
+    static std::atomic<bool> running(false);
+
+    /** @brief Handle of the writer thread. */
+    static HANDLE writerThread = NULL;
+
+    /** @brief Event used to wake the writer thread early (flush and shutdown). */
+    static HANDLE wakeEvent = NULL;
+
+    /** @brief Active sinks (combination of Sink flags). */
+    static std::atomic<int> activeSinks(0);
+
+    /** @brief Tracks whether the host (the suite build) stops the log instead of the plugins. */
+    static bool hostOwned = false;
+
+    /** @brief Log file used by the file sink. */
+    static FILE* logFile = NULL;
+
+    /**
+     * @brief Copies bytes into the ring buffer.
+     * @param data Bytes to log.
+     * @param length Number of bytes.
+     * @return True if the bytes were queued, false if the log is not running
+     *         or the ring had no room for them.
+     * @note Must only be called from the game thread.
+     */
+    bool write(const char* data, size_t length) {
+        if (!running.load(std::memory_order_relaxed) || length == 0) {
+            return false;
+        }
+
+        unsigned int w = writePos.load(std::memory_order_relaxed);
+        unsigned int r = readPos.load(std::memory_order_acquire);
+        if (length > AL_RING_SIZE - (w - r)) {
+            droppedBytes.fetch_add((unsigned int)length, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Copy in up to two pieces around the end of the ring
+        unsigned int start = w & (AL_RING_SIZE - 1);
+        size_t first = std::min(length, (size_t)(AL_RING_SIZE - start));
+        memcpy(&ring[start], data, first);
+        memcpy(&ring[0], data + first, length - first);
+
+        writePos.store(w + (unsigned int)length, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Writes bytes to all active sinks.
+     * @note Only called from the writer thread.
+     */
+    void emit(const char* data, size_t length) {
+        int sinks = activeSinks.load(std::memory_order_acquire);
+        if (sinks & SINK_CONSOLE) {
+            fwrite(data, 1, length, stdout);
+        }
+        if ((sinks & SINK_FILE) && logFile) {
+            fwrite(data, 1, length, logFile);
+        }
+    }
+
+    /**
+     * @brief Moves everything queued in the ring to the sinks.
+     * @note Only called from the writer thread.
+     */
+    void drain() {
+        unsigned int r = readPos.load(std::memory_order_relaxed);
+        unsigned int w = writePos.load(std::memory_order_acquire);
+        if (r == w && droppedBytes.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+
+        while (r != w) {
+            unsigned int start = r & (AL_RING_SIZE - 1);
+            unsigned int chunk = std::min(w - r, AL_RING_SIZE - start);
+            emit(&ring[start], chunk);
+            r += chunk;
+        }
+        readPos.store(r, std::memory_order_release);
+
+        // Report dropped output so gaps in the log are visible
+        unsigned int dropped = droppedBytes.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            char notice[96];
+            int length = snprintf(notice, sizeof(notice), "[AsyncLog]\n%u bytes of debug output dropped (buffer full)\n\n", dropped);
+            emit(notice, length);
+        }
+
+        int sinks = activeSinks.load(std::memory_order_acquire);
+        if (sinks & SINK_CONSOLE) {
+            fflush(stdout);
+        }
+        if ((sinks & SINK_FILE) && logFile) {
+            fflush(logFile);
+        }
+    }
+
+    /**
+     * @brief Writer thread entry point.
+     * @details Drains the ring every AL_DRAIN_INTERVAL milliseconds or when woken,
+     *          and once more after shutdown was requested.
+     */
+    DWORD WINAPI writerMain(LPVOID) {
+        while (running.load(std::memory_order_acquire)) {
+            WaitForSingleObject(wakeEvent, AL_DRAIN_INTERVAL);
+            drain();
+        }
+        drain();
+        return 0;
+    }
+
+    /**
+     * @brief Stream buffer that forwards std::cout output into the ring.
+     * @details Output is collected in a local buffer and queued as one chunk on
+     *          overflow or sync. std::endl only queues the pending chunk, it does
+     *          not touch the console.
+     */
+    class RingStreamBuf : public std::streambuf {
+    public:
+        RingStreamBuf() {
+            setp(buffer, buffer + sizeof(buffer));
+        }
+
+    protected:
+        int overflow(int c) {
+            commit();
+            if (c != EOF) {
+                *pptr() = (char)c;
+                pbump(1);
+                return c;
+            }
+            return 0;
+        }
+
+        int sync() {
+            commit();
+            return 0;
+        }
+
+    private:
+        void commit() {
+            if (pptr() > pbase()) {
+                write(pbase(), pptr() - pbase());
+            }
+            setp(buffer, buffer + sizeof(buffer));
+        }
+
+        char buffer[AL_RECORD_SIZE];
+    };
+
+    /** @brief Stream buffer installed into std::cout while the log is running. */
+    static RingStreamBuf coutBuffer;
+
+    /** @brief Stream buffer std::cout used before start(). */
+    static std::streambuf* previousCoutBuffer = NULL;
+
+    /**
+     * @brief Starts the writer thread and redirects std::cout into the ring.
+     * @param sinks Combination of Sink flags.
+     * @param filePath Log file path for SINK_FILE (appended to).
+     * @return True if the log is running.
+     * @note The console sink expects stdout to be attached to a console already.
+     * @note If the log is already running (another plugin of the suite started
+     *       it), the requested sinks are added to the active ones. Only one log
+     *       file is open at a time; the first requested path is used.
+     */
+    bool start(int sinks, const char* filePath) {
+        if ((sinks & SINK_FILE) && !logFile && filePath && *filePath) {
+            logFile = fopen(filePath, "a");
+        }
+        if (!logFile) {
+            sinks &= ~SINK_FILE;
+        }
+
+        if (running.load()) {
+            activeSinks.fetch_or(sinks, std::memory_order_release);
+            return true;
+        }
+
+        activeSinks.store(sinks, std::memory_order_release);
+        if (sinks == 0) {
+            return false;
+        }
+
+        writePos.store(0);
+        readPos.store(0);
+        droppedBytes.store(0);
+        wakeEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+        running.store(true, std::memory_order_release);
+        writerThread = CreateThread(NULL, 0, writerMain, NULL, 0, NULL);
+        if (!writerThread) {
+            running.store(false);
+            CloseHandle(wakeEvent);
+            wakeEvent = NULL;
+            if (logFile) {
+                fclose(logFile);
+                logFile = NULL;
+            }
+            return false;
+        }
+
+        previousCoutBuffer = std::cout.rdbuf(&coutBuffer);
+        return true;
+    }
+
+    /**
+     * @brief Wakes the writer thread to write pending output as soon as possible.
+     */
+    void flush() {
+        if (running.load()) {
+            std::cout.flush();
+            SetEvent(wakeEvent);
+        }
+    }
+
+    /**
+     * @brief Writes all pending output, stops the writer thread and restores std::cout.
+     */
+    void stop() {
+        if (!running.load()) {
+            return;
+        }
+
+        std::cout.flush();
+        std::cout.rdbuf(previousCoutBuffer);
+
+        running.store(false, std::memory_order_release);
+        SetEvent(wakeEvent);
+        WaitForSingleObject(writerThread, INFINITE);
+        CloseHandle(writerThread);
+        CloseHandle(wakeEvent);
+        writerThread = NULL;
+        wakeEvent = NULL;
+
+        if (logFile) {
+            fclose(logFile);
+            logFile = NULL;
+        }
+        activeSinks.store(0);
+    }
+
+    /**
+     * @brief Sets whether the host stops the log instead of the plugins.
+     * @param owned True while the suite build owns the log.
+     * @see detach
+     */
+    void setHostOwned(bool owned) {
+        hostOwned = owned;
+    }
+
+    /**
+     * @brief Releases a plugin's use of the log.
+     * @return True if the log was stopped, false if the host still owns it.
+     * @details In the suite build all plugins share one writer thread, so a
+     *          plugin exiting must not stop it for the others; the suite calls
+     *          stop() once after every plugin has exited. A standalone plugin
+     *          owns the log itself and detach() stops it.
+     */
+    bool detach() {
+        if (hostOwned) {
+            return false;
+        }
+        stop();
+        return true;
+    }
+
+    /**
+     * @brief Queues a formatted record.
+     * @param category Record category, printed as "[category]".
+     * @param format printf-style format of the record body.
+     * @details Records use the same layout as the plugins' console output:
+     *          category line, body, blank line. Bodies longer than
+     *          AL_RECORD_SIZE are truncated.
+     * @see ASYNC_LOGF
+     */
+    void writef(const char* category, const char* format, ...) {
+        char record[AL_RECORD_SIZE];
+        int length = snprintf(record, sizeof(record) - 2, "[%s]\n", category);
+        if (length < 0) {
+            return;
+        }
+
+        va_list args;
+        va_start(args, format);
+        int bodyLength = vsnprintf(record + length, sizeof(record) - 2 - length, format, args);
+        va_end(args);
+        if (bodyLength > 0) {
+            length = std::min(length + bodyLength, (int)sizeof(record) - 3);
+        }
+
+        record[length++] = '\n';
+        record[length++] = '\n';
+        write(record, length);
+    }
+} // namespace AsyncLog
+
+/**
+ * @def ASYNC_LOGF(enabled, category, ...)
+ * @brief Queues a formatted record if enabled is true.
+ * @details Arguments are not evaluated when enabled is false. Defining
+ *          ASYNC_LOG_DISABLED removes all records at compile time.
+ */
+#ifdef ASYNC_LOG_DISABLED
+#define ASYNC_LOGF(enabled, category, ...) ((void)0)
+#else
+#define ASYNC_LOGF(enabled, category, ...) \
+    do { if (enabled) { AsyncLog::writef(category, __VA_ARGS__); } } while (0)
+#endif
+
+#endif // DYNRPG_COMMON_ASYNC_LOG_CPP
@@ -0,0 +1,554 @@
+/**
+ * @file ini_cache.cpp
+ * @brief Parse-once DynRPG.ini cache shared by the DynRPG plugins.
+ * @details Reads DynRPG.ini a single time per plugin and keeps every section in
+ *          memory, so repeated RPG::loadConfiguration calls (including reads of
+ *          other plugins' sections) no longer touch the file. Keys of the form
+ *          <Prefix><N><Suffix>, such as Actor3_VariableId or BattleCommandId5,
+ *          are pre-split so loaders can walk only the entries that exist instead
+ *          of probing fixed ID ranges.
+ *
+ *          When DynRPG.ini contains
+ *          @code
+ *          [ConfigCache]
+ *          Enabled=true
+ *          @endcode
+ *          the parsed sections are also written to DynRPG.ini.cache. The cache
+ *          stores the size and last write time of DynRPG.ini and is only used
+ *          while both still match, so later starts skip text parsing entirely.
+ */
+
+#ifndef DYNRPG_COMMON_INI_CACHE_CPP
+#define DYNRPG_COMMON_INI_CACHE_CPP
+
+#include <algorithm>  // For std::sort, std::lower_bound
+#include <ctype.h>    // For tolower
+#include <map>        // For section and key storage
+#include <stdint.h>   // For fixed-size cache fields
+#include <stdio.h>    // For file I/O
+#include <stdlib.h>   // For strtol
+#include <string>     // For keys and values
+#include <string.h>   // For memcpy, memcmp
+#include <vector>     // For indexed keys and file buffers
+#include <windows.h>  // For file timestamps and atomic replace
+
+/**
+ * @namespace IniCache
+ * @brief In-memory and on-disk cache of DynRPG.ini.
+ * @details All functions must be called from the game thread.
+ */
+namespace IniCache
+{
+    /** @brief Path of the INI file, as used by RPG::loadConfiguration. */
+    const char* const IC_INI_PATH = ".\\DynRPG.ini";
+
+    /** @brief Path of the compiled cache written next to the INI file. */
+    const char* const IC_CACHE_PATH = ".\\DynRPG.ini.cache";
+
+    /** @brief Cache file signature ("DRIC"). */
+    const uint32_t IC_MAGIC = 0x43495244;
+
+    /** @brief Cache file format version. */
+    const uint32_t IC_VERSION = 1;
+
+    /**
+     * @brief A key of the form <Prefix><N><Suffix>, split at load time.
+     * @details A single underscore between N and the suffix is dropped, so both
+     *          Actor1LimitVarID and Actor1_VariableId are indexed under "Actor".
+     */
+    struct IndexedKey {
+        std::string prefix;  ///< Leading non-digit part of the key
+        int index;           ///< Number following the prefix
+        std::string suffix;  ///< Rest of the key, empty if none
+        std::string value;   ///< Value of the key
+    };
+
+    /** @brief Range of indexed keys sharing one prefix, ordered by index and suffix. */
+    struct IndexedRange {
+        const IndexedKey* first;
+        const IndexedKey* last;
+
+        const IndexedKey* begin() const { return first; }
+        const IndexedKey* end() const { return last; }
+        bool empty() const { return first == last; }
+    };
+
+    /** @brief One parsed INI section. */
+    struct Section {
+        /** @brief All keys of the section. */
+        std::map<std::string, std::string> values;
+
+        /** @brief Numbered keys, sorted by prefix, index and suffix. */
+        std::vector<IndexedKey> indexed;
+
+        /**
+         * @brief Looks up a key.
+         * @param key The key to look up.
+         * @return Pointer to the value, or nullptr if the key does not exist.
+         */
+        const std::string* find(const std::string& key) const {
+            std::map<std::string, std::string>::const_iterator it = values.find(key);
+            return (it != values.end()) ? &it->second : nullptr;
+        }
+
+        /**
+         * @brief Reads an integer key.
+         * @param key The key to read.
+         * @param defaultValue Value returned if the key is missing or not a number.
+         * @return The parsed value.
+         */
+        int getInt(const std::string& key, int defaultValue) const {
+            const std::string* value = find(key);
+            if (!value) {
+                return defaultValue;
+            }
+            char* end = nullptr;
+            long result = strtol(value->c_str(), &end, 10);
+            return (end != value->c_str()) ? static_cast<int>(result) : defaultValue;
+        }
+
+        /**
+         * @brief Reads a boolean key.
+         * @param key The key to read.
+         * @param defaultValue Value returned if the key is missing.
+         * @return True for true, 1, yes and on, false otherwise.
+         */
+        bool getBool(const std::string& key, bool defaultValue) const {
+            const std::string* value = find(key);
+            if (!value) {
+                return defaultValue;
+            }
+            std::string lower = *value;
+            for (size_t i = 0; i < lower.length(); i++) {
+                lower[i] = tolower(lower[i]);
+            }
+            return lower == "true" || lower == "1" || lower == "yes" || lower == "on";
+        }
+
+        /**
+         * @brief Gets all numbered keys with the given prefix.
+         * @param prefix The exact key prefix, e.g. "Actor".
+         * @return The keys, ordered by index and suffix.
+         */
+        IndexedRange getIndexed(const std::string& prefix) const {
+            IndexedRange range = { nullptr, nullptr };
+            if (indexed.empty()) {
+                return range;
+            }
+
+            const IndexedKey* first = &indexed[0];
+            const IndexedKey* last = first + indexed.size();
+            range.first = std::lower_bound(first, last, prefix,
+                [](const IndexedKey& entry, const std::string& p) { return entry.prefix < p; });
+            range.last = range.first;
+            while (range.last != last && range.last->prefix == prefix) {
+                ++range.last;
+            }
+            return range;
+        }
+    };
+
+    /** @brief Parsed sections, keyed by lowercase section name. */
+    static std::map<std::string, Section> sections;
+
+    /** @brief Tracks whether DynRPG.ini has been loaded. */
+    static bool loaded = false;
+
+    /** @brief Tracks whether the sections came from the compiled cache. */
+    static bool loadedFromCache = false;
+
+    /** @brief Returned for sections that do not exist. */
+    static const Section emptySection = Section();
+
+    /**
+     * @brief Size and last write time identifying one version of DynRPG.ini.
+     */
+    struct IniStamp {
+        uint32_t sizeLow;
+        uint32_t sizeHigh;
+        uint32_t timeLow;
+        uint32_t timeHigh;
+    };
+
+    /**
+     * @brief Converts a section name to its lookup key.
+     * @param name The section name.
+     * @return The lowercase name, since INI section names are case-insensitive.
+     */
+    std::string sectionKey(const std::string& name) {
+        std::string key = name;
+        for (size_t i = 0; i < key.length(); i++) {
+            key[i] = tolower(key[i]);
+        }
+        return key;
+    }
+
+    /**
+     * @brief Reads the stamp of DynRPG.ini.
+     * @param stamp Receives the stamp.
+     * @return False if the file does not exist.
+     */
+    bool readIniStamp(IniStamp& stamp) {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExA(IC_INI_PATH, GetFileExInfoStandard, &data)) {
+            return false;
+        }
+        stamp.sizeLow = data.nFileSizeLow;
+        stamp.sizeHigh = data.nFileSizeHigh;
+        stamp.timeLow = data.ftLastWriteTime.dwLowDateTime;
+        stamp.timeHigh = data.ftLastWriteTime.dwHighDateTime;
+        return true;
+    }
+
+    /**
+     * @brief Reads a whole file into memory.
+     * @param path The file to read.
+     * @param data Receives the file contents.
+     * @return False if the file could not be read.
+     */
+    bool readFile(const char* path, std::vector<char>& data) {
+        FILE* file = fopen(path, "rb");
+        if (!file) {
+            return false;
+        }
+
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        bool ok = size >= 0;
+        if (ok) {
+            data.resize(size);
+            ok = size == 0 || fread(&data[0], 1, size, file) == static_cast<size_t>(size);
+        }
+        fclose(file);
+        return ok;
+    }
+
+    /**
+     * @brief Adds a key to a section, the first occurrence of a key wins.
+     * @param section The section.
+     * @param key The key.
+     * @param value The value.
+     */
+    void addValue(Section& section, const std::string& key, const std::string& value) {
+        section.values.insert(std::make_pair(key, value));
+    }
+
+    /**
+     * @brief Splits the numbered keys of a section into its index.
+     * @param section The section to index.
+     */
+    void buildIndex(Section& section) {
+        section.indexed.clear();
+
+        for (std::map<std::string, std::string>::const_iterator it = section.values.begin();
+             it != section.values.end(); ++it) {
+            const std::string& key = it->first;
+
+            size_t digitsStart = 0;
+            while (digitsStart < key.length() && (key[digitsStart] < '0' || key[digitsStart] > '9')) {
+                digitsStart++;
+            }
+            if (digitsStart == 0 || digitsStart == key.length()) {
+                continue; // No prefix or no number
+            }
+
+            size_t digitsEnd = digitsStart;
+            long index = 0;
+            while (digitsEnd < key.length() && key[digitsEnd] >= '0' && key[digitsEnd] <= '9') {
+                index = index * 10 + (key[digitsEnd] - '0');
+                if (index > 0x7FFFFFF) {
+                    break;
+                }
+                digitsEnd++;
+            }
+            if (digitsEnd < key.length() && key[digitsEnd] >= '0' && key[digitsEnd] <= '9') {
+                continue; // Number too large to be an ID
+            }
+
+            size_t suffixStart = digitsEnd;
+            if (suffixStart < key.length() && key[suffixStart] == '_') {
+                suffixStart++;
+            }
+
+            IndexedKey entry;
+            entry.prefix = key.substr(0, digitsStart);
+            entry.index = static_cast<int>(index);
+            entry.suffix = key.substr(suffixStart);
+            entry.value = it->second;
+            section.indexed.push_back(entry);
+        }
+
+        std::sort(section.indexed.begin(), section.indexed.end(),
+            [](const IndexedKey& a, const IndexedKey& b) {
+                if (a.prefix != b.prefix) return a.prefix < b.prefix;
+                if (a.index != b.index) return a.index < b.index;
+                return a.suffix < b.suffix;
+            });
+    }
+
+    /**
+     * @brief Parses the text of DynRPG.ini into sections.
+     * @param text The file contents.
+     * @details Lines starting with ; or # are comments. Keys and section names
+     *          are trimmed, values keep everything after the first = except
+     *          trailing whitespace, like RPG::loadConfiguration.
+     */
+    void parseIni(const std::vector<char>& text) {
+        Section* current = nullptr;
+        size_t pos = 0;
+        size_t length = text.size();
+
+        // Skip a UTF-8 byte order mark
+        if (length >= 3 && (unsigned char)text[0] == 0xEF && (unsigned char)text[1] == 0xBB &&
+            (unsigned char)text[2] == 0xBF) {
+            pos = 3;
+        }
+
+        while (pos < length) {
+            size_t lineEnd = pos;
+            while (lineEnd < length && text[lineEnd] != '\n' && text[lineEnd] != '\r') {
+                lineEnd++;
+            }
+
+            size_t start = pos;
+            size_t end = lineEnd;
+            while (start < end && (text[start] == ' ' || text[start] == '\t')) start++;
+            while (end > start && (text[end - 1] == ' ' || text[end - 1] == '\t')) end--;
+
+            pos = lineEnd;
+            while (pos < length && (text[pos] == '\n' || text[pos] == '\r')) {
+                pos++;
+            }
+
+            if (start == end || text[start] == ';' || text[start] == '#') {
+                continue; // Empty line or comment
+            }
+
+            if (text[start] == '[') {
+                size_t close = start + 1;
+                while (close < end && text[close] != ']') close++;
+
+                size_t nameStart = start + 1;
+                size_t nameEnd = close;
+                while (nameStart < nameEnd && (text[nameStart] == ' ' || text[nameStart] == '\t')) nameStart++;
+                while (nameEnd > nameStart && (text[nameEnd - 1] == ' ' || text[nameEnd - 1] == '\t')) nameEnd--;
+
+                current = &sections[sectionKey(std::string(&text[0] + nameStart, nameEnd - nameStart))];
+                continue;
+            }
+
+            if (!current) {
+                continue; // Keys before the first section belong to no plugin
+            }
+
+            size_t equals = start;
+            while (equals < end && text[equals] != '=') equals++;
+            if (equals == end) {
+                continue; // Not a key line
+            }
+
+            size_t keyEnd = equals;
+            while (keyEnd > start && (text[keyEnd - 1] == ' ' || text[keyEnd - 1] == '\t')) keyEnd--;
+
+            addValue(*current, std::string(&text[0] + start, keyEnd - start),
+                     std::string(&text[0] + equals + 1, end - equals - 1));
+        }
+    }
+
+    /**
+     * @brief Appends a length-prefixed string to a cache buffer.
+     * @param out The cache buffer.
+     * @param text The string.
+     */
+    void putString(std::string& out, const std::string& text) {
+        uint32_t size = static_cast<uint32_t>(text.size());
+        out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.append(text);
+    }
+
+    /**
+     * @brief Appends a 32-bit value to a cache buffer.
+     * @param out The cache buffer.
+     * @param value The value.
+     */
+    void putUInt(std::string& out, uint32_t value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    /**
+     * @brief Bounds-checked reader over a loaded cache file.
+     */
+    struct CacheReader {
+        const std::vector<char>& data;
+        size_t pos;
+
+        bool getUInt(uint32_t& value) {
+            if (data.size() - pos < sizeof(value)) return false;
+            memcpy(&value, &data[pos], sizeof(value));
+            pos += sizeof(value);
+            return true;
+        }
+
+        bool getString(std::string& text) {
+            uint32_t size = 0;
+            if (!getUInt(size) || data.size() - pos < size) return false;
+            text.assign(size ? &data[pos] : "", size);
+            pos += size;
+            return true;
+        }
+    };
+
+    /**
+     * @brief Loads the sections from the compiled cache.
+     * @param stamp The stamp of the current DynRPG.ini.
+     * @return False if the cache is missing, damaged or belongs to another version of the INI.
+     */
+    bool readCache(const IniStamp& stamp) {
+        std::vector<char> data;
+        if (!readFile(IC_CACHE_PATH, data)) {
+            return false;
+        }
+
+        CacheReader reader = { data, 0 };
+        uint32_t magic = 0, version = 0, sectionCount = 0;
+        IniStamp cached;
+        if (!reader.getUInt(magic) || magic != IC_MAGIC ||
+            !reader.getUInt(version) || version != IC_VERSION ||
+            !reader.getUInt(cached.sizeLow) || !reader.getUInt(cached.sizeHigh) ||
+            !reader.getUInt(cached.timeLow) || !reader.getUInt(cached.timeHigh) ||
+            memcmp(&cached, &stamp, sizeof(stamp)) != 0 ||
+            !reader.getUInt(sectionCount)) {
+            return false;
+        }
+
+        std::map<std::string, Section> result;
+        for (uint32_t s = 0; s < sectionCount; s++) {
+            std::string name;
+            uint32_t keyCount = 0;
+            if (!reader.getString(name) || !reader.getUInt(keyCount)) {
+                return false;
+            }
+
+            Section& section = result[name];
+            for (uint32_t k = 0; k < keyCount; k++) {
+                std::string key, value;
+                if (!reader.getString(key) || !reader.getString(value)) {
+                    return false;
+                }
+                addValue(section, key, value);
+            }
+        }
+
+        sections.swap(result);
+        return true;
+    }
+
+    /**
+     * @brief Writes the sections to the compiled cache.
+     * @param stamp The stamp of the DynRPG.ini the sections were parsed from.
+     * @note The cache is written to a temporary file first and then moved into
+     *       place, so other plugins never read a partially written cache.
+     */
+    void writeCache(const IniStamp& stamp) {
+        std::string out;
+        putUInt(out, IC_MAGIC);
+        putUInt(out, IC_VERSION);
+        putUInt(out, stamp.sizeLow);
+        putUInt(out, stamp.sizeHigh);
+        putUInt(out, stamp.timeLow);
+        putUInt(out, stamp.timeHigh);
+        putUInt(out, static_cast<uint32_t>(sections.size()));
+
+        for (std::map<std::string, Section>::const_iterator it = sections.begin(); it != sections.end(); ++it) {
+            putString(out, it->first);
+            putUInt(out, static_cast<uint32_t>(it->second.values.size()));
+            for (std::map<std::string, std::string>::const_iterator kv = it->second.values.begin();
+                 kv != it->second.values.end(); ++kv) {
+                putString(out, kv->first);
+                putString(out, kv->second);
+            }
+        }
+
+        std::string tempPath = std::string(IC_CACHE_PATH) + ".tmp";
+        FILE* file = fopen(tempPath.c_str(), "wb");
+        if (!file) {
+            return;
+        }
+        bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+        ok = (fclose(file) == 0) && ok;
+
+        if (!ok || !MoveFileExA(tempPath.c_str(), IC_CACHE_PATH, MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileA(tempPath.c_str());
+        }
+    }
+
+    /**
+     * @brief Loads DynRPG.ini once, from the compiled cache if it is current.
+     */
+    void ensureLoaded() {
+        if (loaded) {
+            return;
+        }
+        loaded = true;
+
+        IniStamp stamp;
+        if (!readIniStamp(stamp)) {
+            return; // No INI, every section is empty
+        }
+
+        loadedFromCache = readCache(stamp);
+        if (!loadedFromCache) {
+            sections.clear();
+
+            std::vector<char> text;
+            if (readFile(IC_INI_PATH, text)) {
+                parseIni(text);
+            }
+
+            std::map<std::string, Section>::const_iterator cacheConfig = sections.find("configcache");
+            if (cacheConfig != sections.end() && cacheConfig->second.getBool("Enabled", false)) {
+                writeCache(stamp);
+            } else {
+                DeleteFileA(IC_CACHE_PATH); // Drop a cache the INI no longer asks for
+            }
+        }
+
+        for (std::map<std::string, Section>::iterator it = sections.begin(); it != sections.end(); ++it) {
+            buildIndex(it->second);
+        }
+    }
+
+    /**
+     * @brief Gets a parsed section.
+     * @param name The section name (case-insensitive).
+     * @return The section, or an empty section if it does not exist.
+     */
+    const Section& getSection(const char* name) {
+        ensureLoaded();
+        std::map<std::string, Section>::const_iterator it = sections.find(sectionKey(name));
+        return (it != sections.end()) ? it->second : emptySection;
+    }
+
+    /**
+     * @brief Checks whether DynRPG.ini has a section.
+     * @param name The section name (case-insensitive).
+     * @return True if the section exists, even if it has no keys.
+     */
+    bool hasSection(const char* name) {
+        ensureLoaded();
+        return sections.find(sectionKey(name)) != sections.end();
+    }
+
+    /**
+     * @brief Drop-in replacement for RPG::loadConfiguration.
+     * @param name The section name (case-insensitive).
+     * @return A copy of all keys of the section.
+     */
+    std::map<std::string, std::string> loadConfiguration(const char* name) {
+        return getSection(name).values;
+    }
+} // namespace IniCache
+
+#endif // DYNRPG_COMMON_INI_CACHE_CPP
@@ -0,0 +1,58 @@
+/**
+ * @file party_snapshot.cpp
+ * @brief Per-frame party snapshot shared by the DynRPG plugins.
+ * @details The suite build captures the four party slots once at the start of
+ *          its onFrame dispatch, so every module called in that frame reads the
+ *          same actor pointers instead of resolving RPG::Actor::partyMember
+ *          again. Outside a captured frame, and in the standalone plugins,
+ *          member() reads the party directly.
+ */
+
+#ifndef DYNRPG_COMMON_PARTY_SNAPSHOT_CPP
+#define DYNRPG_COMMON_PARTY_SNAPSHOT_CPP
+
+/**
+ * @namespace PartySnapshot
+ * @brief Party slots captured for one frame.
+ */
+namespace PartySnapshot
+{
+    /** @brief Number of party slots in RPG Maker 2003. */
+    const int PS_PARTY_SIZE = 4;
+
+    /** @brief Actor in each party slot, nullptr for an empty slot. */
+    static RPG::Actor* members[PS_PARTY_SIZE] = {};
+
+    /** @brief Tracks whether members holds the party of the current frame. */
+    static bool captured = false;
+
+    /**
+     * @brief Reads the party slots for the current frame.
+     * @note The party must not change until release() is called, so the
+     *       snapshot is only held while the frame callbacks run.
+     */
+    void capture() {
+        for (int i = 0; i < PS_PARTY_SIZE; ++i) {
+            members[i] = RPG::Actor::partyMember(i);
+        }
+        captured = true;
+    }
+
+    /**
+     * @brief Ends the captured frame; member() reads the party directly again.
+     */
+    void release() {
+        captured = false;
+    }
+
+    /**
+     * @brief Gets the actor in a party slot.
+     * @param index Party slot (0-3).
+     * @return The actor, or nullptr if the slot is empty.
+     */
+    inline RPG::Actor* member(int index) {
+        return captured ? members[index] : RPG::Actor::partyMember(index);
+    }
+} // namespace PartySnapshot
+
+#endif // DYNRPG_COMMON_PARTY_SNAPSHOT_CPP
@@ -0,0 +1,325 @@
+/**
+ * @file profiler.cpp
+ * @brief Opt-in callback latency profiler shared by the DynRPG plugins.
+ * @details Every exported callback in a plugin's main.cpp opens a
+ *          Profiler::Scope, which times the call with QueryPerformanceCounter
+ *          and adds it to a fixed histogram. Profiling is switched on for all
+ *          plugins with
+ *          @code
+ *          [Profiler]
+ *          Enabled=true
+ *          OverlaySwitchId=0
+ *          WriteCsv=true
+ *          @endcode
+ *          While the overlay switch is ON, each plugin draws min/avg/p99/max and
+ *          its share of the 60 fps frame budget on screen. With WriteCsv the same
+ *          numbers are written to <plugin>_profile.csv on exit. When the section
+ *          is missing, a Scope costs a single branch.
+ */
+
+#ifndef DYNRPG_COMMON_PROFILER_CPP
+#define DYNRPG_COMMON_PROFILER_CPP
+
+#include <stdint.h>   // For fixed-size counters
+#include <stdio.h>    // For CSV output and overlay text
+#include <string.h>   // For memset
+#include <string>     // For the plugin name
+#include <windows.h>  // For QueryPerformanceCounter
+
+#include "ini_cache.cpp"
+
+/**
+ * @namespace Profiler
+ * @brief Per-callback latency statistics.
+ */
+namespace Profiler
+{
+    /** @brief Profiled callbacks. */
+    enum Callback {
+        PC_ON_FRAME,
+        PC_ON_SET_VARIABLE,
+        PC_ON_COMMENT,
+        PC_ON_DO_BATTLER_ACTION,
+        PC_ON_BATTLER_ACTION_DONE,
+        PC_ON_DRAW_BATTLE_STATUS_WINDOW,
+        PC_ON_DRAW_BATTLE_ACTION_WINDOW,
+        PC_ON_INIT_FINISHED,
+        PC_ON_NEW_GAME,
+        PC_ON_LOAD_GAME,
+        PC_COUNT
+    };
+
+    /** @brief Callback names, indexed by Callback. */
+    static const char* const callbackNames[PC_COUNT] = {
+        "onFrame",
+        "onSetVariable",
+        "onComment",
+        "onDoBattlerAction",
+        "onBattlerActionDone",
+        "onDrawBattleStatusWindow",
+        "onDrawBattleActionWindow",
+        "onInitFinished",
+        "onNewGame",
+        "onLoadGame"
+    };
+
+    /**
+     * @brief Number of histogram buckets.
+     * @details Durations are bucketed in nanoseconds with four buckets per power
+     *          of two, which keeps every bucket within 25% of its value up to ~4 s.
+     */
+    const int PF_BUCKET_COUNT = 128;
+
+    /** @brief Frame budget of the 60 fps game loop in nanoseconds. */
+    const double PF_FRAME_BUDGET_NS = 1000000000.0 / 60.0;
+
+    /** @brief Frames between overlay text refreshes. */
+    const int PF_OVERLAY_REFRESH = 30;
+
+    /** @brief Height of one overlay text line in pixels. */
+    const int PF_OVERLAY_LINE_HEIGHT = 12;
+
+    /** @brief Timing statistics of one callback. */
+    struct Stats {
+        uint32_t calls;                        ///< Number of timed calls
+        uint64_t totalNs;                      ///< Sum of all durations
+        uint64_t minNs;                        ///< Shortest call
+        uint64_t maxNs;                        ///< Longest call
+        uint32_t buckets[PF_BUCKET_COUNT];     ///< Duration histogram
+    };
+
+    /** @brief Statistics, indexed by Callback. */
+    static Stats stats[PC_COUNT];
+
+    /** @brief Tracks whether profiling is enabled. */
+    static bool enabled = false;
+
+    /** @brief Switch that shows the overlay, 0 for no overlay. */
+    static int overlaySwitchId = 0;
+
+    /** @brief Top edge of this plugin's overlay block. */
+    static int overlayY = 0;
+
+    /** @brief Tracks whether the statistics are written to CSV on exit. */
+    static bool writeCsv = false;
+
+    /** @brief Name of the profiled plugin. */
+    static std::string pluginName;
+
+    /** @brief QueryPerformanceCounter ticks per nanosecond. */
+    static double ticksPerNs = 0.0;
+
+    /** @brief Overlay text image, created on first use. */
+    static RPG::Image* overlayImage = nullptr;
+
+    /** @brief Frames until the overlay text is redrawn. */
+    static int overlayCountdown = 0;
+
+    /**
+     * @brief Reads the performance counter.
+     * @return The current tick count.
+     */
+    inline int64_t now() {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    /**
+     * @brief Maps a duration to its histogram bucket.
+     * @param ns The duration in nanoseconds.
+     * @return The bucket index.
+     */
+    int bucketFor(uint64_t ns) {
+        if (ns < 4) {
+            return static_cast<int>(ns);
+        }
+        int msb = 63;
+        while (!(ns >> msb)) {
+            --msb;
+        }
+        int bucket = 4 + (msb - 2) * 4 + static_cast<int>((ns >> (msb - 2)) & 3);
+        return (bucket < PF_BUCKET_COUNT) ? bucket : PF_BUCKET_COUNT - 1;
+    }
+
+    /**
+     * @brief Gets the smallest duration of the next bucket.
+     * @param bucket The bucket index.
+     * @return The exclusive upper bound of the bucket in nanoseconds.
+     */
+    uint64_t bucketUpperBound(int bucket) {
+        int next = bucket + 1;
+        if (next < 4) {
+            return static_cast<uint64_t>(next);
+        }
+        int msb = (next - 4) / 4 + 2;
+        uint64_t mantissa = 4 + (next - 4) % 4;
+        return mantissa << (msb - 2);
+    }
+
+    /**
+     * @brief Adds one timed call to the statistics.
+     * @param callback The callback.
+     * @param ticks The duration in performance counter ticks.
+     */
+    void record(Callback callback, int64_t ticks) {
+        uint64_t ns = (ticks > 0) ? static_cast<uint64_t>(ticks / ticksPerNs) : 0;
+        Stats& s = stats[callback];
+        if (s.calls == 0 || ns < s.minNs) s.minNs = ns;
+        if (ns > s.maxNs) s.maxNs = ns;
+        s.calls++;
+        s.totalNs += ns;
+        s.buckets[bucketFor(ns)]++;
+    }
+
+    /**
+     * @brief Estimates the 99th percentile of a callback.
+     * @param s The statistics.
+     * @return The upper bound of the bucket holding the 99th percentile, clamped
+     *         to the longest call.
+     */
+    uint64_t percentile99(const Stats& s) {
+        uint32_t rank = s.calls - s.calls / 100;
+        uint32_t seen = 0;
+        for (int i = 0; i < PF_BUCKET_COUNT; ++i) {
+            seen += s.buckets[i];
+            if (seen >= rank) {
+                uint64_t bound = bucketUpperBound(i);
+                return (bound < s.maxNs) ? bound : s.maxNs;
+            }
+        }
+        return s.maxNs;
+    }
+
+    /**
+     * @brief Times one callback for as long as the scope lives.
+     * @note Used at the top of each exported callback in main.cpp.
+     */
+    class Scope {
+    public:
+        explicit Scope(Callback timedCallback) : callback(timedCallback), start(enabled ? now() : 0) {}
+        ~Scope() {
+            if (enabled) {
+                record(callback, now() - start);
+            }
+        }
+
+    private:
+        Callback callback;
+        int64_t start;
+    };
+
+    /**
+     * @brief Reads the [Profiler] section and starts profiling if enabled.
+     * @param name The plugin's DynRPG.ini section name, used for output.
+     * @details The overlay block of each plugin is placed with ProfilerOverlayY in
+     *          the plugin's own section, so several plugins can share the screen.
+     */
+    void start(const char* name) {
+        const IniCache::Section& config = IniCache::getSection("Profiler");
+        enabled = config.getBool("Enabled", false);
+        if (!enabled) {
+            return;
+        }
+
+        overlaySwitchId = config.getInt("OverlaySwitchId", 0);
+        writeCsv = config.getBool("WriteCsv", true);
+        overlayY = IniCache::getSection(name).getInt("ProfilerOverlayY", 0);
+        pluginName = name;
+
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        ticksPerNs = static_cast<double>(frequency.QuadPart) / 1000000000.0;
+        memset(stats, 0, sizeof(stats));
+    }
+
+    /**
+     * @brief Gets the average callback time per frame as a share of the frame budget.
+     * @return The percentage, 0 before the first frame.
+     */
+    double frameBudgetPercent() {
+        if (stats[PC_ON_FRAME].calls == 0) {
+            return 0.0;
+        }
+        uint64_t total = 0;
+        for (int i = 0; i < PC_COUNT; ++i) {
+            total += stats[i].totalNs;
+        }
+        return 100.0 * total / stats[PC_ON_FRAME].calls / PF_FRAME_BUDGET_NS;
+    }
+
+    /**
+     * @brief Redraws the overlay text image.
+     */
+    void renderOverlay() {
+        if (!overlayImage) {
+            overlayImage = RPG::Image::create(320, PF_OVERLAY_LINE_HEIGHT * (PC_COUNT + 1));
+            overlayImage->useMaskColor = true;
+        }
+        overlayImage->clear();
+
+        char line[96];
+        snprintf(line, sizeof(line), "%s %.2f%% frame", pluginName.c_str(), frameBudgetPercent());
+        overlayImage->drawText(0, 0, line, 0);
+
+        int y = PF_OVERLAY_LINE_HEIGHT;
+        for (int i = 0; i < PC_COUNT; ++i) {
+            const Stats& s = stats[i];
+            if (!s.calls) continue;
+            snprintf(line, sizeof(line), "%s avg %.1f p99 %.1f max %.1fus",
+                     callbackNames[i], s.totalNs / 1000.0 / s.calls,
+                     percentile99(s) / 1000.0, s.maxNs / 1000.0);
+            overlayImage->drawText(0, y, line, 0);
+            y += PF_OVERLAY_LINE_HEIGHT;
+        }
+    }
+
+    /**
+     * @brief Draws the overlay while the overlay switch is ON.
+     * @note Called from onDrawScreen. The text is only redrawn every
+     *       PF_OVERLAY_REFRESH frames; drawing the overlay is not profiled.
+     */
+    void drawOverlay() {
+        if (!enabled || overlaySwitchId <= 0 || !RPG::switches[overlaySwitchId]) {
+            overlayCountdown = 0;
+            return;
+        }
+
+        if (overlayCountdown <= 0) {
+            renderOverlay();
+            overlayCountdown = PF_OVERLAY_REFRESH;
+        }
+        --overlayCountdown;
+        RPG::screen->canvas->draw(0, overlayY, overlayImage);
+    }
+
+    /**
+     * @brief Writes <plugin>_profile.csv and frees the overlay.
+     * @note Called from onExit.
+     */
+    void stop() {
+        if (enabled && writeCsv) {
+            std::string path = pluginName + "_profile.csv";
+            FILE* file = fopen(path.c_str(), "w");
+            if (file) {
+                fprintf(file, "callback,calls,min_us,avg_us,p99_us,max_us,total_ms\n");
+                for (int i = 0; i < PC_COUNT; ++i) {
+                    const Stats& s = stats[i];
+                    if (!s.calls) continue;
+                    fprintf(file, "%s,%u,%.3f,%.3f,%.3f,%.3f,%.3f\n", callbackNames[i],
+                            (unsigned int)s.calls, s.minNs / 1000.0, s.totalNs / 1000.0 / s.calls,
+                            percentile99(s) / 1000.0, s.maxNs / 1000.0, s.totalNs / 1000000.0);
+                }
+                fprintf(file, "frame_budget_percent,%.3f\n", frameBudgetPercent());
+                fclose(file);
+            }
+        }
+
+        if (overlayImage) {
+            RPG::Image::destroy(overlayImage);
+        }
+        enabled = false;
+    }
+} // namespace Profiler
+
+#endif // DYNRPG_COMMON_PROFILER_CPP
@@ -0,0 +1,176 @@
+/**
+ * @file sprite_timeline.cpp
+ * @brief Precomputed sprite-sheet animation shared by the DynRPG plugins.
+ * @details A Timeline is built once when a layer image is loaded. It holds the
+ *          source rectangle of every frame in the sheet and, for every
+ *          animation state (e.g. gauge unfilled / filled), one step per
+ *          tick: the frame sequence, with each frame repeated for the
+ *          animation speed. A Player walks through a timeline one tick per
+ *          draw, so advancing an animation is an index increment and the
+ *          source rectangle is read from the step instead of recomputed.
+ *
+ *          When the requested state changes, the switch happens at the next
+ *          frame change: playback continues in the new state's sequence after
+ *          the position of the shown frame (or from its start if the shown
+ *          frame is not part of it).
+ */
+
+#ifndef DYNRPG_COMMON_SPRITE_TIMELINE_CPP
+#define DYNRPG_COMMON_SPRITE_TIMELINE_CPP
+
+#include <stddef.h>   // For size_t
+#include <vector>     // For frames and steps
+
+/**
+ * @namespace SpriteTimeline
+ * @brief Frame timelines for animated sprite sheets.
+ */
+namespace SpriteTimeline
+{
+    /** @brief Source rectangle of one frame in the sprite sheet. */
+    struct Frame {
+        int index;   ///< Frame number in the sheet
+        int srcX;    ///< Left edge in the sheet
+        int srcY;    ///< Top edge in the sheet
+        int width;   ///< Frame width
+        int height;  ///< Frame height
+    };
+
+    /** @brief Frame shown during one tick of a state. */
+    struct Step {
+        Frame frame;       ///< The shown frame
+        bool startsFrame;  ///< Whether the frame changes on this tick
+    };
+
+    /** @brief Precomputed animation of one sprite sheet. */
+    struct Timeline {
+        int period;                                ///< Ticks each frame is shown
+        std::vector<Frame> frames;                 ///< Every frame of the sheet, by index
+        std::vector<std::vector<Step> > states;    ///< Steps of each state, one per tick
+        std::vector<std::vector<size_t> > resume;  ///< Per state and frame index: position of the frame
+                                                   ///< in the state's sequence, 0 if it is not part of it
+
+        /** @brief Whether the timeline has no frames to show. */
+        bool empty() const { return frames.empty(); }
+
+        /** @brief Removes all frames and states. */
+        void clear() {
+            frames.clear();
+            states.clear();
+            resume.clear();
+            period = 1;
+        }
+    };
+
+    /**
+     * @brief Builds a timeline for a sheet of equally sized frames.
+     * @param timeline The timeline to build.
+     * @param frameCount Number of frames in the sheet.
+     * @param frameWidth Width of one frame.
+     * @param frameHeight Height of one frame.
+     * @param sideBySide True if the frames are laid out left to right,
+     *        false if they are stacked top to bottom.
+     * @param sequences Frame sequence of every state. An empty sequence plays
+     *        all frames in order; indices outside the sheet are skipped.
+     * @param period Ticks each frame is shown (at least 1).
+     * @note Leaves the timeline empty if the frame size is not positive.
+     */
+    void build(Timeline& timeline, int frameCount, int frameWidth, int frameHeight, bool sideBySide,
+               const std::vector<const std::vector<int>*>& sequences, int period) {
+        timeline.clear();
+        if (frameCount <= 0 || frameWidth <= 0 || frameHeight <= 0) {
+            return;
+        }
+        timeline.period = period > 0 ? period : 1;
+
+        for (int i = 0; i < frameCount; ++i) {
+            Frame frame = { i, sideBySide ? i * frameWidth : 0, sideBySide ? 0 : i * frameHeight,
+                            frameWidth, frameHeight };
+            timeline.frames.push_back(frame);
+        }
+
+        timeline.states.resize(sequences.size());
+        timeline.resume.resize(sequences.size());
+        for (size_t state = 0; state < sequences.size(); ++state) {
+            std::vector<int> sequence;
+            if (sequences[state]) {
+                for (size_t i = 0; i < sequences[state]->size(); ++i) {
+                    int index = (*sequences[state])[i];
+                    if (index >= 0 && index < frameCount) sequence.push_back(index);
+                }
+            }
+            if (sequence.empty()) {
+                for (int i = 0; i < frameCount; ++i) sequence.push_back(i);
+            }
+
+            std::vector<size_t>& resume = timeline.resume[state];
+            resume.assign(frameCount, 0);
+            for (size_t i = sequence.size(); i-- > 0; ) {
+                resume[sequence[i]] = i;
+            }
+
+            std::vector<Step>& steps = timeline.states[state];
+            steps.reserve(sequence.size() * timeline.period);
+            for (size_t i = 0; i < sequence.size(); ++i) {
+                for (int tick = 0; tick < timeline.period; ++tick) {
+                    Step step = { timeline.frames[sequence[i]], tick == 0 };
+                    steps.push_back(step);
+                }
+            }
+        }
+    }
+
+    /** @brief Playback position in a timeline. */
+    class Player {
+    public:
+        Player() : timeline(nullptr), state(0), tick(0) {
+            Frame none = { 0, 0, 0, 0, 0 };
+            shown = none;
+        }
+
+        /**
+         * @brief Starts playback at frame 0 in state 0.
+         * @param source The timeline to play, nullptr or empty to show nothing.
+         */
+        void reset(const Timeline* source) {
+            timeline = (source && !source->empty() && !source->states.empty()) ? source : nullptr;
+            state = 0;
+            Frame none = { 0, 0, 0, 0, 0 };
+            shown = timeline ? timeline->frames[0] : none;
+            tick = timeline ? timeline->resume[0][0] * timeline->period : 0;
+        }
+
+        /**
+         * @brief Advances playback by one tick.
+         * @param requested The state to play; applied at the next frame change.
+         */
+        void advance(int requested) {
+            if (!timeline) return;
+            const std::vector<Step>* steps = &timeline->states[state];
+            if (++tick == steps->size()) tick = 0;
+            if (!(*steps)[tick].startsFrame) return;
+
+            if (requested != state && requested >= 0 && static_cast<size_t>(requested) < timeline->states.size()) {
+                state = requested;
+                steps = &timeline->states[state];
+                size_t frames = steps->size() / timeline->period;
+                tick = ((timeline->resume[state][shown.index] + 1) % frames) * timeline->period;
+            }
+            shown = (*steps)[tick].frame;
+        }
+
+        /** @brief Whether a frame is shown. */
+        bool active() const { return timeline != nullptr; }
+
+        /** @brief The shown frame. */
+        const Frame& frame() const { return shown; }
+
+    private:
+        const Timeline* timeline;
+        int state;
+        size_t tick;
+        Frame shown;
+    };
+} // namespace SpriteTimeline
+
+#endif // DYNRPG_COMMON_SPRITE_TIMELINE_CPP
@@ -0,0 +1,569 @@
+/**
+ * @file trace_recorder.cpp
+ * @brief Opt-in binary trace of DynRPG callbacks for deterministic replay.
+ * @details Every exported callback in a plugin's main.cpp opens a
+ *          TraceRecorder::Call. While recording is enabled with
+ *          @code
+ *          [Trace]
+ *          Enabled=true
+ *          WatchVariables=10-13,30
+ *          @endcode
+ *          each call is written to <plugin>_trace.bin as:
+ *          - deltas of the game state the plugins read (party, monsters,
+ *            battle command selection, watched variables)
+ *          - the callback and its arguments
+ *          - deltas of the same state after the call, which are the plugin's outputs
+ *          - the return value, the duration of the call and the values the
+ *            callback wrote through pointer arguments
+ *
+ *          All numbers are zigzag varints and state records only carry changed
+ *          fields, so a quiet map frame costs about six bytes (callback type
+ *          and scene, then the result type, return value and a two or three
+ *          byte duration). The benchmark's replay
+ *          mode reads the file back, feeds the calls to the plugin outside the
+ *          game and compares its outputs and timings.
+ */
+
+#ifndef DYNRPG_COMMON_TRACE_RECORDER_CPP
+#define DYNRPG_COMMON_TRACE_RECORDER_CPP
+
+#include <stdint.h>   // For fixed-size fields
+#include <stdio.h>    // For the trace file
+#include <stdlib.h>   // For strtol
+#include <string.h>   // For memcmp, memcpy, memset, strlen
+#include <string>     // For names and paths
+#include <vector>     // For the watched variables
+#include <windows.h>  // For QueryPerformanceCounter
+
+#include "ini_cache.cpp"
+
+/**
+ * @namespace TraceRecorder
+ * @brief Trace file format, state capture and the recording writer.
+ */
+namespace TraceRecorder
+{
+    /** @brief File magic, "DRTR" in little endian. */
+    const uint32_t TR_MAGIC = 0x52545244;
+
+    /** @brief File format version. */
+    const uint32_t TR_VERSION = 2;
+
+    /** @brief Size of the write buffer in bytes. */
+    const size_t TR_BUFFER_SIZE = 1 << 16;
+
+    /** @brief Party slots captured per call. */
+    const int TR_PARTY_SLOTS = 4;
+
+    /** @brief Monster slots captured per call. */
+    const int TR_MONSTER_SLOTS = 8;
+
+    /** @brief Battle commands captured per actor. */
+    const int TR_COMMAND_SLOTS = 7;
+
+    /** @brief Record types. */
+    enum RecordType {
+        // Callbacks, followed by their arguments
+        TR_FRAME = 1,                       ///< scene
+        TR_SET_VARIABLE,                    ///< id, value
+        TR_COMMENT,                         ///< command, parameters
+        TR_DO_BATTLER_ACTION,               ///< battler, firstTry
+        TR_BATTLER_ACTION_DONE,             ///< battler, success
+        TR_DRAW_BATTLE_STATUS_WINDOW,       ///< x, selection, selActive, isTargetSelection, isVisible
+        TR_DRAW_BATTLE_ACTION_WINDOW,       ///< x, y, selection, selActive, isVisible
+        TR_INIT_FINISHED,
+        TR_NEW_GAME,
+        TR_LOAD_GAME,                       ///< id, length
+        TR_CALLBACK_LAST = TR_LOAD_GAME,
+
+        // State deltas, followed by slot, field mask and changed fields
+        TR_STATE_ACTOR = 32,
+        TR_STATE_MONSTER,
+        TR_STATE_BATTLE,
+        TR_STATE_VARIABLES,                 ///< count, then watch index and value pairs
+
+        TR_RESULT = 48                      ///< return value, duration in ns, then outputCount() outputs
+    };
+
+    /** @brief Fields captured for a party slot. */
+    enum ActorField {
+        AF_PRESENT, AF_ID, AF_HP, AF_MAX_HP,
+        AF_WEAPON, AF_SHIELD, AF_ARMOR, AF_HELMET, AF_ACCESSORY, AF_TWO_WEAPONS,
+        AF_ACTION_KIND, AF_ACTION_BASIC, AF_ACTION_SKILL, AF_ACTION_TARGET, AF_ACTION_TARGET_ID,
+        AF_COMMANDS,
+        AF_COUNT = AF_COMMANDS + TR_COMMAND_SLOTS
+    };
+
+    /** @brief Fields captured for a monster slot. */
+    enum MonsterField {
+        MF_PRESENT, MF_ID, MF_HP, MF_MAX_HP,
+        MF_ACTION_KIND, MF_ACTION_BASIC, MF_ACTION_SKILL, MF_ACTION_TARGET, MF_ACTION_TARGET_ID,
+        MF_COUNT
+    };
+
+    /** @brief Fields captured for the battle windows. */
+    enum BattleField {
+        BF_PRESENT,         ///< Battle data and command window exist
+        BF_CURRENT_HERO,    ///< Party slot of the current hero, -1 for none
+        BF_COMMAND,         ///< Selected command window entry
+        BF_COUNT
+    };
+
+    /** @brief Game state the plugins read and write. */
+    struct State {
+        int actors[TR_PARTY_SLOTS][AF_COUNT];
+        int monsters[TR_MONSTER_SLOTS][MF_COUNT];
+        int battle[BF_COUNT];
+        std::vector<int> variables;     ///< Values of the watched variables
+    };
+
+    /** @brief Watched variable IDs, in watch index order. */
+    static std::vector<int> watchedVariables;
+
+    /** @brief Tracks whether recording is enabled. */
+    static bool enabled = false;
+
+    /** @brief Trace file. */
+    static FILE* file = nullptr;
+
+    /** @brief Pending bytes not yet written to the file. */
+    static unsigned char buffer[TR_BUFFER_SIZE];
+    static size_t bufferUsed = 0;
+
+    /** @brief State as of the last record, deltas are taken against it. */
+    static State lastState;
+
+    /** @brief Scratch state captured for each record. */
+    static State currentState;
+
+    /** @brief QueryPerformanceCounter ticks per nanosecond. */
+    static double ticksPerNs = 0.0;
+
+    /**
+     * @brief Writes the buffered bytes to the file.
+     */
+    void flush() {
+        if (file && bufferUsed) {
+            fwrite(buffer, 1, bufferUsed, file);
+        }
+        bufferUsed = 0;
+    }
+
+    /**
+     * @brief Appends one byte to the buffer.
+     * @param byte The byte.
+     */
+    inline void putByte(unsigned char byte) {
+        if (bufferUsed == TR_BUFFER_SIZE) {
+            flush();
+        }
+        buffer[bufferUsed++] = byte;
+    }
+
+    /**
+     * @brief Appends a signed number as a zigzag varint.
+     * @param value The number.
+     */
+    void putInt(int64_t value) {
+        uint64_t zigzag = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        while (zigzag >= 0x80) {
+            putByte(static_cast<unsigned char>(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        putByte(static_cast<unsigned char>(zigzag));
+    }
+
+    /**
+     * @brief Appends a length-prefixed string.
+     * @param text The string.
+     */
+    void putString(const char* text) {
+        size_t length = strlen(text);
+        putInt(static_cast<int64_t>(length));
+        for (size_t i = 0; i < length; ++i) {
+            putByte(static_cast<unsigned char>(text[i]));
+        }
+    }
+
+    /**
+     * @brief Stores an action into captured fields.
+     * @param action The action, may be null.
+     * @param fields First of the five action fields.
+     */
+    void captureAction(const RPG::Action* action, int* fields) {
+        if (!action) {
+            memset(fields, 0, 5 * sizeof(int));
+            return;
+        }
+        fields[0] = action->kind;
+        fields[1] = action->basicActionId;
+        fields[2] = action->skillId;
+        fields[3] = action->target;
+        fields[4] = action->targetId;
+    }
+
+    /**
+     * @brief Reads the current game state.
+     * @param state Receives the state; its variables must be sized to the watch list.
+     */
+    void captureState(State& state) {
+        memset(state.actors, 0, sizeof(state.actors));
+        memset(state.monsters, 0, sizeof(state.monsters));
+
+        for (int slot = 0; slot < TR_PARTY_SLOTS; ++slot) {
+            RPG::Actor* actor = RPG::Actor::partyMember(slot);
+            if (!actor) continue;
+
+            int* fields = state.actors[slot];
+            fields[AF_PRESENT] = 1;
+            fields[AF_ID] = actor->id;
+            fields[AF_HP] = actor->hp;
+            fields[AF_MAX_HP] = actor->getMaxHp();
+            fields[AF_WEAPON] = actor->weaponId;
+            fields[AF_SHIELD] = actor->shieldId;
+            fields[AF_ARMOR] = actor->armorId;
+            fields[AF_HELMET] = actor->helmetId;
+            fields[AF_ACCESSORY] = actor->accessoryId;
+            fields[AF_TWO_WEAPONS] = actor->twoWeapons ? 1 : 0;
+            captureAction(actor->action, &fields[AF_ACTION_KIND]);
+            if (actor->battleCommands) {
+                for (int i = 0; i < TR_COMMAND_SLOTS; ++i) {
+                    fields[AF_COMMANDS + i] = actor->battleCommands[i];
+                }
+            }
+        }
+
+        int monsterCount = RPG::monsters.count();
+        for (int slot = 0; slot < TR_MONSTER_SLOTS && slot < monsterCount; ++slot) {
+            RPG::Monster* monster = RPG::monsters[slot];
+            if (!monster) continue;
+
+            int* fields = state.monsters[slot];
+            fields[MF_PRESENT] = 1;
+            fields[MF_ID] = monster->id;
+            fields[MF_HP] = monster->hp;
+            fields[MF_MAX_HP] = monster->getMaxHp();
+            captureAction(monster->action, &fields[MF_ACTION_KIND]);
+        }
+
+        memset(state.battle, 0, sizeof(state.battle));
+        state.battle[BF_CURRENT_HERO] = -1;
+        if (RPG::battleData && RPG::battleData->winCommand) {
+            state.battle[BF_PRESENT] = 1;
+            state.battle[BF_COMMAND] = RPG::battleData->winCommand->getSelected();
+            for (int slot = 0; slot < TR_PARTY_SLOTS; ++slot) {
+                RPG::Actor* actor = RPG::Actor::partyMember(slot);
+                if (actor && static_cast<RPG::Battler*>(actor) == RPG::battleData->currentHero) {
+                    state.battle[BF_CURRENT_HERO] = slot;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < watchedVariables.size(); ++i) {
+            state.variables[i] = RPG::variables[watchedVariables[i]];
+        }
+    }
+
+    /**
+     * @brief Writes the changed fields of one state block.
+     * @param type The state record type.
+     * @param slot The slot of the block.
+     * @param current The current fields.
+     * @param last The fields as of the last record, updated in place.
+     * @param count Number of fields.
+     */
+    void putFieldDelta(RecordType type, int slot, const int* current, int* last, int count) {
+        uint32_t mask = 0;
+        for (int i = 0; i < count; ++i) {
+            if (current[i] != last[i]) mask |= 1u << i;
+        }
+        if (!mask) return;
+
+        putByte(static_cast<unsigned char>(type));
+        putInt(slot);
+        putInt(mask);
+        for (int i = 0; i < count; ++i) {
+            if (mask & (1u << i)) {
+                putInt(current[i]);
+                last[i] = current[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Captures the game state and writes everything that changed.
+     */
+    void putStateDelta() {
+        captureState(currentState);
+
+        for (int slot = 0; slot < TR_PARTY_SLOTS; ++slot) {
+            putFieldDelta(TR_STATE_ACTOR, slot, currentState.actors[slot], lastState.actors[slot], AF_COUNT);
+        }
+        for (int slot = 0; slot < TR_MONSTER_SLOTS; ++slot) {
+            putFieldDelta(TR_STATE_MONSTER, slot, currentState.monsters[slot], lastState.monsters[slot], MF_COUNT);
+        }
+        putFieldDelta(TR_STATE_BATTLE, 0, currentState.battle, lastState.battle, BF_COUNT);
+
+        int changed = 0;
+        for (size_t i = 0; i < watchedVariables.size(); ++i) {
+            if (currentState.variables[i] != lastState.variables[i]) ++changed;
+        }
+        if (changed) {
+            putByte(TR_STATE_VARIABLES);
+            putInt(changed);
+            for (size_t i = 0; i < watchedVariables.size(); ++i) {
+                if (currentState.variables[i] != lastState.variables[i]) {
+                    putInt(static_cast<int64_t>(i));
+                    putInt(currentState.variables[i]);
+                    lastState.variables[i] = currentState.variables[i];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Parses a list of variable IDs and ranges such as "10-13,30".
+     * @param text The list.
+     * @param ids Receives the IDs.
+     */
+    void parseIdList(const std::string& text, std::vector<int>& ids) {
+        const char* p = text.c_str();
+        while (*p) {
+            char* end = nullptr;
+            long first = strtol(p, &end, 10);
+            if (end == p) {
+                ++p;
+                continue;
+            }
+            long last = first;
+            p = end;
+            if (*p == '-') {
+                last = strtol(p + 1, &end, 10);
+                p = end;
+            }
+            for (long id = first; id <= last && id - first < 10000; ++id) {
+                if (id > 0) ids.push_back(static_cast<int>(id));
+            }
+        }
+    }
+
+    /**
+     * @brief Resets the delta base so the next record carries the full state.
+     * @details Slots start as "absent" and the battle block as "no battle",
+     *          which is also what the replay assumes before the first record.
+     */
+    void resetState(State& state) {
+        memset(state.actors, 0, sizeof(state.actors));
+        memset(state.monsters, 0, sizeof(state.monsters));
+        memset(state.battle, 0, sizeof(state.battle));
+        state.battle[BF_CURRENT_HERO] = -1;
+        state.variables.assign(watchedVariables.size(), 0);
+    }
+
+    /**
+     * @brief Reads the [Trace] section and opens the trace file if enabled.
+     * @param name The plugin's DynRPG.ini section name, stored in the trace header.
+     */
+    void start(const char* name) {
+        const IniCache::Section& config = IniCache::getSection("Trace");
+        if (!config.getBool("Enabled", false)) {
+            return;
+        }
+
+        watchedVariables.clear();
+        const std::string* watch = config.find("WatchVariables");
+        if (watch) {
+            parseIdList(*watch, watchedVariables);
+        }
+
+        std::string path = std::string(name) + "_trace.bin";
+        file = fopen(path.c_str(), "wb");
+        if (!file) {
+            return;
+        }
+
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        ticksPerNs = static_cast<double>(frequency.QuadPart) / 1000000000.0;
+
+        bufferUsed = 0;
+        putInt(TR_MAGIC);
+        putInt(TR_VERSION);
+        putString(name);
+        putInt(static_cast<int64_t>(watchedVariables.size()));
+        for (size_t i = 0; i < watchedVariables.size(); ++i) {
+            putInt(watchedVariables[i]);
+        }
+
+        resetState(lastState);
+        resetState(currentState);
+        enabled = true;
+    }
+
+    /**
+     * @brief Flushes and closes the trace file.
+     * @note Called from onExit.
+     */
+    void stop() {
+        if (!enabled) {
+            return;
+        }
+        flush();
+        fclose(file);
+        file = nullptr;
+        enabled = false;
+    }
+
+    /**
+     * @brief Gets the trace reference of a battler.
+     * @param battler The battler.
+     * @return The party slot for actors, TR_PARTY_SLOTS plus the monster slot
+     *         for monsters, -1 if the battler is in neither.
+     */
+    int battlerRef(RPG::Battler* battler) {
+        if (!battler) return -1;
+        if (battler->isMonster()) {
+            int count = RPG::monsters.count();
+            for (int slot = 0; slot < TR_MONSTER_SLOTS && slot < count; ++slot) {
+                if (static_cast<RPG::Battler*>(RPG::monsters[slot]) == battler) return TR_PARTY_SLOTS + slot;
+            }
+        } else {
+            for (int slot = 0; slot < TR_PARTY_SLOTS; ++slot) {
+                if (static_cast<RPG::Battler*>(RPG::Actor::partyMember(slot)) == battler) return slot;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Gets the number of integer arguments of a callback record.
+     * @param type The callback record type.
+     * @return The argument count; comments and battler actions are encoded separately.
+     */
+    inline int argumentCount(RecordType type) {
+        switch (type) {
+            case TR_FRAME: return 1;
+            case TR_SET_VARIABLE: return 2;
+            case TR_DO_BATTLER_ACTION: return 2;
+            case TR_BATTLER_ACTION_DONE: return 2;
+            case TR_DRAW_BATTLE_STATUS_WINDOW: return 5;
+            case TR_DRAW_BATTLE_ACTION_WINDOW: return 5;
+            case TR_LOAD_GAME: return 2;
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief Gets the number of values a callback returns through pointer arguments.
+     * @param type The callback record type.
+     * @return The output count, written after the return value of TR_RESULT.
+     */
+    inline int outputCount(RecordType type) {
+        switch (type) {
+            case TR_DRAW_BATTLE_ACTION_WINDOW: return 2;   // *x, *y
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief Records one callback for as long as the object lives.
+     * @details The constructor writes the state before the call and the
+     *          callback's arguments, the destructor writes the state after the
+     *          call, the return value and the duration.
+     * @note Used at the top of each exported callback in main.cpp; return
+     *       values are passed through result(), pointer arguments the
+     *       callback may change are registered with outputs().
+     */
+    class Call {
+    public:
+        explicit Call(RecordType type, int a = 0, int b = 0, int c = 0, int d = 0, int e = 0)
+            : active(enabled), type(type), returned(1), start(0) {
+            outputValues[0] = outputValues[1] = nullptr;
+            if (!active) return;
+            begin(type);
+            int args[5] = { a, b, c, d, e };
+            for (int i = 0; i < argumentCount(type); ++i) {
+                putInt(args[i]);
+            }
+            start = now();
+        }
+
+        Call(RecordType type, RPG::Battler* battler, bool flag) : active(enabled), type(type), returned(1), start(0) {
+            outputValues[0] = outputValues[1] = nullptr;
+            if (!active) return;
+            begin(type);
+            putInt(battlerRef(battler));
+            putInt(flag ? 1 : 0);
+            start = now();
+        }
+
+        explicit Call(const RPG::ParsedCommentData* parsedData) : active(enabled), type(TR_COMMENT), returned(1), start(0) {
+            outputValues[0] = outputValues[1] = nullptr;
+            if (!active) return;
+            begin(TR_COMMENT);
+            putString(parsedData->command);
+            putInt(parsedData->parametersCount);
+            for (int i = 0; i < parsedData->parametersCount; ++i) {
+                const RPG::ParsedCommentParameter& parameter = parsedData->parameters[i];
+                int64_t bits;
+                memcpy(&bits, &parameter.number, sizeof(bits));
+                putInt(parameter.type);
+                putInt(bits);
+                putString(parameter.text);
+            }
+            start = now();
+        }
+
+        ~Call() {
+            if (!active || !enabled) return;
+            int64_t duration = now() - start;
+            putStateDelta();
+            putByte(TR_RESULT);
+            putInt(returned);
+            putInt(static_cast<int64_t>(duration / ticksPerNs));
+            for (int i = 0; i < outputCount(type); ++i) {
+                putInt(outputValues[i] ? *outputValues[i] : 0);
+            }
+        }
+
+        /**
+         * @brief Registers the pointer arguments whose values are recorded after the call.
+         * @param first First output (x of onDrawBattleActionWindow).
+         * @param second Second output (y of onDrawBattleActionWindow).
+         */
+        void outputs(int* first, int* second) {
+            outputValues[0] = first;
+            outputValues[1] = second;
+        }
+
+        /**
+         * @brief Records the callback's return value.
+         * @param value The value returned to DynRPG.
+         * @return The same value.
+         */
+        bool result(bool value) {
+            returned = value ? 1 : 0;
+            return value;
+        }
+
+    private:
+        bool active;
+        RecordType type;
+        int returned;
+        int* outputValues[2];
+        int64_t start;
+
+        static int64_t now() {
+            LARGE_INTEGER counter;
+            QueryPerformanceCounter(&counter);
+            return counter.QuadPart;
+        }
+
+        static void begin(RecordType type) {
+            putStateDelta();
+            putByte(static_cast<unsigned char>(type));
+        }
+    };
+} // namespace TraceRecorder
+
+#endif // DYNRPG_COMMON_TRACE_RECORDER_CPP
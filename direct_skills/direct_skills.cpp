@@ -7,6 +7,7 @@
 
 #include "direct_skills_debug.cpp"
 #include "direct_skills_config.cpp"
+#include "../common/party_snapshot.cpp"
 
 /**
  * @namespace DirectSkills
@@ -20,71 +21,159 @@ namespace DirectSkills
     /** @brief Tracks whether the current action has been replaced. */
     bool actionReplaced = false;
 
-    /** @brief Tracks whether a default skill is being used. */
-    bool usingDefaultSkill = false;
+    /** @brief Number of party slots in battle (max 4 in RPG Maker 2003). */
+    static const int MAX_PARTY_SLOTS = 4;
 
-    /** @brief Variable ID being used for skill lookup. */
-    int variableId = 0;
-
-    /** @brief Invalid value found in the variable. */
-    int invalidVariableValue = 0;
+    /**
+     * @brief Command selection state of one party slot.
+     * @details Replaces per-actor maps, so storing and finding a command
+     *          never allocates or walks a tree.
+     */
+    struct SlotCommandState {
+        int actorId;          ///< Actor the command belongs to, 0 if none
+        int commandId;        ///< Command ID used by onDoBattlerAction, 0 if none
+        int loggedCommandId;  ///< Last command ID written to the debug output
+    };
 
-    /** @brief Default skill ID being used as fallback. */
-    int defaultSkillId = 0;
+    /** @brief Highest battle command ID that can be mapped to a skill. */
+    static const int MAX_COMMAND_ID = 100;
 
-    /** @brief Tracks the last logged command for each actor to prevent duplicate debug output. */
-    static std::map<int,int> lastLoggedCommandMap;
+    /**
+     * @brief Ready-made action replacement for one battle command.
+     * @details Built once at battle start, so replacing an attack only needs
+     *          one table read. Variable-backed entries are rebuilt when their
+     *          variable changes, or when the action finds the variable changed
+     *          without onSetVariable.
+     */
+    struct ActionTemplate {
+        bool mapped;               ///< The command has a skill mapping
+        RPG::ActionKind kind;      ///< AK_SKILL if attacks are replaced, AK_BASIC if no valid skill
+        int skillId;               ///< Skill used instead of the attack
+        RPG::Target target;        ///< Action target derived from the skill target
+        bool targetSelf;           ///< The acting actor is the target
+        int variableId;            ///< Variable containing the skill ID, 0 for fixed mappings
+        int variableValue;         ///< Variable value the entry was built from
+        bool usingDefaultSkill;    ///< The variable is invalid and the default skill is used
+        int invalidVariableValue;  ///< Invalid value found in the variable
+    };
+
+    /** @brief Action templates indexed by battle command ID. */
+    static ActionTemplate actionTemplates[MAX_COMMAND_ID + 1];
+
+    /** @brief Command IDs whose mapping is backed by a variable. */
+    static std::vector<int> variableCommandIds;
+
+    /** @brief Tracks whether the action templates have been built. */
+    static bool actionTemplatesBuilt = false;
+
+    /** @brief Tracks whether the previous frame was a battle frame. */
+    static bool inBattle = false;
 
     /**
-     * @brief Resolves the actual skill ID for a given battle command.
-     * @param commandId The battle command ID to look up.
-     * @return The skill ID to use, or 0 if not found.
+     * @brief Builds the action template of one battle command.
+     * @param commandId The battle command ID (1 to MAX_COMMAND_ID).
+     * @param variableValue Current value of the command's variable, ignored for fixed mappings.
      * @details Handles both direct skill mappings and variable-based mappings:
      *          - Positive stored values indicate direct skill IDs
      *          - Negative stored values indicate variable IDs containing skill IDs
      * @note For variable-based mappings, if the variable contains an invalid value,
-     *       the function will attempt to use a configured default skill ID.
+     *       the configured default skill ID is used.
      * @see DirectSkillsConfig::commandToSkillMap
      * @see DirectSkillsConfig::defaultSkillMap
      */
-    int getSkillIdForCommand(int commandId) {
-        // Reset tracking variables for default skill handling
-        usingDefaultSkill = false;
-        variableId = 0;
-        invalidVariableValue = 0;
-        defaultSkillId = 0;
+    void compileActionTemplate(int commandId, int variableValue) {
+        ActionTemplate& entry = actionTemplates[commandId];
+        entry = ActionTemplate();
 
         auto it = DirectSkillsConfig::commandToSkillMap.find(commandId);
         if (it == DirectSkillsConfig::commandToSkillMap.end()) {
-            return 0; // Command not mapped to any skill
+            return; // Command not mapped to any skill
         }
+        entry.mapped = true;
 
+        int skillId = 0;
         int value = it->second;
         if (value > 0) {
-            return value; // Direct skill ID mapping
+            skillId = value; // Direct skill ID mapping
         } else if (value < 0) {
             // Convert negative value back to positive variable ID
-            int varId = -value;
-            int variableValue = RPG::variables[varId];
+            entry.variableId = -value;
+            entry.variableValue = variableValue;
 
             if (variableValue > 0) {
-                return variableValue; // Valid skill ID from variable
+                skillId = variableValue; // Valid skill ID from variable
             } else {
                 // Attempt to use default skill ID for invalid variable value
                 auto defaultIt = DirectSkillsConfig::defaultSkillMap.find(commandId);
                 if (defaultIt != DirectSkillsConfig::defaultSkillMap.end()) {
-                    // Store invalid variable information for debug output
-                    usingDefaultSkill = true;
-                    variableId = varId;
-                    invalidVariableValue = variableValue;
-                    defaultSkillId = defaultIt->second;
-
-                    return defaultSkillId;
+                    entry.usingDefaultSkill = true;
+                    entry.invalidVariableValue = variableValue;
+                    skillId = defaultIt->second;
                 }
             }
         }
 
-        return 0; // No valid skill ID found
+        RPG::Skill* skill = (skillId > 0) ? RPG::skills[skillId] : nullptr;
+        if (!skill) {
+            return; // No valid skill ID found
+        }
+
+        entry.kind = RPG::AK_SKILL;
+        entry.skillId = skillId;
+
+        // Convert skill target to action target
+        switch (skill->target) {
+            case RPG::SKILL_TARGET_ENEMY:
+                entry.target = RPG::TARGET_MONSTER;
+                break;
+            case RPG::SKILL_TARGET_ALL_ENEMIES:
+                entry.target = RPG::TARGET_ALL_MONSTERS;
+                break;
+            case RPG::SKILL_TARGET_SELF:
+                entry.target = RPG::TARGET_ACTOR;
+                entry.targetSelf = true; // Target self
+                break;
+            case RPG::SKILL_TARGET_ALLY:
+                entry.target = RPG::TARGET_ACTOR;
+                break;
+            case RPG::SKILL_TARGET_ALL_ALLIES:
+                entry.target = RPG::TARGET_ALL_ACTORS;
+                break;
+            default:
+                // Fallback to monster target if unknown
+                entry.target = RPG::TARGET_MONSTER;
+                break;
+        }
+    }
+
+    /**
+     * @brief Builds the action templates of all battle commands.
+     * @details Called at battle start, when the skill database is available.
+     *          Also collects the variable-backed commands for onSetVariable.
+     * @note onFrame resets the per-battle command tracking (resetBattleState)
+     *       right after this call at battle start.
+     */
+    void buildActionTemplates() {
+        variableCommandIds.clear();
+
+        for (int cmdId = 1; cmdId <= MAX_COMMAND_ID; cmdId++) {
+            auto it = DirectSkillsConfig::commandToSkillMap.find(cmdId);
+            int variableValue = 0;
+            if (it != DirectSkillsConfig::commandToSkillMap.end() && it->second < 0) {
+                variableValue = RPG::variables[-it->second];
+                variableCommandIds.push_back(cmdId);
+            }
+            compileActionTemplate(cmdId, variableValue);
+        }
+
+        actionTemplatesBuilt = true;
+
+        if (DirectSkillsConfig::enableDebugBattle && Debug::enableConsole) {
+            std::cout << "[DirectSkills - Debug Info]" << std::endl;
+            std::cout << "Action templates built for battle" << std::endl;
+            std::cout << "Variable-based mappings: " << variableCommandIds.size() << std::endl;
+            std::cout << std::endl;
+        }
     }
 
     /**
@@ -99,7 +188,7 @@ namespace DirectSkills
      */
     bool onStartup(char *pluginName) {
         // Load configuration from DynRPG.ini
-        std::map<std::string, std::string> configuration = RPG::loadConfiguration(pluginName);
+        std::map<std::string, std::string> configuration = IniCache::loadConfiguration(pluginName);
 
         // Configure debug console based on settings
         Debug::enableConsole = false;
@@ -109,6 +198,7 @@ namespace DirectSkills
 
         // Initialize debug console if enabled
         if (Debug::enableConsole) {
+            Debug::loadOutputSettings(configuration);
             Debug::initConsole();
         }
 
@@ -127,27 +217,95 @@ namespace DirectSkills
     /** @brief Tracks the last selected command index. */
     static int lastSelectedCommand = -1;
 
-    /** @brief Stores the actual command ID of the selected command for each actor. */
-    static std::map<int, int> actorCommandMap;
+    /** @brief Tracks the last active battler to detect battler changes. */
+    static RPG::Battler* lastActiveBattler = nullptr;
 
-    /** @brief Tracks the last active actor to detect actor changes. */
-    static int lastActiveActorId = -1;
+    /** @brief Stores the actual command ID of the selected command for each party slot. */
+    static SlotCommandState slotCommands[MAX_PARTY_SLOTS] = {};
 
-    /** @brief Tracks whether command selection has been initialized. */
-    static bool selectionInitialized = false;
+    /**
+     * @brief Forgets the commands and selection tracked in the previous battle.
+     * @details The party may have been reordered or changed between battles,
+     *          so stored slot commands could otherwise be resolved for an actor
+     *          that is now in another slot.
+     */
+    void resetBattleState() {
+        lastSelectedCommand = -1;
+        lastActiveBattler = nullptr;
+        for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+            slotCommands[i] = SlotCommandState();
+        }
+    }
+
+    /**
+     * @brief Finds the command state of an actor.
+     * @param actorId The actor ID to look up.
+     * @return The slot state, or nullptr if no command is stored for the actor.
+     */
+    SlotCommandState* findSlotCommand(int actorId) {
+        for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+            if (slotCommands[i].actorId == actorId && slotCommands[i].commandId > 0) {
+                return &slotCommands[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Gets the name of a battle command for debug output.
+     * @param commandId The battle command ID.
+     * @param fallback Name returned if the command has no name.
+     * @return The command name or the fallback.
+     */
+    std::string getCommandName(int commandId, const char* fallback) {
+        int commandIndex = commandId - 1;
+        if (RPG::battleSettings && commandIndex >= 0 && commandIndex < 100 &&
+            RPG::battleSettings->battleCommands[commandIndex] &&
+            RPG::battleSettings->battleCommands[commandIndex]->name) {
+            return RPG::battleSettings->battleCommands[commandIndex]->name.s_str();
+        }
+        return fallback;
+    }
+
+    /**
+     * @brief Finds the party slot of an actor.
+     * @param actor The actor to look up.
+     * @return The party slot index (0-3), or -1 if the actor is not in the party.
+     */
+    int findPartySlot(RPG::Actor* actor) {
+        for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+            if (PartySnapshot::member(i) == actor) {
+                return i;
+            }
+        }
+        return -1;
+    }
 
     /**
      * @brief Processes frame updates during battle.
      * @param scene The current game scene.
      * @details Tracks the selected command in the battle command window
      *          and stores the actual command ID when a valid selection is made.
-     *          Maintains separate command storage for each actor and prevents
+     *          Maintains separate command storage for each party slot and prevents
      *          duplicate debug output by tracking previously logged commands.
-     * @note Only processes updates during battle scenes.
+     * @note Only processes updates during battle scenes, and only when the
+     *       active battler or the selected command index changed.
+     *       Builds the action templates and resets the command tracking on
+     *       the first battle frame.
      */
     void onFrame(RPG::Scene scene) {
         // Only process updates during battle scenes
-        if (scene != RPG::SCENE_BATTLE) return;
+        if (scene != RPG::SCENE_BATTLE) {
+            inBattle = false;
+            return;
+        }
+
+        // Build the action templates and reset command tracking once at battle start
+        if (!inBattle) {
+            inBattle = true;
+            buildActionTemplates();
+            resetBattleState();
+        }
 
         // Ensure battle data and the command window exist
         if (!(RPG::battleData && RPG::battleData->winCommand)) return;
@@ -156,8 +314,18 @@ namespace DirectSkills
         RPG::Battler* battler = RPG::battleData->currentHero;
         if (!battler) return;
 
+        // Which "slot" in the command window is selected?
+        int currentSelection = RPG::battleData->winCommand->getSelected();
+
+        // Nothing to do unless the battler or the selection changed
+        if (battler == lastActiveBattler && currentSelection == lastSelectedCommand) return;
+
         // If it's a monster, do nothing
-        if (battler->isMonster()) return;
+        if (battler->isMonster()) {
+            lastActiveBattler = battler;
+            lastSelectedCommand = currentSelection;
+            return;
+        }
 
         // Now we know it's an actor; cast so we can read battleCommands[]
         RPG::Actor* currentActor = reinterpret_cast<RPG::Actor*>(battler);
@@ -166,10 +334,10 @@ namespace DirectSkills
         // If battleCommands pointer is still null, wait for next frame
         if (!currentActor->battleCommands) return;
 
-        // Which "slot" in the command window is selected?
-        int currentSelection = RPG::battleData->winCommand->getSelected();
         if (currentSelection < 0 || currentSelection >= 4) {
             // No valid selection index (e.g. command window closed or out of range)
+            lastActiveBattler = battler;
+            lastSelectedCommand = currentSelection;
             return;
         }
 
@@ -180,43 +348,40 @@ namespace DirectSkills
             return;
         }
 
-        // At this point, we have a "real" commandId (> 0)
+        // At this point, we have a "real" commandId (> 0), remember the pair
+        lastActiveBattler = battler;
+        lastSelectedCommand = currentSelection;
+
+        int slotIndex = findPartySlot(currentActor);
+        if (slotIndex < 0) return;
+
         int actorId = currentActor->id;
+        SlotCommandState& slot = slotCommands[slotIndex];
 
-        // Always update the map so onDoBattlerAction() sees it
-        actorCommandMap[actorId] = commandId;
+        // A different actor took over this slot, forget what was logged for the old one
+        if (slot.actorId != actorId) {
+            slot.actorId = actorId;
+            slot.loggedCommandId = 0;
+        }
 
-        // Only log to console if this is a new command for this actor
-        int prevLogged = 0;
-        auto itLogged = lastLoggedCommandMap.find(actorId);
-        if (itLogged != lastLoggedCommandMap.end()) {
-            prevLogged = itLogged->second;
+        // Store the command so onDoBattlerAction() sees it
+        slot.commandId = commandId;
+
+        // The actor may have moved from another slot, drop its stale command there
+        for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+            if (i != slotIndex && slotCommands[i].actorId == actorId) {
+                slotCommands[i] = SlotCommandState();
+            }
         }
 
-        if (prevLogged != commandId) {
+        // Only log to console if this is a new command for this actor
+        if (slot.loggedCommandId != commandId) {
             // Debug output (once per actual change)
-            if (DirectSkillsConfig::enableDebugBattle && Debug::enableConsole) {
-                std::cout << "[DirectSkills - Debug Info]" << std::endl;
-                std::cout << "Command Selected in Frame:" << std::endl;
-                std::cout << "  Actor ID:      " << actorId << std::endl;
-                std::cout << "  Command Index: " << currentSelection << std::endl;
-                std::cout << "  Command ID:    " << commandId << std::endl;
-
-                // Optionally show the name
-                int commandIndex = commandId - 1;
-                if (RPG::battleSettings &&
-                    commandIndex >= 0 && commandIndex < 100 &&
-                    RPG::battleSettings->battleCommands[commandIndex] &&
-                    RPG::battleSettings->battleCommands[commandIndex]->name)
-                {
-                    std::string cmdName = RPG::battleSettings
-                                              ->battleCommands[commandIndex]
-                                              ->name.s_str();
-                    std::cout << "  Command Name:  " << cmdName << std::endl;
-                }
-                std::cout << std::endl;
-            }
-            lastLoggedCommandMap[actorId] = commandId;
+            ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                       "Command Selected in Frame:\n  Actor ID:      %d\n  Command Index: %d\n"
+                       "  Command ID:    %d\n  Command Name:  %s",
+                       actorId, currentSelection, commandId, getCommandName(commandId, "").c_str());
+            slot.loggedCommandId = commandId;
         }
     }
 
@@ -230,7 +395,7 @@ namespace DirectSkills
      *          Uses the stored command mapping instead of current selection
      *          to prevent timing issues.
      * @note Only processes actor actions on their first attempt.
-     * @see getSkillIdForCommand
+     * @see buildActionTemplates
      */
     bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
         // Skip processing for non-first attempts and monster actions
@@ -258,112 +423,107 @@ namespace DirectSkills
         }
 
         // Check if we have a stored command selection for this actor
-        auto commandIt = actorCommandMap.find(actor->id);
-        if (commandIt != actorCommandMap.end()) {
-            int storedCommandId = commandIt->second;
+        SlotCommandState* storedCommand = findSlotCommand(actor->id);
+        if (storedCommand) {
+            int storedCommandId = storedCommand->commandId;
 
             // Output debug information for current state
-            if (DirectSkillsConfig::enableDebugBattle && Debug::enableConsole) {
-                std::cout << "[DirectSkills - Debug Info]" << std::endl;
-                std::cout << "Processing Action for Actor" << actor->id << std::endl;
-                std::cout << "Stored Command ID: " << storedCommandId << std::endl;
-
-                // Display current battleCommands state for debugging
-                std::cout << "Current battleCommands state:" << std::endl;
-                if (actor->battleCommands) {
-                    for (int i = 0; i < 4; i++) {
-                        std::cout << "  Index " << i << ": Command ID " << actor->battleCommands[i] << std::endl;
-                    }
-                } else {
-                    std::cout << "  battleCommands is NULL!" << std::endl;
-                }
-                std::cout << std::endl;
+            if (actor->battleCommands) {
+                ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                           "Processing Action for Actor%d\nStored Command ID: %d\nCurrent battleCommands state:\n"
+                           "  Index 0: Command ID %d\n  Index 1: Command ID %d\n"
+                           "  Index 2: Command ID %d\n  Index 3: Command ID %d",
+                           actor->id, storedCommandId, actor->battleCommands[0], actor->battleCommands[1],
+                           actor->battleCommands[2], actor->battleCommands[3]);
+            } else {
+                ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                           "Processing Action for Actor%d\nStored Command ID: %d\nCurrent battleCommands state:\n"
+                           "  battleCommands is NULL!",
+                           actor->id, storedCommandId);
             }
 
-            // Check if the stored command is mapped to a skill
-            if (DirectSkillsConfig::commandToSkillMap.find(storedCommandId) !=
-                DirectSkillsConfig::commandToSkillMap.end()) {
-
-                int skillId = getSkillIdForCommand(storedCommandId);
+            // Look up the prepared replacement for the stored command
+            const ActionTemplate* entry = nullptr;
+            if (storedCommandId > 0 && storedCommandId <= MAX_COMMAND_ID) {
+                if (!actionTemplatesBuilt) {
+                    buildActionTemplates();
+                }
+                entry = &actionTemplates[storedCommandId];
 
-                if (skillId > 0) {
-                    RPG::Skill* skill = RPG::skills[skillId];
+                // Direct variable writes (e.g. other plugins) skip onSetVariable
+                if (entry->variableId > 0 && RPG::variables[entry->variableId] != entry->variableValue) {
+                    compileActionTemplate(storedCommandId, RPG::variables[entry->variableId]);
+                }
+            }
 
+            // Check if the stored command is mapped to a skill
+            if (entry && entry->mapped) {
+                if (entry->kind == RPG::AK_SKILL) {
                     // Output debug information for action replacement
-                    if (DirectSkillsConfig::enableDebugBattle && Debug::enableConsole) {
-                        std::string cmdName = "Unknown";
-                        int commandIndex = storedCommandId - 1;
-                        if (RPG::battleSettings && commandIndex >= 0 && commandIndex < 100 &&
-                            RPG::battleSettings->battleCommands[commandIndex]) {
-                            if (RPG::battleSettings->battleCommands[commandIndex]->name) {
-                                cmdName = RPG::battleSettings->battleCommands[commandIndex]->name.s_str();
-                            }
-                        }
-
-                        std::cout << "[DirectSkills - Debug Info]" << std::endl;
-                        std::cout << "Action Swapped for Actor" << actor->id << std::endl;
-                        std::cout << "Battle Command ID: " << storedCommandId << " (" << cmdName << ")" << std::endl;
-
-                        if (usingDefaultSkill) {
-                            std::cout << "Variable " << variableId << " contains invalid value: " << invalidVariableValue << std::endl;
-                            std::cout << "Using default skill ID: " << skillId << std::endl;
-                        } else {
-                            std::cout << "Skill ID: " << skillId << std::endl;
-                        }
-                        std::cout << std::endl;
+                    if (entry->usingDefaultSkill) {
+                        ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                                   "Action Swapped for Actor%d\nBattle Command ID: %d (%s)\n"
+                                   "Variable %d contains invalid value: %d\nUsing default skill ID: %d",
+                                   actor->id, storedCommandId, getCommandName(storedCommandId, "Unknown").c_str(),
+                                   entry->variableId, entry->invalidVariableValue, entry->skillId);
+                    } else {
+                        ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                                   "Action Swapped for Actor%d\nBattle Command ID: %d (%s)\nSkill ID: %d",
+                                   actor->id, storedCommandId, getCommandName(storedCommandId, "Unknown").c_str(),
+                                   entry->skillId);
                     }
 
                     // Replace basic attack with configured skill
-                    action->kind = RPG::AK_SKILL;
-                    action->skillId = skillId;
-
-
-                    // Convert skill target to action target
-                    switch (skill->target) {
-                        case RPG::SKILL_TARGET_ENEMY:
-                            action->target = RPG::TARGET_MONSTER;
-                            break;
-                        case RPG::SKILL_TARGET_ALL_ENEMIES:
-                            action->target = RPG::TARGET_ALL_MONSTERS;
-                            break;
-                        case RPG::SKILL_TARGET_SELF:
-                            action->target = RPG::TARGET_ACTOR;
-                            action->targetId = actor->id; // Target self
-                            break;
-                        case RPG::SKILL_TARGET_ALLY:
-                            action->target = RPG::TARGET_ACTOR;
-                            break;
-                        case RPG::SKILL_TARGET_ALL_ALLIES:
-                            action->target = RPG::TARGET_ALL_ACTORS;
-                            break;
-                        default:
-                            // Fallback to monster target if unknown
-                            action->target = RPG::TARGET_MONSTER;
-                            break;
+                    action->kind = entry->kind;
+                    action->skillId = entry->skillId;
+                    action->target = entry->target;
+                    if (entry->targetSelf) {
+                        action->targetId = actor->id; // Target self
                     }
 
                     return true;
                 }
             } else {
                 // Output debug information for unmapped command
-                if (DirectSkillsConfig::enableDebugBattle && Debug::enableConsole) {
-                    std::cout << "[DirectSkills - Debug Info]" << std::endl;
-                    std::cout << "No Mapping Found for Actor" << actor->id << std::endl;
-                    std::cout << "Stored Command ID: " << storedCommandId << std::endl;
-                    std::cout << "This command is not in the skill mapping." << std::endl;
-                    std::cout << std::endl;
-                }
+                ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                           "No Mapping Found for Actor%d\nStored Command ID: %d\nThis command is not in the skill mapping.",
+                           actor->id, storedCommandId);
             }
         } else {
-            // Output debug information for no stored command
-            if (DirectSkillsConfig::enableDebugBattle && Debug::enableConsole) {
-                std::cout << "[DirectSkills - Debug Info]" << std::endl;
-                std::cout << "No Stored Command for Actor" << actor->id << std::endl;
-                std::cout << "Available stored commands:" << std::endl;
-                for (const auto& pair : actorCommandMap) {
-                    std::cout << "  Actor " << pair.first << ": Command ID " << pair.second << std::endl;
-                }
-                std::cout << std::endl;
+            // Output debug information for no stored command (command ID 0 = none)
+            ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                       "No Stored Command for Actor%d\nStored commands by party slot:\n"
+                       "  Slot 0: Actor %d, Command ID %d\n  Slot 1: Actor %d, Command ID %d\n"
+                       "  Slot 2: Actor %d, Command ID %d\n  Slot 3: Actor %d, Command ID %d",
+                       actor->id, slotCommands[0].actorId, slotCommands[0].commandId,
+                       slotCommands[1].actorId, slotCommands[1].commandId,
+                       slotCommands[2].actorId, slotCommands[2].commandId,
+                       slotCommands[3].actorId, slotCommands[3].commandId);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Processes variable changes to keep variable-based templates current.
+     * @param id Variable ID being changed.
+     * @param value New value of the variable.
+     * @return True to allow the change.
+     * @details Rebuilds the action template of every command whose skill ID
+     *          is read from this variable. Other variables cost one short loop.
+     *          onDoBattlerAction still compares the cached value, since direct
+     *          writes to RPG::variables do not come through here.
+     * @note The new value is passed in because the variable is not yet updated.
+     */
+    bool onSetVariable(int id, int value) {
+        if (!actionTemplatesBuilt) {
+            return true; // Templates are built from the current values at battle start
+        }
+
+        for (size_t i = 0; i < variableCommandIds.size(); i++) {
+            int cmdId = variableCommandIds[i];
+            if (actionTemplates[cmdId].variableId == id) {
+                compileActionTemplate(cmdId, value);
             }
         }
 
@@ -386,12 +546,9 @@ namespace DirectSkills
             if (actor) {
                 // Do nothing here  allow command mapping to persist across turns
                 // It will be updated when a new command is selected in onFrame()
-                if (DirectSkillsConfig::enableDebugBattle && Debug::enableConsole) {
-                    std::cout << "[DirectSkills - Debug Info]" << std::endl;
-                    std::cout << "Action completed for Actor " << actor->id << std::endl;
-                    std::cout << "Command mapping retained for now (not cleared)." << std::endl;
-                    std::cout << std::endl;
-                }
+                ASYNC_LOGF(DirectSkillsConfig::enableDebugBattle && Debug::enableConsole, "DirectSkills - Debug Info",
+                           "Action completed for Actor %d\nCommand mapping retained for now (not cleared).",
+                           actor->id);
             }
         }
         return true;
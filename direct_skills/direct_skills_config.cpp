@@ -5,6 +5,8 @@
  *          and debug options.
  */
 
+#include "../common/ini_cache.cpp"
+
 /**
  * @namespace DirectSkillsConfig
  * @brief Contains configuration settings and loading functionality for the DirectSkills plugin.
@@ -57,14 +59,13 @@ namespace DirectSkillsConfig
         limitBreakCommandId = 0;
         limitBreakUltimateCommandId = 0;
 
-        // Load limit_break plugin configuration
-        std::map<std::string, std::string> limitBreakConfig = RPG::loadConfiguration(const_cast<char*>("limit_break"));
+        // Read limit_break plugin configuration from the shared INI cache
+        const IniCache::Section& limitBreakConfig = IniCache::getSection("limit_break");
 
         // Parse limit break command IDs
-        if (limitBreakConfig.find("LimitCommandId") != limitBreakConfig.end()) {
-            std::string limitCmdStr = limitBreakConfig["LimitCommandId"];
+        if (const std::string* limitCmdStr = limitBreakConfig.find("LimitCommandId")) {
             try {
-                limitBreakCommandId = std::stoi(limitCmdStr);
+                limitBreakCommandId = std::stoi(*limitCmdStr);
 
                 if (enableDebugConfig && Debug::enableConsole) {
                     std::cout << "[DirectSkills - Conflict Detection]" << std::endl;
@@ -78,10 +79,9 @@ namespace DirectSkillsConfig
         }
 
         // Parse ultimate limit break command ID
-        if (limitBreakConfig.find("UltimateLimitCommandId") != limitBreakConfig.end()) {
-            std::string ultimateCmdStr = limitBreakConfig["UltimateLimitCommandId"];
+        if (const std::string* ultimateCmdStr = limitBreakConfig.find("UltimateLimitCommandId")) {
             try {
-                limitBreakUltimateCommandId = std::stoi(ultimateCmdStr);
+                limitBreakUltimateCommandId = std::stoi(*ultimateCmdStr);
 
                 if (enableDebugConfig && Debug::enableConsole) {
                     std::cout << "[DirectSkills - Conflict Detection]" << std::endl;
@@ -95,37 +95,47 @@ namespace DirectSkillsConfig
         }
 
         // Load direct_skills configuration
-        std::map<std::string, std::string> config = RPG::loadConfiguration(pluginName);
+        const IniCache::Section& config = IniCache::getSection(pluginName);
 
         // Parse debug settings
         enableDebugConfig = false;
         enableDebugBattle = false;
 
-        if (config.find("EnableDebugConfig") != config.end()) {
-            enableDebugConfig = (config["EnableDebugConfig"] == "true");
+        if (const std::string* debugConfig = config.find("EnableDebugConfig")) {
+            enableDebugConfig = (*debugConfig == "true");
         }
 
-        if (config.find("EnableDebugBattle") != config.end()) {
-            enableDebugBattle = (config["EnableDebugBattle"] == "true");
+        if (const std::string* debugBattle = config.find("EnableDebugBattle")) {
+            enableDebugBattle = (*debugBattle == "true");
         }
 
         int skippedMappings = 0;
 
+        // Collect the configured BattleCommandId<N> and BattleCommandId<N>_DefaultId keys
+        const std::string* mappingValues[101] = {};
+        const std::string* defaultValues[101] = {};
+        for (const IniCache::IndexedKey& key : config.getIndexed("BattleCommandId")) {
+            if (key.index < 1 || key.index > 100) {
+                continue;
+            }
+            if (key.suffix.empty()) {
+                mappingValues[key.index] = &key.value;
+            } else if (key.suffix == "DefaultId") {
+                defaultValues[key.index] = &key.value;
+            }
+        }
+
         // Process command-to-skill mappings for all possible command IDs
         for (int cmdId = 1; cmdId <= 100; cmdId++) {
-            // Load skill mapping configuration
-            std::string configKey = "BattleCommandId" + std::to_string(cmdId);
-            std::string value = "";
-            if (config.find(configKey) != config.end()) {
-                value = config[configKey];
+            if (!mappingValues[cmdId] && !defaultValues[cmdId]) {
+                continue; // Nothing configured for this command
             }
 
+            // Load skill mapping configuration
+            std::string value = mappingValues[cmdId] ? *mappingValues[cmdId] : "";
+
             // Load default skill ID configuration
-            std::string defaultKey = "BattleCommandId" + std::to_string(cmdId) + "_DefaultId";
-            std::string defaultValue = "";
-            if (config.find(defaultKey) != config.end()) {
-                defaultValue = config[defaultKey];
-            }
+            std::string defaultValue = defaultValues[cmdId] ? *defaultValues[cmdId] : "";
 
             // Process default skill ID configuration
             int defaultId = 0;
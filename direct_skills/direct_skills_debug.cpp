@@ -2,8 +2,12 @@
  * @file direct_skills_debug.cpp
  * @brief Debugging utilities for the DirectSkills plugin.
  * @details Provides console output functionality for debugging purposes.
+ *          Output is written through the shared asynchronous log, so debug
+ *          messages do not block the game thread.
  */
 
+#include "../common/async_log.cpp"
+
 /**
  * @namespace Debug
  * @brief Contains debugging utilities and console management functions.
@@ -16,11 +20,44 @@ namespace Debug
     /** @brief Tracks whether the console has been initialized. */
     bool consoleInitialized = false;
 
+    /** @brief Tracks whether a console window was allocated by this plugin. */
+    bool consoleAllocated = false;
+
+    /** @brief Selected debug output sinks (AsyncLog::SINK_CONSOLE and/or AsyncLog::SINK_FILE). */
+    int outputSinks = AsyncLog::SINK_CONSOLE;
+
+    /** @brief Path of the log file used by the file sink. */
+    std::string logFilePath = "direct_skills_debug.log";
+
+    /**
+     * @brief Reads the debug output settings.
+     * @param configuration The plugin's settings from DynRPG.ini.
+     * @details Reads DebugOutput (console, file or both, default console) and
+     *          DebugLogFile (default direct_skills_debug.log).
+     * @note Must be called before initConsole().
+     */
+    void loadOutputSettings(std::map<std::string, std::string>& configuration) {
+        outputSinks = AsyncLog::SINK_CONSOLE;
+        if (configuration.find("DebugOutput") != configuration.end()) {
+            const std::string& output = configuration["DebugOutput"];
+            if (output == "file") {
+                outputSinks = AsyncLog::SINK_FILE;
+            } else if (output == "both") {
+                outputSinks = AsyncLog::SINK_CONSOLE | AsyncLog::SINK_FILE;
+            }
+        }
+        if (configuration.find("DebugLogFile") != configuration.end() && !configuration["DebugLogFile"].empty()) {
+            logFilePath = configuration["DebugLogFile"];
+        }
+    }
+
     /**
      * @brief Initializes a console window for debug output.
      * @details Creates and attaches a console window to the application
      *          if one doesn't already exist. It redirects standard output and input
      *          to this console, allowing for debug messages to be displayed.
+     *          Then starts the asynchronous log for the selected sinks, which
+     *          takes over std::cout until cleanupConsole() is called.
      * @note This function is idempotent - it will only initialize the console once.
      *       Subsequent calls will have no effect until cleanupConsole() is called.
      * @warning On Windows, this uses the Win32 API's AllocConsole() function,
@@ -29,18 +66,23 @@ namespace Debug
      */
     void initConsole() {
         if (!consoleInitialized) {
-            if (AllocConsole()) {
+            if ((outputSinks & AsyncLog::SINK_CONSOLE) && AllocConsole()) {
                 // Redirect standard streams to console
                 freopen("CONOUT$", "w", stdout);
                 freopen("CONIN$", "r", stdin);
-
-                // Mark console as initialized
-                consoleInitialized = true;
+                consoleAllocated = true;
 
                 // Reset stream error states
                 std::cout.clear();
                 std::cin.clear();
             }
+
+            // Start the background writer for the available sinks
+            int sinks = (consoleAllocated ? AsyncLog::SINK_CONSOLE : 0) | (outputSinks & AsyncLog::SINK_FILE);
+            if (sinks != 0 && AsyncLog::start(sinks, logFilePath.c_str())) {
+                // Mark console as initialized
+                consoleInitialized = true;
+            }
         }
     }
 
@@ -55,15 +97,22 @@ namespace Debug
      */
     void cleanupConsole() {
         if (consoleInitialized) {
-            // Ensure all output is written
+            // Ensure all output is written; in the suite build the log and console are
+            // shared and released by the suite after every module exited
+            if (!AsyncLog::detach()) {
+                return;
+            }
             std::cout.flush();
 
-            // Close redirected streams
-            fclose(stdout);
-            fclose(stdin);
+            if (consoleAllocated) {
+                // Close redirected streams
+                fclose(stdout);
+                fclose(stdin);
 
-            // Release console resources
-            FreeConsole();
+                // Release console resources
+                FreeConsole();
+                consoleAllocated = false;
+            }
 
             // Reset initialization state
             consoleInitialized = false;
@@ -14,6 +14,7 @@
 #include <map>        // For storing configurations and state data
 #include <sstream>    // For string formatting
 #include <string>     // For text processing
+#include <vector>     // For the variable-based command list
 #include <iostream>   // For console output
 #include <stdio.h>    // For freopen
 #include <stdlib.h>   // For atoi
@@ -23,6 +24,10 @@
 // Main implementation file - contains all namespaced code
 #include "direct_skills.cpp"
 
+// Opt-in callback profiler and trace recorder
+#include "../common/profiler.cpp"
+#include "../common/trace_recorder.cpp"
+
 /**
  * @defgroup callbacks DynRPG Plugin Callbacks
  * @brief Global callback functions called by the DynRPG system
@@ -37,6 +42,8 @@
  * @see DirectSkills::onStartup
  */
 bool onStartup(char *pluginName) {
+    Profiler::start(pluginName);
+    TraceRecorder::start(pluginName);
     return DirectSkills::onStartup(pluginName);
 }
 
@@ -47,6 +54,8 @@ bool onStartup(char *pluginName) {
  */
 void onExit() {
     DirectSkills::onExit();
+    Profiler::stop();
+    TraceRecorder::stop();
 }
 
 /**
@@ -57,6 +66,8 @@ void onExit() {
  * @see DirectSkills::onFrame
  */
 void onFrame(RPG::Scene scene) {
+    TraceRecorder::Call trace(TraceRecorder::TR_FRAME, scene);
+    Profiler::Scope scope(Profiler::PC_ON_FRAME);
     DirectSkills::onFrame(scene);
 }
 
@@ -69,7 +80,23 @@ void onFrame(RPG::Scene scene) {
  * @see DirectSkills::onDoBattlerAction
  */
 bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
-    return DirectSkills::onDoBattlerAction(battler, firstTry);
+    TraceRecorder::Call trace(TraceRecorder::TR_DO_BATTLER_ACTION, battler, firstTry);
+    Profiler::Scope scope(Profiler::PC_ON_DO_BATTLER_ACTION);
+    return trace.result(DirectSkills::onDoBattlerAction(battler, firstTry));
+}
+
+/**
+ * @brief Processes variable changes during gameplay.
+ * @param id Variable ID being changed.
+ * @param value New value of the variable.
+ * @return True to allow the change.
+ * @note Keeps the action templates of variable-based mappings current.
+ * @see DirectSkills::onSetVariable
+ */
+bool onSetVariable(int id, int value) {
+    TraceRecorder::Call trace(TraceRecorder::TR_SET_VARIABLE, id, value);
+    Profiler::Scope scope(Profiler::PC_ON_SET_VARIABLE);
+    return trace.result(DirectSkills::onSetVariable(id, value));
 }
 
 /**
@@ -82,7 +109,18 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
  * @see DirectSkills::onBattlerActionDone
  */
 bool onBattlerActionDone(RPG::Battler* battler, bool success) {
-    return DirectSkills::onBattlerActionDone(battler, success);
+    TraceRecorder::Call trace(TraceRecorder::TR_BATTLER_ACTION_DONE, battler, success);
+    Profiler::Scope scope(Profiler::PC_ON_BATTLER_ACTION_DONE);
+    return trace.result(DirectSkills::onBattlerActionDone(battler, success));
+}
+
+/**
+ * @brief Called after the screen was drawn.
+ * @note Draws the profiler overlay while it is enabled and its switch is ON.
+ * @see Profiler::drawOverlay
+ */
+void onDrawScreen() {
+    Profiler::drawOverlay();
 }
 
 /** @} */ // end of callbacks group
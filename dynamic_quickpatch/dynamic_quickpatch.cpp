@@ -30,31 +30,64 @@ namespace DynamicQuickPatch
     const int DQP_INT32_MAX = std::numeric_limits<int>::max();
 
     /**
-     * @brief Map storing original memory values before patching.
-     * @details Key: memory address, Value: vector of original bytes.
-     *          Used to restore original memory state when patches are disabled.
+     * @brief A contiguous run of original bytes in the memory journal.
+     * @details Spans are kept sorted by address and coalesced, so no two spans
+     *          overlap or touch. Every original byte is stored exactly once.
      */
-    static std::map<unsigned int, std::vector<unsigned char>> originalMemoryValues;
+    struct JournalSpan {
+        unsigned int address;     ///< Address of the first original byte
+        size_t length;            ///< Number of original bytes
+        size_t offset;            ///< Offset of the bytes in journalArena
+    };
+
+    /** @brief Sorted, coalesced spans of original memory values. */
+    static std::vector<JournalSpan> journalSpans;
+    /** @brief Contiguous storage for the bytes of all journal spans. */
+    static std::vector<unsigned char> journalArena;
+    /** @brief Scratch spans used while merging a new range into the journal. */
+    static std::vector<JournalSpan> journalMergeSpans;
+    /** @brief Scratch arena used while merging a new range into the journal. */
+    static std::vector<unsigned char> journalMergeArena;
+
+    /**
+     * @brief Finds the first journal span that ends at or after an address.
+     * @param address Memory address to search for.
+     * @return Index of the span, or journalSpans.size() if there is none.
+     * @details A span that ends exactly at the address is included, so the
+     *          result is also the first candidate for coalescing.
+     */
+    size_t findJournalSpan(unsigned int address) {
+        return std::lower_bound(journalSpans.begin(), journalSpans.end(), address,
+            [](const JournalSpan& span, unsigned int addr) {
+                return span.address + span.length < addr;
+            }) - journalSpans.begin();
+    }
 
     /**
      * @brief Checks if original memory values are stored.
      * @param address Memory address to check.
      * @param length Number of bytes to check.
      * @return True if values are stored for this address range.
-     * @details Verifies if original memory values exist for the specified address
-     *          range before performing memory operations.
+     * @details Since spans are coalesced, a fully journaled range always lies
+     *          inside a single span.
      */
     bool hasOriginalValues(unsigned int address, size_t length) {
-        return originalMemoryValues.find(address) != originalMemoryValues.end() &&
-               originalMemoryValues[address].size() >= length;
+        size_t index = findJournalSpan(address);
+        if (index == journalSpans.size()) {
+            return false;
+        }
+        const JournalSpan& span = journalSpans[index];
+        return span.address <= address && address + length <= span.address + span.length;
     }
 
     /**
      * @brief Stores original memory values before patching.
      * @param address Memory address to store.
      * @param length Number of bytes to store.
-     * @details Saves the original memory values before applying patches to allow
-     *          restoration of the original state when needed.
+     * @details Merges the range into the journal. Bytes that are already
+     *          journaled keep their recorded original value, only the missing
+     *          bytes are read from memory. This keeps overlapping patches at
+     *          different start addresses consistent.
      * @warning Will not store values if address is invalid or memory access fails.
      */
     void storeOriginalValues(unsigned int address, size_t length) {
@@ -73,195 +106,577 @@ namespace DynamicQuickPatch
             return;
         }
 
-        try {
-            // Read current memory values
-            std::vector<unsigned char> originalBytes;
-            for (size_t i = 0; i < length; i++) {
-                originalBytes.push_back(*((unsigned char*)(address + i)));
-            }
-            originalMemoryValues[address] = originalBytes;
+        // Determine the spans that overlap or touch the new range
+        size_t first = findJournalSpan(address);
+        size_t last = first;
+        unsigned int mergedStart = address;
+        unsigned int mergedEnd = address + length;
+        while (last < journalSpans.size() && journalSpans[last].address <= mergedEnd) {
+            mergedStart = std::min(mergedStart, journalSpans[last].address);
+            mergedEnd = std::max(mergedEnd, (unsigned int)(journalSpans[last].address + journalSpans[last].length));
+            last++;
+        }
 
-            if (Debug::enableConsole) {
-                std::cout << "[DynamicQuickPatch - Memory]" << std::endl;
-                std::cout << "Stored original memory values at 0x" << std::hex << std::uppercase << address
-                         << " (" << std::dec << length << " bytes)" << std::endl;
-                std::cout << std::endl;
+        journalMergeSpans.clear();
+        journalMergeArena.clear();
+        journalMergeArena.reserve(journalArena.size() + length);
+
+        // Copy the untouched spans before the merged range
+        for (size_t i = 0; i < first; i++) {
+            JournalSpan span = journalSpans[i];
+            journalMergeArena.insert(journalMergeArena.end(), &journalArena[span.offset], &journalArena[span.offset] + span.length);
+            span.offset = journalMergeArena.size() - span.length;
+            journalMergeSpans.push_back(span);
+        }
+
+        // Build the merged span, preferring already journaled bytes over memory
+        JournalSpan merged;
+        merged.address = mergedStart;
+        merged.length = mergedEnd - mergedStart;
+        merged.offset = journalMergeArena.size();
+        size_t storedCount = 0;
+        unsigned int position = mergedStart;
+        for (size_t i = first; i <= last; i++) {
+            unsigned int gapEnd = i < last ? journalSpans[i].address : mergedEnd;
+            if (position < gapEnd) {
+                const unsigned char* current = (const unsigned char*)position;
+                journalMergeArena.insert(journalMergeArena.end(), current, current + (gapEnd - position));
+                storedCount += gapEnd - position;
+                position = gapEnd;
             }
-        } catch (...) {
-            if (Debug::enableConsole) {
-                std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Memory access violation at 0x" << std::hex << std::uppercase << address << std::endl;
-                std::cout << std::endl;
+            if (i < last) {
+                const JournalSpan& span = journalSpans[i];
+                journalMergeArena.insert(journalMergeArena.end(), &journalArena[span.offset], &journalArena[span.offset] + span.length);
+                position = span.address + span.length;
             }
+        }
+        journalMergeSpans.push_back(merged);
+
+        // Copy the untouched spans after the merged range
+        for (size_t i = last; i < journalSpans.size(); i++) {
+            JournalSpan span = journalSpans[i];
+            journalMergeArena.insert(journalMergeArena.end(), &journalArena[span.offset], &journalArena[span.offset] + span.length);
+            span.offset = journalMergeArena.size() - span.length;
+            journalMergeSpans.push_back(span);
+        }
+
+        journalSpans.swap(journalMergeSpans);
+        journalArena.swap(journalMergeArena);
+
+        if (Debug::enableConsole) {
+            std::cout << "[DynamicQuickPatch - Memory]" << std::endl;
+            std::cout << "Stored original memory values at 0x" << std::hex << std::uppercase << address
+                     << " (" << std::dec << storedCount << " new bytes, " << journalArena.size()
+                     << " bytes in " << journalSpans.size() << " spans)" << std::endl;
+            std::cout << std::endl;
+        }
+    }
+
+    /** @brief Marks a queued write that belongs to no mapping or group. */
+    const int DQP_NO_OWNER = -1;
+
+    /**
+     * @brief Shadow table of the last effective value applied per mapping.
+     * @details Indexed like DynamicQuickPatchConfig::getMappings(). Holds the
+     *          clamped value for numeric patches and 0/1 for hex patches.
+     */
+    static std::vector<int> appliedValues;
+
+    /** @brief Non-zero if the matching appliedValues entry reflects memory. */
+    static std::vector<unsigned char> appliedValueKnown;
+
+    /** @brief Marks a patch group whose active set is unknown. */
+    const int DQP_GROUP_SET_UNKNOWN = -2;
+    /** @brief Marks a patch group with no active set (all addresses restored). */
+    const int DQP_GROUP_SET_NONE = -1;
+
+    /**
+     * @brief Shadow table of the active set per patch group.
+     * @details Indexed like DynamicQuickPatchConfig::getGroups(). Holds the index
+     *          of the active patch set, DQP_GROUP_SET_NONE or DQP_GROUP_SET_UNKNOWN.
+     */
+    static std::vector<int> appliedGroupSets;
+
+    /**
+     * @brief Shadow owners whose bytes overlap each shadow owner.
+     * @details Owners are the mappings (indexed like getMappings()) followed by
+     *          the patch groups (indexed like getGroups()). A committed write of
+     *          one owner overwrites bytes of every overlapping owner, so their
+     *          shadow entries no longer reflect memory.
+     */
+    static std::vector<std::vector<int> > ownerOverlaps;
+
+    /** @brief Owner stamped on writes queued while a mapping or group is applied. */
+    static int writeOwner = DQP_NO_OWNER;
+    /** @brief Shadow value recorded for writeOwner once its writes are committed. */
+    static int writeOwnerValue = 0;
+
+    /**
+     * @brief Gets the index of a mapping in the shadow table.
+     * @param mapping A mapping owned by DynamicQuickPatchConfig::getMappings().
+     * @return Index of the mapping, which is also its shadow owner.
+     */
+    size_t getMappingIndex(const DynamicQuickPatchConfig::QuickPatchMapping& mapping) {
+        return &mapping - DynamicQuickPatchConfig::getMappings().data();
+    }
+
+    /**
+     * @brief Gets the shadow owner of a patch group.
+     * @param groupIndex Index of the group in DynamicQuickPatchConfig::getGroups().
+     * @return The owner, numbered after all mappings.
+     */
+    int getGroupOwner(size_t groupIndex) {
+        return (int)(DynamicQuickPatchConfig::getMappings().size() + groupIndex);
+    }
+
+    /**
+     * @brief Computes the value that determines the bytes a patch writes.
+     * @param mapping The mapping to evaluate.
+     * @param value The variable value.
+     * @return The clamped value for 8-bit, the value for 32-bit and the
+     *         active state (0 or 1) for hex patches.
+     */
+    int getEffectiveValue(const DynamicQuickPatchConfig::QuickPatchMapping& mapping, int value) {
+        switch (mapping.type) {
+            case DynamicQuickPatchConfig::QPTYPE_8BIT:
+                return std::max(DQP_INT8_MIN, std::min(DQP_INT8_MAX, value));
+
+            case DynamicQuickPatchConfig::QPTYPE_32BIT:
+                return value;
+
+            case DynamicQuickPatchConfig::QPTYPE_HEX_RAW:
+                return value != 0 ? 1 : 0;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Records the value an owner's bytes in memory now reflect.
+     * @param owner The mapping or group owner.
+     * @param value Effective value for a mapping, patch set index for a group.
+     */
+    void recordOwnerValue(int owner, int value) {
+        size_t mappingCount = appliedValues.size();
+        if (owner < 0) {
             return;
         }
+        if ((size_t)owner < mappingCount) {
+            appliedValues[owner] = value;
+            appliedValueKnown[owner] = 1;
+        } else if ((size_t)owner - mappingCount < appliedGroupSets.size()) {
+            appliedGroupSets[owner - mappingCount] = value;
+        }
     }
 
     /**
-     * @brief Restores original memory values.
-     * @param address Memory address to restore.
-     * @return True if restore was successful.
-     * @details Restores the original memory values that were saved before patching.
-     * @warning Will fail if address is invalid or memory access fails.
+     * @brief Forgets the value an owner's bytes in memory reflect.
+     * @param owner The mapping or group owner.
      */
-    bool restoreOriginalValues(unsigned int address) {
-        // Verify original values exist
-        if (originalMemoryValues.find(address) == originalMemoryValues.end()) {
-            return false;
+    void invalidateOwnerValue(int owner) {
+        size_t mappingCount = appliedValues.size();
+        if (owner < 0) {
+            return;
         }
+        if ((size_t)owner < mappingCount) {
+            appliedValueKnown[owner] = 0;
+        } else if ((size_t)owner - mappingCount < appliedGroupSets.size()) {
+            appliedGroupSets[owner - mappingCount] = DQP_GROUP_SET_UNKNOWN;
+        }
+    }
 
-        // Validate memory address range
-        if (address == 0 || address >= 0xFFFFFFFF - originalMemoryValues[address].size()) {
-            if (Debug::enableConsole) {
-                std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Invalid memory address for restore: 0x" << std::hex << std::uppercase << address << std::endl;
-                std::cout << std::endl;
+    /**
+     * @brief Sets the owner stamped on the writes queued next.
+     * @param owner The mapping or group being applied, or DQP_NO_OWNER.
+     * @param value Shadow value recorded for the owner when the writes commit.
+     */
+    void setWriteOwner(int owner, int value) {
+        writeOwner = owner;
+        writeOwnerValue = value;
+    }
+
+    /**
+     * @brief Checks if an owner shares bytes with another mapping or group.
+     * @param owner The mapping or group owner.
+     * @return True if the owner's overlap list is not empty.
+     * @details The shadow only tells whether an owner's own bytes are still
+     *          in memory, not which of several overlapping owners wrote last,
+     *          so passes that must end in configuration order rewrite these
+     *          owners instead of skipping them.
+     */
+    bool hasOwnerOverlaps(int owner) {
+        return owner >= 0 && (size_t)owner < ownerOverlaps.size() && !ownerOverlaps[owner].empty();
+    }
+
+    /**
+     * @brief Builds the overlap lists of all mappings and patch groups.
+     * @details Sorts the byte ranges of every mapping and group footprint by
+     *          address and links each range with the following ranges that
+     *          start before it ends. Called once after loading the configuration.
+     */
+    void buildOwnerOverlaps() {
+        const auto& mappings = DynamicQuickPatchConfig::getMappings();
+        const auto& groups = DynamicQuickPatchConfig::getGroups();
+        ownerOverlaps.assign(mappings.size() + groups.size(), std::vector<int>());
+
+        struct OwnedRange {
+            unsigned int start;   ///< First byte
+            unsigned int end;     ///< One past the last byte
+            int owner;            ///< Mapping or group owner
+        };
+        std::vector<OwnedRange> ranges;
+        for (size_t i = 0; i < mappings.size(); i++) {
+            OwnedRange range = { mappings[i].address, (unsigned int)(mappings[i].address + mappings[i].patchSize), (int)i };
+            ranges.push_back(range);
+        }
+        for (size_t g = 0; g < groups.size(); g++) {
+            for (const auto& footprint : groups[g].footprint) {
+                OwnedRange range = { footprint.address, (unsigned int)(footprint.address + footprint.length), getGroupOwner(g) };
+                ranges.push_back(range);
             }
-            return false;
         }
+        std::sort(ranges.begin(), ranges.end(), [](const OwnedRange& a, const OwnedRange& b) {
+            return a.start < b.start;
+        });
 
-        bool success = false;
-        try {
-            // Write original values back to memory
-            const auto& originalBytes = originalMemoryValues[address];
-            for (size_t i = 0; i < originalBytes.size(); i++) {
-                *((unsigned char*)(address + i)) = originalBytes[i];
-            }
-            success = true;
-        } catch (...) {
-            if (Debug::enableConsole) {
-                std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Memory access violation during restore at 0x" << std::hex << std::uppercase << address << std::endl;
-                std::cout << std::endl;
+        for (size_t i = 0; i < ranges.size(); i++) {
+            for (size_t j = i + 1; j < ranges.size() && ranges[j].start < ranges[i].end; j++) {
+                if (ranges[i].owner != ranges[j].owner) {
+                    ownerOverlaps[ranges[i].owner].push_back(ranges[j].owner);
+                    ownerOverlaps[ranges[j].owner].push_back(ranges[i].owner);
+                }
             }
-            return false;
         }
+        for (auto& overlaps : ownerOverlaps) {
+            std::sort(overlaps.begin(), overlaps.end());
+            overlaps.erase(std::unique(overlaps.begin(), overlaps.end()), overlaps.end());
+        }
+    }
+
+    /**
+     * @brief Forgets all applied values.
+     * @details Sizes the shadow table to the loaded mappings. Called after
+     *          loading the configuration and after memory has been restored.
+     */
+    void resetAppliedValues() {
+        size_t count = DynamicQuickPatchConfig::getMappings().size();
+        appliedValues.assign(count, 0);
+        appliedValueKnown.assign(count, 0);
+        appliedGroupSets.assign(DynamicQuickPatchConfig::getGroups().size(), DQP_GROUP_SET_UNKNOWN);
+    }
 
-        return success;
+    /**
+     * @brief Checks if applying a value would leave memory unchanged.
+     * @param mapping The mapping to check.
+     * @param value The variable value.
+     * @return True if the mapping's last committed effective value matches.
+     */
+    bool isPatchUnchanged(const DynamicQuickPatchConfig::QuickPatchMapping& mapping, int value) {
+        size_t index = getMappingIndex(mapping);
+        return appliedValueKnown[index] != 0 &&
+               appliedValues[index] == getEffectiveValue(mapping, value);
     }
 
+    /** @brief Size of a memory page used to group batched writes. */
+    const unsigned int DQP_PAGE_SIZE = 0x1000;
+
     /**
-     * @brief Writes an 8-bit signed integer to memory.
+     * @brief A pending memory write queued in the current patch batch.
+     * @details The bytes are copied into batchBytes when the write is queued,
+     *          so the caller's buffer does not need to outlive the batch.
+     */
+    struct PendingWrite {
+        unsigned int address;     ///< Destination memory address
+        size_t offset;            ///< Offset of the bytes in batchBytes
+        size_t length;            ///< Number of bytes to write
+        int owner;                ///< Mapping or group the write belongs to, or DQP_NO_OWNER
+        int ownerValue;           ///< Shadow value recorded for the owner on commit
+        bool committed;           ///< Set once the bytes reached memory
+    };
+
+    /** @brief Writes queued in the current batch, in queue order. */
+    static std::vector<PendingWrite> batchWrites;
+    /** @brief Byte storage for all queued writes. */
+    static std::vector<unsigned char> batchBytes;
+    /** @brief Page start addresses touched by the current batch (scratch). */
+    static std::vector<unsigned int> batchPages;
+    /** @brief Previous protection of each entry in batchPages (scratch). */
+    static std::vector<DWORD> batchPageProtection;
+    /** @brief Tracks if a batch is open; writes outside a batch commit immediately. */
+    static bool batchOpen = false;
+
+    /**
+     * @brief Opens a patch batch.
+     * @details Subsequent writes are queued until commitPatchBatch is called.
+     * @see commitPatchBatch
+     */
+    void beginPatchBatch() {
+        batchWrites.clear();
+        batchBytes.clear();
+        batchOpen = true;
+    }
+
+    /**
+     * @brief Queues a memory write in the current patch batch.
      * @param address Memory address to write to.
-     * @param value The value to write.
-     * @details Writes an 8-bit value to memory, storing the original value first
-     *          if not already stored.
-     * @warning Will not write if address is invalid or memory access fails.
-     * @see storeOriginalValues
+     * @param bytes Bytes to write.
+     * @param length Number of bytes to write.
+     * @return True if the write was queued.
+     * @details Writes are committed in queue order, so a later write to the
+     *          same bytes wins, exactly like immediate writes would.
      */
-    void write8bitValue(unsigned int address, int value) {
-        // Validate memory address
-        if (address == 0 || address >= 0xFFFFFFFF) {
-            if (Debug::enableConsole) {
+    bool queuePatchWrite(unsigned int address, const unsigned char* bytes, size_t length) {
+        if (length == 0) {
+            return false;
+        }
+
+        PendingWrite write;
+        write.address = address;
+        write.offset = batchBytes.size();
+        write.length = length;
+        write.owner = writeOwner;
+        write.ownerValue = writeOwnerValue;
+        write.committed = false;
+        batchBytes.insert(batchBytes.end(), bytes, bytes + length);
+        batchWrites.push_back(write);
+        return true;
+    }
+
+    /**
+     * @brief Commits all writes queued in the current batch.
+     * @return Number of writes committed.
+     * @details Groups the writes by 4 KB page and makes each touched page
+     *          writable with a single VirtualProtect call, copies all bytes,
+     *          restores the previous protection of every page and issues a
+     *          single FlushInstructionCache over the patched range.
+     * @note Writes touching a page that could not be unprotected are skipped.
+     *       The shadow tables are updated from the committed writes only: the
+     *       owner of a committed write records its value and every overlapping
+     *       owner is invalidated, the owner of a skipped write is invalidated.
+     */
+    int commitPatchBatch() {
+        batchOpen = false;
+        if (batchWrites.empty()) {
+            return 0;
+        }
+
+        // Collect the unique pages touched by the batch
+        batchPages.clear();
+        unsigned int rangeStart = 0xFFFFFFFF;
+        unsigned int rangeEnd = 0;
+        for (const auto& write : batchWrites) {
+            unsigned int first = write.address & ~(DQP_PAGE_SIZE - 1);
+            unsigned int last = (write.address + write.length - 1) & ~(DQP_PAGE_SIZE - 1);
+            for (unsigned int page = first; page <= last; page += DQP_PAGE_SIZE) {
+                batchPages.push_back(page);
+            }
+            rangeStart = std::min(rangeStart, write.address);
+            rangeEnd = std::max(rangeEnd, (unsigned int)(write.address + write.length));
+        }
+        std::sort(batchPages.begin(), batchPages.end());
+        batchPages.erase(std::unique(batchPages.begin(), batchPages.end()), batchPages.end());
+
+        // Unprotect each page once (0 marks a page that stayed protected)
+        batchPageProtection.assign(batchPages.size(), 0);
+        for (size_t i = 0; i < batchPages.size(); i++) {
+            DWORD oldProtect = 0;
+            if (VirtualProtect((LPVOID)batchPages[i], DQP_PAGE_SIZE, PAGE_EXECUTE_READWRITE, &oldProtect)) {
+                batchPageProtection[i] = oldProtect;
+            } else if (Debug::enableConsole) {
                 std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Invalid memory address for 8-bit write: 0x" << std::hex << std::uppercase << address << std::endl;
+                std::cout << "Failed to unprotect page 0x" << std::hex << std::uppercase << batchPages[i] << std::endl;
                 std::cout << std::endl;
             }
-            return;
         }
 
-        // Store original value if needed
-        if (!hasOriginalValues(address, 1)) {
-            storeOriginalValues(address, 1);
+        // Copy all queued bytes in queue order
+        int committedCount = 0;
+        for (auto& write : batchWrites) {
+            unsigned int first = write.address & ~(DQP_PAGE_SIZE - 1);
+            unsigned int last = (write.address + write.length - 1) & ~(DQP_PAGE_SIZE - 1);
+            size_t pageIndex = std::lower_bound(batchPages.begin(), batchPages.end(), first) - batchPages.begin();
+
+            bool writable = true;
+            for (unsigned int page = first; page <= last; page += DQP_PAGE_SIZE, pageIndex++) {
+                if (batchPageProtection[pageIndex] == 0) {
+                    writable = false;
+                }
+            }
+            if (!writable) {
+                continue;
+            }
+
+            memcpy((void*)write.address, &batchBytes[write.offset], write.length);
+            write.committed = true;
+            committedCount++;
         }
 
-        try {
-            // Write new value to memory
-            *((char*)address) = (char)value;
-        } catch (...) {
-            if (Debug::enableConsole) {
-                std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Memory access violation during 8-bit write at 0x" << std::hex << std::uppercase << address << std::endl;
-                std::cout << std::endl;
+        // Update the shadow tables in queue order, so a later write wins
+        for (const auto& write : batchWrites) {
+            if (write.owner == DQP_NO_OWNER || !write.committed) {
+                continue;
+            }
+            if ((size_t)write.owner < ownerOverlaps.size()) {
+                for (int other : ownerOverlaps[write.owner]) {
+                    invalidateOwnerValue(other);
+                }
+            }
+            recordOwnerValue(write.owner, write.ownerValue);
+        }
+        for (const auto& write : batchWrites) {
+            if (write.owner != DQP_NO_OWNER && !write.committed) {
+                invalidateOwnerValue(write.owner);
+            }
+        }
+
+        // Restore the previous protection of every unprotected page
+        for (size_t i = 0; i < batchPages.size(); i++) {
+            if (batchPageProtection[i] != 0) {
+                DWORD ignored = 0;
+                VirtualProtect((LPVOID)batchPages[i], DQP_PAGE_SIZE, batchPageProtection[i], &ignored);
             }
         }
+
+        // Make the patched code visible to the CPU
+        FlushInstructionCache(GetCurrentProcess(), (LPCVOID)rangeStart, rangeEnd - rangeStart);
+
+        if (Debug::enableConsole && batchWrites.size() > 1) {
+            std::cout << "[DynamicQuickPatch - Memory Batch]" << std::endl;
+            std::cout << "Committed " << std::dec << committedCount << " of " << batchWrites.size()
+                      << " writes across " << batchPages.size() << " pages" << std::endl;
+            std::cout << std::endl;
+        }
+
+        batchWrites.clear();
+        batchBytes.clear();
+        return committedCount;
     }
 
     /**
-     * @brief Writes a 32-bit signed integer to memory.
-     * @param address Memory address to write to.
-     * @param value The value to write.
-     * @details Writes a 32-bit value to memory, storing the original value first
-     *          if not already stored.
-     * @warning Will not write if address is invalid or memory access fails.
-     * @see storeOriginalValues
+     * @brief Restores original memory values.
+     * @param address Memory address to restore.
+     * @param length Number of bytes to restore.
+     * @return True if any original bytes were found and restored.
+     * @details Restores the journaled bytes that overlap the range. Inside an
+     *          open batch the restore is queued with the other writes.
+     * @warning Will fail if address is invalid or memory access fails.
      */
-    void write32bitValue(unsigned int address, int value) {
-        // Validate memory address
-        if (address == 0 || address >= 0xFFFFFFFF - sizeof(int)) {
+    bool restoreOriginalValues(unsigned int address, size_t length) {
+        // Validate memory address range
+        if (address == 0 || address >= 0xFFFFFFFF - length) {
             if (Debug::enableConsole) {
                 std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Invalid memory address for 32-bit write: 0x" << std::hex << std::uppercase << address << std::endl;
+                std::cout << "Invalid memory address for restore: 0x" << std::hex << std::uppercase << address << std::endl;
                 std::cout << std::endl;
             }
-            return;
+            return false;
         }
 
-        // Store original value if needed
-        if (!hasOriginalValues(address, sizeof(int))) {
-            storeOriginalValues(address, sizeof(int));
+        // Queue the overlapping part of every journal span in the range
+        int queuedCount = 0;
+        unsigned int end = address + length;
+        for (size_t i = findJournalSpan(address); i < journalSpans.size() && journalSpans[i].address < end; i++) {
+            const JournalSpan& span = journalSpans[i];
+            unsigned int from = std::max(address, span.address);
+            unsigned int to = std::min(end, (unsigned int)(span.address + span.length));
+            if (from < to && queuePatchWrite(from, &journalArena[span.offset + (from - span.address)], to - from)) {
+                queuedCount++;
+            }
         }
 
-        try {
-            // Write new value to memory
-            *((int*)address) = value;
-        } catch (...) {
-            if (Debug::enableConsole) {
-                std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Memory access violation during 32-bit write at 0x" << std::hex << std::uppercase << address << std::endl;
-                std::cout << std::endl;
+        if (queuedCount == 0) {
+            return false;
+        }
+        if (!batchOpen) {
+            return commitPatchBatch() == queuedCount;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Queues a restore of every journaled byte.
+     * @return Number of journal spans queued.
+     * @details Walks the journal once in address order. The caller commits the
+     *          batch and clears the journal afterwards.
+     */
+    int restoreAllOriginalValues() {
+        int queuedCount = 0;
+        for (const auto& span : journalSpans) {
+            if (queuePatchWrite(span.address, &journalArena[span.offset], span.length)) {
+                queuedCount++;
             }
         }
+        return queuedCount;
     }
 
     /**
-     * @brief Writes raw hex values to memory.
+     * @brief Discards all journaled original memory values.
+     */
+    void clearOriginalValues() {
+        journalSpans.clear();
+        journalArena.clear();
+    }
+
+    /**
+     * @brief Writes a compiled patch to memory.
      * @param address Memory address to write to.
-     * @param hexString Hexadecimal string to convert and write.
-     * @details Converts a hex string to bytes and writes them to memory,
-     *          storing the original values first if not already stored.
+     * @param bytes Bytes to write.
+     * @param length Number of bytes to write.
+     * @details Copies the bytes to memory, storing the original values first
+     *          if not already stored. Inside an open batch the write is queued,
+     *          otherwise it is committed immediately as a batch of one.
      * @warning Will not write if address is invalid or memory access fails.
      * @see storeOriginalValues
      */
-    void writeHexValue(unsigned int address, const std::string& hexString) {
-        // Calculate number of bytes to write
-        size_t byteCount = hexString.length() / 2;
-
-        // Store original values if needed
-        if (!hasOriginalValues(address, byteCount)) {
-            storeOriginalValues(address, byteCount);
-        }
-
+    void writePatchBytes(unsigned int address, const unsigned char* bytes, size_t length) {
         // Validate memory address range
-        if (address == 0 || address >= 0xFFFFFFFF - byteCount) {
+        if (address == 0 || address >= 0xFFFFFFFF - length) {
             if (Debug::enableConsole) {
                 std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Invalid memory address for hex write: 0x" << std::hex << std::uppercase << address << std::endl;
+                std::cout << "Invalid memory address for patch write: 0x" << std::hex << std::uppercase << address << std::endl;
                 std::cout << std::endl;
             }
             return;
         }
 
-        try {
-            // Convert hex string to bytes and write to memory
-            for (size_t i = 0; i < hexString.length(); i += 2) {
-                // Skip incomplete byte pairs
-                if (i + 1 >= hexString.length()) break;
+        // Store original values if needed
+        if (!hasOriginalValues(address, length)) {
+            storeOriginalValues(address, length);
+        }
 
-                // Convert hex pair to byte value
-                std::string byteStr = hexString.substr(i, 2);
-                unsigned char byte = (unsigned char)strtol(byteStr.c_str(), NULL, 16);
+        // Queue patch bytes and commit unless a batch is collecting writes
+        queuePatchWrite(address, bytes, length);
+        if (!batchOpen) {
+            commitPatchBatch();
+        }
+    }
 
-                // Write byte to memory
-                *((unsigned char*)(address + (i/2))) = byte;
-            }
-        } catch (...) {
-            if (Debug::enableConsole) {
-                std::cout << "[DynamicQuickPatch - Memory Error]" << std::endl;
-                std::cout << "Memory access violation during hex write at 0x" << std::hex << std::uppercase << address << std::endl;
-                std::cout << std::endl;
+    /**
+     * @brief Formats the current memory of a mapping for debug output.
+     * @param mapping The mapping whose memory is formatted.
+     * @return The value in quickpatch notation (%n, #n or raw hex).
+     * @note Only called when the debug console is enabled.
+     */
+    std::string formatMemoryValue(const DynamicQuickPatchConfig::QuickPatchMapping& mapping) {
+        static const char hexDigits[] = "0123456789ABCDEF";
+        switch (mapping.type) {
+            case DynamicQuickPatchConfig::QPTYPE_8BIT:
+                return "%" + std::to_string((int)*((char*)mapping.address));
+
+            case DynamicQuickPatchConfig::QPTYPE_32BIT:
+                return "#" + std::to_string(*((int*)mapping.address));
+
+            case DynamicQuickPatchConfig::QPTYPE_HEX_RAW: {
+                std::string hex;
+                hex.reserve(mapping.patchSize * 2);
+                for (size_t i = 0; i < mapping.patchSize; i++) {
+                    unsigned char byte = *((unsigned char*)(mapping.address + i));
+                    hex += hexDigits[byte >> 4];
+                    hex += hexDigits[byte & 0x0F];
+                }
+                return hex;
             }
         }
+        return std::string();
     }
 
     /**
@@ -319,7 +734,7 @@ namespace DynamicQuickPatch
 
         return isValid;
     }
-
+
     /**
      * @brief Updates a quickpatch mapping with a new value.
      * @param mapping The mapping definition to update.
@@ -330,18 +745,23 @@ namespace DynamicQuickPatch
      *          - For hex: Uses predefined hex string, 0 deactivates patch
      * @note For hex patches, if value is 0, restores original memory values.
      *       For 8-bit and 32-bit patches, 0 is treated as a valid value to write.
+     *       The write itself is a copy of the compiled patch bytes; old values
+     *       are only formatted when the debug console is enabled.
+     *       The shadow table records the value once the write is committed.
+     * @see commitPatchBatch
      */
     void updateQuickPatch(const DynamicQuickPatchConfig::QuickPatchMapping& mapping, int value) {
         // Handle patch deactivation - only for hex patches
         if (value == 0 && mapping.type == DynamicQuickPatchConfig::QPTYPE_HEX_RAW) {
-            // Determine patch size for hex type
-            size_t size = mapping.hexValue.length() / 2;
-            std::string typeStr = "Raw Hex";
-
             // Restore original memory values if available
             bool restored = false;
-            if (hasOriginalValues(mapping.address, size)) {
-                restored = restoreOriginalValues(mapping.address);
+            if (hasOriginalValues(mapping.address, mapping.patchSize)) {
+                setWriteOwner((int)getMappingIndex(mapping), 0);
+                restored = restoreOriginalValues(mapping.address, mapping.patchSize);
+                setWriteOwner(DQP_NO_OWNER, 0);
+            } else {
+                // Never patched, memory still holds the original bytes
+                recordOwnerValue((int)getMappingIndex(mapping), 0);
             }
 
             if (Debug::enableConsole) {
@@ -349,7 +769,7 @@ namespace DynamicQuickPatch
                 std::cout << "QuickPatch Disabled" << std::endl;
                 std::cout << "Variable: " << mapping.variableId << std::endl;
                 std::cout << "Address: 0x" << std::hex << std::uppercase << mapping.address << std::endl;
-                std::cout << "Type: " << typeStr << std::endl;
+                std::cout << "Type: Raw Hex" << std::endl;
                 if (restored) {
                     std::cout << "Original memory values restored (variable = 0)" << std::endl;
                 } else {
@@ -363,58 +783,29 @@ namespace DynamicQuickPatch
 
         // Read current memory value for logging
         std::string oldValueStr;
-        switch (mapping.type) {
-            case DynamicQuickPatchConfig::QPTYPE_8BIT: {
-                char oldVal = *((char*)mapping.address);
-                oldValueStr = "%" + std::to_string((int)oldVal);
-                break;
-            }
-            case DynamicQuickPatchConfig::QPTYPE_32BIT: {
-                int oldVal = *((int*)mapping.address);
-                oldValueStr = "#" + std::to_string(oldVal);
-                break;
-            }
-            case DynamicQuickPatchConfig::QPTYPE_HEX_RAW: {
-                // Format current memory as hex string
-                std::string hex;
-                size_t hexLen = mapping.hexValue.length();
-                for (size_t i = 0; i < hexLen; i += 2) {
-                    unsigned char byte = *((unsigned char*)(mapping.address + (i / 2)));
-                    char buf[3];
-                    sprintf(buf, "%02X", byte);
-                    hex += buf;
-                }
-                oldValueStr = hex;
-                break;
+        if (Debug::enableConsole) {
+            oldValueStr = formatMemoryValue(mapping);
+
+            // Validate value range (for non-hex types)
+            if (mapping.type != DynamicQuickPatchConfig::QPTYPE_HEX_RAW) {
+                validateValue(value, mapping.type, mapping.variableId, mapping.address);
             }
         }
 
-        // Validate and adjust value if needed (for non-hex types)
-        if (mapping.type != DynamicQuickPatchConfig::QPTYPE_HEX_RAW) {
-            validateValue(value, mapping.type, mapping.variableId, mapping.address);
-        }
+        // Clamp value to 8-bit range (0 is valid)
         int adjustedValue = value;
-
-        // Apply new value with range clamping
-        switch (mapping.type) {
-            case DynamicQuickPatchConfig::QPTYPE_8BIT:
-                // Clamp value to 8-bit range (0 is valid)
-                if (adjustedValue < DQP_INT8_MIN) adjustedValue = DQP_INT8_MIN;
-                if (adjustedValue > DQP_INT8_MAX) adjustedValue = DQP_INT8_MAX;
-                write8bitValue(mapping.address, adjustedValue);
-                break;
-
-            case DynamicQuickPatchConfig::QPTYPE_32BIT:
-                // Direct write (0 is valid)
-                write32bitValue(mapping.address, adjustedValue);
-                break;
-
-            case DynamicQuickPatchConfig::QPTYPE_HEX_RAW:
-                // For hex patches, write the predefined hex value
-                writeHexValue(mapping.address, mapping.hexValue);
-                break;
+        if (mapping.type == DynamicQuickPatchConfig::QPTYPE_8BIT) {
+            if (adjustedValue < DQP_INT8_MIN) adjustedValue = DQP_INT8_MIN;
+            if (adjustedValue > DQP_INT8_MAX) adjustedValue = DQP_INT8_MAX;
         }
 
+        // Encode and write the compiled patch
+        unsigned char scratch[DynamicQuickPatchConfig::QP_MAX_VALUE_SIZE];
+        const unsigned char* bytes = mapping.encode(mapping, adjustedValue, scratch);
+        setWriteOwner((int)getMappingIndex(mapping), getEffectiveValue(mapping, value));
+        writePatchBytes(mapping.address, bytes, mapping.patchSize);
+        setWriteOwner(DQP_NO_OWNER, 0);
+
         // Log memory update details
         if (Debug::enableConsole) {
             // Format display values
@@ -457,6 +848,153 @@ namespace DynamicQuickPatch
         }
     }
 
+    /**
+     * @brief Finds the patch set a value selects in a group.
+     * @param group The patch group to search.
+     * @param value The variable value.
+     * @return Index of the patch set, or DQP_GROUP_SET_NONE if no set uses the value.
+     */
+    int findPatchSet(const DynamicQuickPatchConfig::PatchGroup& group, int value) {
+        auto it = std::lower_bound(group.sets.begin(), group.sets.end(), value,
+            [](const DynamicQuickPatchConfig::PatchSet& set, int v) {
+                return set.value < v;
+            });
+        if (it == group.sets.end() || it->value != value) {
+            return DQP_GROUP_SET_NONE;
+        }
+        return (int)(it - group.sets.begin());
+    }
+
+    /**
+     * @brief Switches a patch group to the set selected by a value.
+     * @param group The patch group to update.
+     * @param value The new variable value.
+     * @param force Rewrite the set even if the shadow says it is active.
+     * @return True if memory was updated, false if the set was already active.
+     * @details Queues a restore of every address used by the group, followed by
+     *          the writes of the selected set, so addresses the set does not use
+     *          end up with their original bytes. The whole switch is a single
+     *          patch batch (or part of the caller's open batch).
+     */
+    bool applyPatchGroup(const DynamicQuickPatchConfig::PatchGroup& group, int value, bool force = false) {
+        size_t groupIndex = &group - DynamicQuickPatchConfig::getGroups().data();
+        int setIndex = findPatchSet(group, value);
+        if (!force && appliedGroupSets[groupIndex] == setIndex) {
+            return false;
+        }
+
+        bool ownsBatch = !batchOpen;
+        if (ownsBatch) {
+            beginPatchBatch();
+        }
+
+        // Restore the group's footprint, then lay the selected set on top
+        int owner = getGroupOwner(groupIndex);
+        size_t queuedBefore = batchWrites.size();
+        setWriteOwner(owner, setIndex);
+        for (const auto& range : group.footprint) {
+            restoreOriginalValues(range.address, range.length);
+        }
+        if (setIndex != DQP_GROUP_SET_NONE) {
+            const DynamicQuickPatchConfig::PatchSet& set = group.sets[setIndex];
+            for (const auto& write : set.writes) {
+                writePatchBytes(write.address, &set.bytes[write.offset], write.length);
+            }
+        }
+        setWriteOwner(DQP_NO_OWNER, 0);
+        bool queuedAny = batchWrites.size() > queuedBefore;
+
+        if (ownsBatch) {
+            commitPatchBatch();
+        }
+
+        // Nothing to restore or write: the footprint already holds the original bytes
+        if (!queuedAny) {
+            recordOwnerValue(owner, setIndex);
+        }
+
+        if (Debug::enableConsole) {
+            std::cout << "[DynamicQuickPatch - Group Update]" << std::endl;
+            std::cout << "QuickPatchGroup" << std::dec << group.groupId << " Updated" << std::endl;
+            std::cout << "Variable: " << group.variableId << std::endl;
+            std::cout << "Value: " << value << std::endl;
+            if (setIndex != DQP_GROUP_SET_NONE) {
+                std::cout << "Applied patch set with " << group.sets[setIndex].writes.size() << " writes" << std::endl;
+            } else {
+                std::cout << "No patch set for this value, restored " << group.footprint.size() << " addresses" << std::endl;
+            }
+            std::cout << std::endl;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Shadow table of the last value mirrored per watch.
+     * @details Indexed like DynamicQuickPatchConfig::getWatches().
+     */
+    static std::vector<int> watchShadow;
+
+    /** @brief False until the next sweep has written every watch variable. */
+    static bool watchShadowValid = false;
+
+    /** @brief Frames since the last watch sweep. */
+    static int watchFrameCounter = 0;
+
+    /**
+     * @brief Forgets the mirrored watch values.
+     * @details The next sweep runs on the following frame and writes every
+     *          watch variable, since the variables may no longer match memory
+     *          after a new game or a loaded save.
+     */
+    void resetWatchShadow() {
+        watchShadow.assign(DynamicQuickPatchConfig::getWatches().size(), 0);
+        watchShadowValid = false;
+        watchFrameCounter = DynamicQuickPatchConfig::getWatchInterval();
+    }
+
+    /**
+     * @brief Mirrors the watched memory values into their variables.
+     * @return Number of variables written, 0 if no sweep was due.
+     * @details Runs once every WatchInterval frames. All addresses are read in
+     *          one pass in address order and compared against the shadow
+     *          table; only variables whose value changed are written, so an
+     *          idle sweep costs one read and compare per watch.
+     * @note Writes go to RPG::variables directly and do not trigger
+     *       onSetVariable, so a watch never applies a patch.
+     */
+    int pollWatches() {
+        const auto& watches = DynamicQuickPatchConfig::getWatches();
+        if (watches.empty() || ++watchFrameCounter < DynamicQuickPatchConfig::getWatchInterval()) {
+            return 0;
+        }
+        watchFrameCounter = 0;
+
+        int changedCount = 0;
+        for (size_t i = 0; i < watches.size(); ++i) {
+            const auto& watch = watches[i];
+            int value;
+            if (watch.type == DynamicQuickPatchConfig::QPTYPE_8BIT) {
+                value = *reinterpret_cast<const signed char*>(watch.address);
+            } else {
+                memcpy(&value, reinterpret_cast<const void*>(watch.address), sizeof(value));
+            }
+            if (watchShadowValid && watchShadow[i] == value) {
+                continue;
+            }
+            watchShadow[i] = value;
+            RPG::variables[watch.variableId] = value;
+            changedCount++;
+        }
+        watchShadowValid = true;
+
+        if (Debug::enableConsole && changedCount > 0) {
+            std::cout << "[DynamicQuickPatch - Watch]" << std::endl;
+            std::cout << "Updated " << changedCount << " of " << watches.size() << " watched variables" << std::endl;
+            std::cout << std::endl;
+        }
+        return changedCount;
+    }
+
     /**
      * @brief Plugin initialization handler.
      * @param pluginName Name of the plugin section in DynRPG.ini.
@@ -466,7 +1004,7 @@ namespace DynamicQuickPatch
      */
     bool onStartup(char *pluginName) {
         // Load plugin configuration
-        std::map<std::string, std::string> configuration = RPG::loadConfiguration(pluginName);
+        std::map<std::string, std::string> configuration = IniCache::loadConfiguration(pluginName);
 
         // Initialize debug console with default disabled state
         Debug::enableConsole = false;
@@ -476,62 +1014,30 @@ namespace DynamicQuickPatch
 
         // Initialize debug console if enabled
         if (Debug::enableConsole) {
+            Debug::loadOutputSettings(configuration);
             Debug::initConsole();
         }
 
         // Load and validate configuration settings
-        return DynamicQuickPatchConfig::loadConfig(pluginName);
+        bool loaded = DynamicQuickPatchConfig::loadConfig(pluginName);
+        buildOwnerOverlaps();
+        resetAppliedValues();
+        resetWatchShadow();
+        return loaded;
     }
 
     /**
      * @brief Handles starting a new game or returning to title screen.
      * @details Restores all original memory values to prevent patches from
-     *          persisting across game sessions.
+     *          persisting across game sessions. The journal is restored in a
+     *          single linear sweep committed as one patch batch.
      */
     void onNewGame() {
-        // Track restoration results
-        int restoredCount = 0;
-        int failedCount = 0;
-
-        // Get unique addresses from mappings
-        const auto& mappings = DynamicQuickPatchConfig::getMappings();
-        std::set<unsigned int> processedAddresses;
-
-        for (const auto& mapping : mappings) {
-            // Skip already processed addresses
-            if (processedAddresses.find(mapping.address) != processedAddresses.end()) {
-                continue;
-            }
-
-            // Mark address as processed
-            processedAddresses.insert(mapping.address);
-
-            // Calculate patch size based on type
-            size_t size = 0;
-            switch (mapping.type) {
-                case DynamicQuickPatchConfig::QPTYPE_8BIT:
-                    size = 1;
-                    break;
-
-                case DynamicQuickPatchConfig::QPTYPE_32BIT:
-                    size = 4;
-                    break;
-
-                case DynamicQuickPatchConfig::QPTYPE_HEX_RAW:
-                    size = mapping.hexValue.length() / 2;
-                    break;
-            }
-
-            // Attempt to restore original values
-            if (hasOriginalValues(mapping.address, size)) {
-                bool success = restoreOriginalValues(mapping.address);
-                if (success) {
-                    restoredCount++;
-                } else {
-                    failedCount++;
-                }
-            }
-        }
+        // Restore every journaled span in one batch
+        beginPatchBatch();
+        int queuedCount = restoreAllOriginalValues();
+        int restoredCount = commitPatchBatch();
+        int failedCount = queuedCount - restoredCount;
 
         // Log restoration results
         if (Debug::enableConsole && (restoredCount > 0 || failedCount > 0)) {
@@ -543,8 +1049,10 @@ namespace DynamicQuickPatch
             std::cout << std::endl;
         }
 
-        // Clear stored memory values
-        originalMemoryValues.clear();
+        // Clear stored memory values; restored patches no longer match the shadow table
+        clearOriginalValues();
+        resetAppliedValues();
+        resetWatchShadow();
     }
 
     /**
@@ -552,11 +1060,13 @@ namespace DynamicQuickPatch
      * @param id Save slot ID.
      * @param data Pointer to save data.
      * @param length Length of save data.
-     * @details Sets a flag to trigger patch updates when returning to map.
+     * @details Sets a flag to trigger patch updates when returning to map
+     *          and rewrites all watch variables on the next sweep.
      */
     void onLoadGame(int id, char* data, int length) {
         // Set flag to trigger patch updates
         gameJustLoaded = true;
+        resetWatchShadow();
     }
 
     /**
@@ -575,7 +1085,13 @@ namespace DynamicQuickPatch
      * @brief Frame update handler.
      * @param scene Current game scene.
      * @details Updates memory patches when returning to map after loading.
-     *          Only applies patches configured with OnLoadGame=true.
+     *          Only applies patches configured with OnLoadGame=true. All
+     *          patches are committed in a single patch batch.
+     *          Memory watches are swept every WatchInterval frames in any scene.
+     * @note Patches whose effective value matches the last applied value
+     *       are skipped, since their bytes are already in memory. Patches
+     *       that overlap another patch are always rewritten, so overlapping
+     *       bytes end up as the last configured patch sets them.
      */
     void onFrame(RPG::Scene scene) {
         // Check for map return after game load
@@ -590,12 +1106,21 @@ namespace DynamicQuickPatch
             const auto& mappings = DynamicQuickPatchConfig::getMappings();
             int appliedCount = 0;
             int skippedCount = 0;
+            int unchangedCount = 0;
+            beginPatchBatch();
 
-            for (const auto& mapping : mappings) {
+            // Walk the patches in configuration order, so patches writing the
+            // same memory end up as configured rather than in variable order
+            for (int index : DynamicQuickPatchConfig::getMappingConfigOrder()) {
+                const auto& mapping = mappings[index];
                 if (mapping.applyOnLoadGame) {
                     // Validate variable ID range
                     if (mapping.variableId > 0 && mapping.variableId <= DynamicQuickPatchConfig::getMaxVariableId()) {
                         int value = RPG::variables[mapping.variableId];
+                        if (!hasOwnerOverlaps(index) && isPatchUnchanged(mapping, value)) {
+                            unchangedCount++;
+                            continue;
+                        }
                         updateQuickPatch(mapping, value);
                         appliedCount++;
                     } else {
@@ -610,10 +1135,28 @@ namespace DynamicQuickPatch
                 }
             }
 
+            // Update patch groups configured for load game
+            const auto& groups = DynamicQuickPatchConfig::getGroups();
+            for (int index : DynamicQuickPatchConfig::getGroupConfigOrder()) {
+                const auto& group = groups[index];
+                if (!group.applyOnLoadGame) {
+                    skippedCount++;
+                    continue;
+                }
+                if (applyPatchGroup(group, RPG::variables[group.variableId], hasOwnerOverlaps(getGroupOwner(index)))) {
+                    appliedCount++;
+                } else {
+                    unchangedCount++;
+                }
+            }
+
+            commitPatchBatch();
+
             // Log patch update summary
-            if (Debug::enableConsole && (appliedCount > 0 || skippedCount > 0)) {
+            if (Debug::enableConsole && (appliedCount > 0 || skippedCount > 0 || unchangedCount > 0)) {
                 std::cout << "[DynamicQuickPatch - Load Game Summary]" << std::endl;
                 std::cout << "Applied " << appliedCount << " patches on load game." << std::endl;
+                std::cout << "Skipped " << unchangedCount << " patches (already applied)." << std::endl;
                 std::cout << "Skipped " << skippedCount << " patches (OnLoadGame=false)." << std::endl;
                 std::cout << std::endl;
             }
@@ -621,6 +1164,9 @@ namespace DynamicQuickPatch
             // Reset load game flag
             gameJustLoaded = false;
         }
+
+        // Mirror watched memory into variables
+        pollWatches();
     }
 
     /**
@@ -630,19 +1176,34 @@ namespace DynamicQuickPatch
      * @return Always returns true to continue normal processing.
      * @details Checks if the changed variable has quickpatch mappings and
      *          updates ALL memory locations mapped to this variable.
-     *          Multiple patches can share the same variable ID.
+     *          Multiple patches can share the same variable ID. Patch groups
+     *          bound to the variable switch to the set selected by the value.
+     * @note Variables without patches are rejected with a single bitmap read;
+     *       patched variables only visit their own span of mappings.
+     * @see DynamicQuickPatchConfig::getMappingsForVariable
      */
     bool onSetVariable(int id, int value) {
-        // Find ALL mappings for this variable ID
-        const auto& mappings = DynamicQuickPatchConfig::getMappings();
-        int updatedCount = 0;
+        // Reject variables without any patch before touching the mappings
+        if (!DynamicQuickPatchConfig::hasPatchForVariable(id)) {
+            return true;
+        }
 
-        // Iterate through all mappings to find matches
-        for (const auto& mapping : mappings) {
-            if (mapping.variableId == id) {
-                updateQuickPatch(mapping, value);
-                updatedCount++;
-            }
+        // Fetch the contiguous span of mappings for this variable ID
+        size_t updatedCount = 0;
+        const DynamicQuickPatchConfig::QuickPatchMapping* span =
+            DynamicQuickPatchConfig::getMappingsForVariable(id, updatedCount);
+
+        for (size_t i = 0; i < updatedCount; i++) {
+            updateQuickPatch(span[i], value);
+        }
+
+        // Switch patch groups bound to this variable
+        size_t groupCount = 0;
+        const DynamicQuickPatchConfig::PatchGroup* groups =
+            DynamicQuickPatchConfig::getGroupsForVariable(id, groupCount);
+
+        for (size_t i = 0; i < groupCount; i++) {
+            applyPatchGroup(groups[i], value);
         }
 
         // Optional: Log if multiple patches were updated
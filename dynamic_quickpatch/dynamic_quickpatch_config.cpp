@@ -1,10 +1,12 @@
 /**
  * @file dynamic_quickpatch_config.cpp
  * @brief Configuration handling for the DynamicQuickPatch plugin.
- * @details Loads and manages settings from DynRPG.ini, including variable mappings
- *          and memory patch definitions.
+ * @details Loads and manages settings from DynRPG.ini, including variable mappings,
+ *          memory patch definitions and memory watches.
  */
 
+#include "../common/ini_cache.cpp"
+
 /**
  * @namespace DynamicQuickPatchConfig
  * @brief Contains configuration settings and loading functionality.
@@ -26,10 +28,26 @@ namespace DynamicQuickPatchConfig
         QPTYPE_HEX_RAW  ///< Raw hex values
     };
 
+    /** @brief Largest encoded size of a numeric quickpatch value (32-bit). */
+    const size_t QP_MAX_VALUE_SIZE = 4;
+
+    struct QuickPatchMapping;
+
+    /**
+     * @brief Type-specialised encoder selected when a mapping is compiled.
+     * @param mapping The mapping being applied.
+     * @param value The variable value to encode.
+     * @param scratch Buffer of at least QP_MAX_VALUE_SIZE bytes for numeric types.
+     * @return Pointer to mapping.patchSize bytes ready to be copied to memory.
+     */
+    typedef const unsigned char* (*PatchEncoder)(const QuickPatchMapping& mapping, int value, unsigned char* scratch);
+
     /**
      * @brief Structure defining a variable-to-quickpatch mapping.
      * @details Maps an RPG Maker variable to a memory address and defines how
      *          the variable's value should be interpreted when writing to memory.
+     *          The compiled fields are filled once by compileMapping so that
+     *          applying a patch needs no string parsing or allocation.
      */
     struct QuickPatchMapping {
         int variableId;           ///< RPG Maker variable ID to monitor
@@ -37,14 +55,116 @@ namespace DynamicQuickPatchConfig
         QuickPatchType type;      ///< Type of quickpatch value
         std::string hexValue;     ///< For HEX_RAW type: hex string without spaces (e.g. "1A2B3C")
         bool applyOnLoadGame;     ///< Whether to apply this patch when loading a save game
+        std::vector<unsigned char> patchBytes; ///< For HEX_RAW type: hexValue decoded at load time
+        size_t patchSize;         ///< Number of bytes written by this patch
+        PatchEncoder encode;      ///< Encoder matching the patch type
+    };
+
+    /**
+     * @brief A single write of a patch set.
+     * @details The bytes live in the owning PatchSet's bytes buffer.
+     */
+    struct PatchSetWrite {
+        unsigned int address;     ///< Memory address to patch
+        size_t offset;            ///< Offset of the bytes in PatchSet::bytes
+        size_t length;            ///< Number of bytes to write
+    };
+
+    /**
+     * @brief A pre-compiled set of writes selected by one variable value.
+     */
+    struct PatchSet {
+        int value;                ///< Variable value that selects this set
+        std::vector<PatchSetWrite> writes; ///< Writes in configuration order
+        std::vector<unsigned char> bytes;  ///< Decoded bytes of all writes
+    };
+
+    /**
+     * @brief Structure defining a patch group.
+     * @details A group binds one variable to several patch sets. The variable's
+     *          value selects which set is active; any address used by the group
+     *          but not by the active set is restored to its original bytes.
+     */
+    struct PatchGroup {
+        int groupId;              ///< N in QuickPatchGroupN_
+        int variableId;           ///< RPG Maker variable ID to monitor
+        bool applyOnLoadGame;     ///< Whether to apply this group when loading a save game
+        std::vector<PatchSet> sets; ///< Patch sets sorted by value
+        std::vector<PatchSetWrite> footprint; ///< Every address range written by any set (offset unused)
+    };
+
+    /**
+     * @brief Structure defining a memory-to-variable watch.
+     * @details The reverse of a QuickPatchMapping: the value at the address is
+     *          read by the periodic watch sweep and mirrored into the variable.
+     */
+    struct QuickWatch {
+        int watchId;              ///< N in QuickWatchN_
+        int variableId;           ///< RPG Maker variable ID receiving the value
+        unsigned int address;     ///< Memory address to read
+        QuickPatchType type;      ///< 8-bit or 32-bit signed value
     };
 
+    /** @brief Variable bitmap flag: at least one QuickPatchN_ mapping uses the variable. */
+    const unsigned char VARIABLE_HAS_MAPPING = 1;
+    /** @brief Variable bitmap flag: at least one QuickPatchGroupN_ uses the variable. */
+    const unsigned char VARIABLE_HAS_GROUP = 2;
+
     /** @brief Maximum variable ID (default: 1000, configurable in DynRPG.ini) */
     static int maxVariableId = 1000;
+
+    /**
+     * @brief Highest accepted MaxVariableId.
+     * @details The dispatch index is sized from MaxVariableId, so a mistyped
+     *          value must not allocate huge tables. Matches the database limit
+     *          of RPG Maker 2003.
+     */
+    const int MAX_CONFIG_ID = 5000;
     
-    /** @brief Vector storing all quickpatch mappings */
+    /** @brief Vector storing all quickpatch mappings, sorted by variable ID */
     static std::vector<QuickPatchMapping> quickpatchMappings;
 
+    /**
+     * @brief Dispatch index from variable ID to its span of mappings.
+     * @details Sized MaxVariableId + 2. The mappings for variable N occupy
+     *          quickpatchMappings[variablePatchStart[N]] up to (but excluding)
+     *          quickpatchMappings[variablePatchStart[N + 1]].
+     */
+    static std::vector<int> variablePatchStart;
+
+    /**
+     * @brief Indices into quickpatchMappings in configuration order.
+     * @details The mappings are stored sorted by variable for dispatch; passes
+     *          that apply every mapping (load game) walk this list instead, so
+     *          overlapping patches are written in the order they are configured.
+     */
+    static std::vector<int> mappingConfigOrder;
+
+    /** @brief Vector storing all patch groups, sorted by variable ID */
+    static std::vector<PatchGroup> patchGroups;
+
+    /** @brief Indices into patchGroups in configuration order, see mappingConfigOrder. */
+    static std::vector<int> groupConfigOrder;
+
+    /**
+     * @brief Dispatch index from variable ID to its span of patch groups.
+     * @details Same layout as variablePatchStart, over patchGroups.
+     */
+    static std::vector<int> variableGroupStart;
+
+    /**
+     * @brief One byte per variable ID, non-zero if at least one patch uses it.
+     * @details Holds VARIABLE_HAS_MAPPING and VARIABLE_HAS_GROUP flags. Allows
+     *          onSetVariable to reject unpatched variables with a single read.
+     */
+    static std::vector<unsigned char> variableHasPatch;
+
+    /** @brief Vector storing all memory watches, sorted by address */
+    static std::vector<QuickWatch> quickWatches;
+
+    /** @brief Frames between two watch sweeps (default: 1, configurable in DynRPG.ini) */
+    static int watchInterval = 1;
+
     /**
      * @brief Gets the list of quickpatch mappings.
      * @return Reference to the vector of QuickPatchMapping objects.
@@ -54,6 +174,46 @@ namespace DynamicQuickPatchConfig
         return quickpatchMappings;
     }
 
+    /**
+     * @brief Gets the list of patch groups.
+     * @return Reference to the vector of PatchGroup objects.
+     */
+    const std::vector<PatchGroup>& getGroups() {
+        return patchGroups;
+    }
+
+    /**
+     * @brief Gets the configuration order of the quickpatch mappings.
+     * @return Indices into getMappings(), in the order the mappings were configured.
+     */
+    const std::vector<int>& getMappingConfigOrder() {
+        return mappingConfigOrder;
+    }
+
+    /**
+     * @brief Gets the configuration order of the patch groups.
+     * @return Indices into getGroups(), in the order the groups were configured.
+     */
+    const std::vector<int>& getGroupConfigOrder() {
+        return groupConfigOrder;
+    }
+
+    /**
+     * @brief Gets the list of memory watches.
+     * @return Reference to the vector of QuickWatch objects, sorted by address.
+     */
+    const std::vector<QuickWatch>& getWatches() {
+        return quickWatches;
+    }
+
+    /**
+     * @brief Gets the number of frames between two watch sweeps.
+     * @return The configured watch interval, at least 1.
+     */
+    int getWatchInterval() {
+        return watchInterval;
+    }
+
     /**
      * @brief Gets the maximum variable ID.
      * @return The configured maximum variable ID.
@@ -64,6 +224,110 @@ namespace DynamicQuickPatchConfig
         return maxVariableId;
     }
 
+    /**
+     * @brief Checks if any quickpatch mapping uses a variable.
+     * @param variableId The variable ID to check.
+     * @return True if at least one mapping or group is bound to this variable.
+     * @details Constant-time lookup in the variable bitmap built by loadConfig.
+     */
+    bool hasPatchForVariable(int variableId) {
+        return variableId > 0 && variableId <= maxVariableId &&
+               variableHasPatch[variableId] != 0;
+    }
+
+    /**
+     * @brief Gets the contiguous span of mappings bound to a variable.
+     * @param variableId The variable ID to look up.
+     * @param count Receives the number of mappings in the span.
+     * @return Pointer to the first mapping of the span, or nullptr if none.
+     * @see hasPatchForVariable
+     */
+    const QuickPatchMapping* getMappingsForVariable(int variableId, size_t& count) {
+        count = 0;
+        if (!hasPatchForVariable(variableId) || !(variableHasPatch[variableId] & VARIABLE_HAS_MAPPING)) {
+            return nullptr;
+        }
+        int start = variablePatchStart[variableId];
+        count = static_cast<size_t>(variablePatchStart[variableId + 1] - start);
+        return &quickpatchMappings[start];
+    }
+
+    /**
+     * @brief Gets the contiguous span of patch groups bound to a variable.
+     * @param variableId The variable ID to look up.
+     * @param count Receives the number of groups in the span.
+     * @return Pointer to the first group of the span, or nullptr if none.
+     * @see hasPatchForVariable
+     */
+    const PatchGroup* getGroupsForVariable(int variableId, size_t& count) {
+        count = 0;
+        if (!hasPatchForVariable(variableId) || !(variableHasPatch[variableId] & VARIABLE_HAS_GROUP)) {
+            return nullptr;
+        }
+        int start = variableGroupStart[variableId];
+        count = static_cast<size_t>(variableGroupStart[variableId + 1] - start);
+        return &patchGroups[start];
+    }
+
+    /**
+     * @brief Stable-sorts entries by variable ID and records their configuration order.
+     * @param entries Mappings or groups in configuration order; sorted on return.
+     * @param configOrder Receives, for each entry in configuration order, its
+     *        index in the sorted entries.
+     */
+    template <typename Entry>
+    void sortByVariable(std::vector<Entry>& entries, std::vector<int>& configOrder) {
+        std::vector<int> order(entries.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = static_cast<int>(i);
+        }
+        std::stable_sort(order.begin(), order.end(),
+            [&entries](int a, int b) {
+                return entries[a].variableId < entries[b].variableId;
+            });
+
+        std::vector<Entry> sorted;
+        sorted.reserve(entries.size());
+        configOrder.assign(entries.size(), 0);
+        for (size_t i = 0; i < order.size(); i++) {
+            configOrder[order[i]] = static_cast<int>(i);
+            sorted.push_back(std::move(entries[order[i]]));
+        }
+        entries.swap(sorted);
+    }
+
+    /**
+     * @brief Builds the variable-to-mapping dispatch index.
+     * @details Stable-sorts the mappings and groups by variable ID, so entries
+     *          that share a variable keep their configuration order, then records
+     *          the start offset of each variable's span and the has-patch bitmap.
+     *          The configuration order itself is kept in mappingConfigOrder and
+     *          groupConfigOrder.
+     * @note Must be called after maxVariableId and all mappings are loaded.
+     */
+    void buildVariableIndex() {
+        sortByVariable(quickpatchMappings, mappingConfigOrder);
+        sortByVariable(patchGroups, groupConfigOrder);
+
+        variablePatchStart.assign(maxVariableId + 2, 0);
+        variableGroupStart.assign(maxVariableId + 2, 0);
+        variableHasPatch.assign(maxVariableId + 1, 0);
+
+        // Count entries per variable, then convert counts into start offsets
+        for (const auto& mapping : quickpatchMappings) {
+            variablePatchStart[mapping.variableId + 1]++;
+            variableHasPatch[mapping.variableId] |= VARIABLE_HAS_MAPPING;
+        }
+        for (const auto& group : patchGroups) {
+            variableGroupStart[group.variableId + 1]++;
+            variableHasPatch[group.variableId] |= VARIABLE_HAS_GROUP;
+        }
+        for (int id = 1; id <= maxVariableId + 1; id++) {
+            variablePatchStart[id] += variablePatchStart[id - 1];
+            variableGroupStart[id] += variableGroupStart[id - 1];
+        }
+    }
+
     /**
      * @brief Converts a string to an integer with error handling.
      * @param str The string to convert.
@@ -103,6 +367,356 @@ namespace DynamicQuickPatchConfig
         return hexStr.length() % 2 == 0;
     }
 
+    /**
+     * @brief Raw settings of one QuickPatchN_ entry as read from DynRPG.ini.
+     * @details Fields hold the defaults used when a key is omitted.
+     */
+    struct QuickPatchEntry {
+        std::string variableId = "0";   ///< QuickPatchN_VariableId
+        std::string address = "0";      ///< QuickPatchN_Address
+        std::string type;               ///< QuickPatchN_Type
+        std::string hexValue;           ///< QuickPatchN_HexValue
+        std::string onLoadGame = "true"; ///< QuickPatchN_OnLoadGame
+    };
+
+    /**
+     * @brief Raw settings of one QuickPatchGroupN_ entry as read from DynRPG.ini.
+     */
+    struct PatchGroupEntry {
+        std::string variableId = "0";   ///< QuickPatchGroupN_VariableId
+        std::string onLoadGame = "true"; ///< QuickPatchGroupN_OnLoadGame
+        std::map<int, std::string> values; ///< QuickPatchGroupN_Value<V> definitions by V
+    };
+
+    /**
+     * @brief Splits an indexed configuration key into index and field name.
+     * @param key The configuration key (e.g. "QuickPatch12_Address").
+     * @param prefix The key prefix before the index (e.g. "QuickPatch").
+     * @param index Receives the parsed index.
+     * @param field Receives the field name after the underscore.
+     * @return True if the key has the form <prefix><N>_<field> with N > 0.
+     * @details Parses the key in place without building intermediate strings.
+     */
+    bool parseIndexedKey(const std::string& key, const char* prefix, int& index, std::string& field) {
+        size_t prefixLength = strlen(prefix);
+        if (key.compare(0, prefixLength, prefix) != 0) {
+            return false;
+        }
+
+        // Parse the decimal index directly after the prefix
+        size_t pos = prefixLength;
+        int value = 0;
+        while (pos < key.length() && key[pos] >= '0' && key[pos] <= '9') {
+            if (value > (std::numeric_limits<int>::max() - 9) / 10) {
+                return false;
+            }
+            value = value * 10 + (key[pos] - '0');
+            pos++;
+        }
+        if (pos == prefixLength || value <= 0 || pos >= key.length() || key[pos] != '_') {
+            return false;
+        }
+
+        index = value;
+        field.assign(key, pos + 1, std::string::npos);
+        return true;
+    }
+
+    /**
+     * @brief Converts a hexadecimal digit to its value.
+     * @param c The hex digit (0-9, a-f, A-F).
+     * @return The digit value (0-15).
+     * @note The caller must have validated the digit with isValidHexString.
+     */
+    unsigned char hexDigitValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return c - 'A' + 10;
+    }
+
+    /**
+     * @brief Encodes a value as an 8-bit signed integer.
+     * @details The value is expected to be clamped by the caller.
+     */
+    const unsigned char* encode8bit(const QuickPatchMapping& mapping, int value, unsigned char* scratch) {
+        scratch[0] = (unsigned char)(char)value;
+        return scratch;
+    }
+
+    /**
+     * @brief Encodes a value as a 32-bit signed integer in native byte order.
+     */
+    const unsigned char* encode32bit(const QuickPatchMapping& mapping, int value, unsigned char* scratch) {
+        memcpy(scratch, &value, sizeof(int));
+        return scratch;
+    }
+
+    /**
+     * @brief Returns the pre-decoded bytes of a raw hex patch.
+     * @details The variable value only toggles hex patches, so it is not encoded.
+     */
+    const unsigned char* encodeHexRaw(const QuickPatchMapping& mapping, int value, unsigned char* scratch) {
+        return mapping.patchBytes.data();
+    }
+
+    /**
+     * @brief Compiles a mapping into its ready-to-apply representation.
+     * @param mapping The mapping to compile. Type and hexValue must be set.
+     * @details Decodes hex strings into bytes, precomputes the patch size and
+     *          selects the encoder for the patch type.
+     */
+    void compileMapping(QuickPatchMapping& mapping) {
+        mapping.patchBytes.clear();
+        switch (mapping.type) {
+            case QPTYPE_8BIT:
+                mapping.patchSize = 1;
+                mapping.encode = encode8bit;
+                break;
+
+            case QPTYPE_32BIT:
+                mapping.patchSize = sizeof(int);
+                mapping.encode = encode32bit;
+                break;
+
+            case QPTYPE_HEX_RAW:
+                mapping.patchSize = mapping.hexValue.length() / 2;
+                mapping.patchBytes.resize(mapping.patchSize);
+                for (size_t i = 0; i < mapping.patchSize; i++) {
+                    mapping.patchBytes[i] = (hexDigitValue(mapping.hexValue[i * 2]) << 4) |
+                                             hexDigitValue(mapping.hexValue[i * 2 + 1]);
+                }
+                mapping.encode = encodeHexRaw;
+                break;
+        }
+    }
+
+    /**
+     * @brief Removes leading and trailing whitespace.
+     * @param str The string to trim.
+     * @return The trimmed string.
+     */
+    std::string trimString(const std::string& str) {
+        size_t first = str.find_first_not_of(" \t");
+        if (first == std::string::npos) {
+            return std::string();
+        }
+        size_t last = str.find_last_not_of(" \t");
+        return str.substr(first, last - first + 1);
+    }
+
+    /**
+     * @brief Decodes one quickpatch value token.
+     * @param token Hex string, #n (32-bit) or %n (8-bit) as in DynRPG quickpatches.
+     * @param bytes Buffer the decoded bytes are appended to.
+     * @return True if the token is valid.
+     */
+    bool decodePatchToken(const std::string& token, std::vector<unsigned char>& bytes) {
+        if (token.empty()) {
+            return false;
+        }
+
+        // Decimal values in DynRPG notation
+        if (token[0] == '#' || token[0] == '%') {
+            char* endPtr;
+            long value = strtol(token.c_str() + 1, &endPtr, 10);
+            if (token.length() < 2 || *endPtr != '\0') {
+                return false;
+            }
+            if (token[0] == '%') {
+                if (value < -128 || value > 255) {
+                    return false;
+                }
+                bytes.push_back((unsigned char)value);
+            } else {
+                int intValue = (int)value;
+                const unsigned char* valueBytes = (const unsigned char*)&intValue;
+                bytes.insert(bytes.end(), valueBytes, valueBytes + sizeof(int));
+            }
+            return true;
+        }
+
+        // Raw hex bytes
+        if (!isValidHexString(token)) {
+            return false;
+        }
+        for (size_t i = 0; i < token.length(); i += 2) {
+            bytes.push_back((hexDigitValue(token[i]) << 4) | hexDigitValue(token[i + 1]));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Parses a patch set definition.
+     * @param definition Comma-separated address/value pairs in DynRPG quickpatch
+     *                   format (e.g. "0x49E148,EB71,0x49F1CA,%5").
+     * @param set Receives the decoded writes.
+     * @return True if the definition is valid and contains at least one write.
+     */
+    bool parsePatchSet(const std::string& definition, PatchSet& set) {
+        std::stringstream stream(definition);
+        std::string addressToken;
+        std::string valueToken;
+
+        while (std::getline(stream, addressToken, ',')) {
+            if (!std::getline(stream, valueToken, ',')) {
+                return false;
+            }
+            addressToken = trimString(addressToken);
+            valueToken = trimString(valueToken);
+
+            // Parse memory address in hex or decimal format
+            char* endPtr;
+            bool isHex = addressToken.substr(0, 2) == "0x" || addressToken.substr(0, 2) == "0X";
+            unsigned int address = static_cast<unsigned int>(strtoul(addressToken.c_str(), &endPtr, isHex ? 16 : 10));
+            if (addressToken.empty() || *endPtr != '\0' || address == 0) {
+                return false;
+            }
+
+            PatchSetWrite write;
+            write.address = address;
+            write.offset = set.bytes.size();
+            if (!decodePatchToken(valueToken, set.bytes)) {
+                return false;
+            }
+            write.length = set.bytes.size() - write.offset;
+            set.writes.push_back(write);
+        }
+
+        return !set.writes.empty();
+    }
+
+    /**
+     * @brief Checks that a memory range is committed and readable.
+     * @param address Start of the range.
+     * @param length Number of bytes.
+     * @return True if every page of the range can be read.
+     * @details Watches are read every sweep without page protection changes,
+     *          so their addresses are checked once when the configuration loads.
+     */
+    bool isReadableMemory(unsigned int address, size_t length) {
+        unsigned int end = address + static_cast<unsigned int>(length);
+        while (address < end) {
+            MEMORY_BASIC_INFORMATION info;
+            if (VirtualQuery(reinterpret_cast<LPCVOID>(address), &info, sizeof(info)) == 0 ||
+                info.State != MEM_COMMIT || (info.Protect & (PAGE_NOACCESS | PAGE_GUARD)) != 0) {
+                return false;
+            }
+            unsigned int regionEnd = static_cast<unsigned int>(reinterpret_cast<size_t>(info.BaseAddress)) + static_cast<unsigned int>(info.RegionSize);
+            if (regionEnd <= address) {
+                return false;
+            }
+            address = regionEnd;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Raw settings of one QuickWatchN_ entry as read from DynRPG.ini.
+     */
+    struct QuickWatchEntry {
+        std::string variableId = "0";   ///< QuickWatchN_VariableId
+        std::string address = "0";      ///< QuickWatchN_Address
+        std::string type;               ///< QuickWatchN_Type
+    };
+
+    /**
+     * @brief Validates and compiles the QuickWatchN_ entries.
+     * @param watchEntries The collected entries, ordered by N.
+     * @param hasErrors Set to true if an entry was rejected.
+     * @return Number of watches loaded.
+     * @details A watch variable must be within MaxVariableId and must not be
+     *          used by a patch, since the sweep writes variables directly and
+     *          would bypass the patch, nor by another watch, since both would
+     *          write the same variable. The watches are sorted by address so
+     *          the sweep reads memory in order.
+     * @note Must be called after buildVariableIndex.
+     */
+    int loadWatches(const std::map<int, QuickWatchEntry>& watchEntries, bool& hasErrors) {
+        std::vector<int> watchIdByVariable(maxVariableId + 1, 0);
+        for (const auto& indexedEntry : watchEntries) {
+            std::string prefix = "QuickWatch" + std::to_string(indexedEntry.first) + "_";
+            const QuickWatchEntry& entry = indexedEntry.second;
+
+            // Validate variable ID range and patch conflicts
+            int variableId = stringToInt(entry.variableId, 0);
+            if (variableId <= 0 || variableId > maxVariableId || hasPatchForVariable(variableId)) {
+                if (Debug::enableConsole) {
+                    std::cout << "[DynamicQuickPatch - Configuration Error]" << std::endl;
+                    std::cout << "Error in " << prefix << ": Invalid VariableId '" << entry.variableId
+                           << "'. Must be between 1 and " << maxVariableId
+                           << " and not be used by a QuickPatch or QuickPatchGroup." << std::endl;
+                    std::cout << std::endl;
+                }
+                hasErrors = true;
+                continue;
+            }
+            if (watchIdByVariable[variableId] != 0) {
+                if (Debug::enableConsole) {
+                    std::cout << "[DynamicQuickPatch - Configuration Error]" << std::endl;
+                    std::cout << "Error in " << prefix << ": VariableId " << variableId
+                           << " is already used by QuickWatch" << watchIdByVariable[variableId] << "_." << std::endl;
+                    std::cout << std::endl;
+                }
+                hasErrors = true;
+                continue;
+            }
+
+            // Parse and validate value type; hex patches have no value to read
+            QuickWatch watch;
+            watch.watchId = indexedEntry.first;
+            watch.variableId = variableId;
+            if (entry.type == "8bit") {
+                watch.type = QPTYPE_8BIT;
+            } else if (entry.type == "32bit") {
+                watch.type = QPTYPE_32BIT;
+            } else {
+                if (Debug::enableConsole) {
+                    std::cout << "[DynamicQuickPatch - Configuration Error]" << std::endl;
+                    std::cout << "Invalid type '" << entry.type << "' in " << prefix
+                           << ". Must be 8bit or 32bit." << std::endl;
+                    std::cout << std::endl;
+                }
+                hasErrors = true;
+                continue;
+            }
+
+            // Parse memory address in hex or decimal format and check it can be read
+            char* endPtr;
+            const std::string& addressStr = entry.address;
+            bool isHex = addressStr.substr(0, 2) == "0x" || addressStr.substr(0, 2) == "0X";
+            watch.address = static_cast<unsigned int>(strtoul(addressStr.c_str(), &endPtr, isHex ? 16 : 10));
+            size_t length = (watch.type == QPTYPE_8BIT) ? 1 : sizeof(int);
+            if (*endPtr != '\0' || watch.address == 0 || watch.address >= 0xFFFFFFFF - length ||
+                !isReadableMemory(watch.address, length)) {
+                if (Debug::enableConsole) {
+                    std::cout << "[DynamicQuickPatch - Configuration Error]" << std::endl;
+                    std::cout << "Error in " << prefix << ": Address '" << addressStr << "' is invalid or not readable" << std::endl;
+                    std::cout << std::endl;
+                }
+                hasErrors = true;
+                continue;
+            }
+
+            if (Debug::enableConsole) {
+                std::cout << "[DynamicQuickPatch - Configuration]" << std::endl;
+                std::cout << prefix << " Configuration:" << std::endl;
+                std::cout << "VariableId: " << variableId << std::endl;
+                std::cout << "Address: " << addressStr << std::endl;
+                std::cout << "Type: " << entry.type << std::endl;
+                std::cout << std::endl;
+            }
+
+            watchIdByVariable[variableId] = watch.watchId;
+            quickWatches.push_back(watch);
+        }
+
+        std::stable_sort(quickWatches.begin(), quickWatches.end(),
+            [](const QuickWatch& a, const QuickWatch& b) {
+                return a.address < b.address;
+            });
+        return static_cast<int>(quickWatches.size());
+    }
+
     /**
      * @brief Loads plugin configuration from DynRPG.ini.
      * @param pluginName Name of the plugin section in the INI file.
@@ -110,15 +724,21 @@ namespace DynamicQuickPatchConfig
      * @details Reads and validates all configuration settings from DynRPG.ini:
      *          - Debug console settings
      *          - Maximum variable ID
-     *          - QuickPatch mappings (up to 100 entries)
+     *          - QuickPatch mappings (any number of entries)
+     *          - QuickPatchGroup patch groups (any number of entries)
+     *          - QuickWatch memory watches and the watch interval
      * @note Invalid entries are skipped with appropriate debug output.
+     *       QuickPatchN_ keys are collected in a single pass over the
+     *       configuration, so N has no upper limit and gaps are allowed.
      */
     bool loadConfig(char* pluginName) {
         // Reset configuration state before loading
         quickpatchMappings.clear();
+        patchGroups.clear();
+        quickWatches.clear();
         
         // Load configuration from DynRPG.ini
-        std::map<std::string, std::string> config = RPG::loadConfiguration(pluginName);
+        std::map<std::string, std::string> config = IniCache::loadConfiguration(pluginName);
         
         // Initialize debug console with default disabled state
         Debug::enableConsole = false;
@@ -128,6 +748,7 @@ namespace DynamicQuickPatchConfig
         
         // Initialize debug console if enabled
         if (Debug::enableConsole) {
+            Debug::loadOutputSettings(config);
             Debug::initConsole();
             
             std::cout << "[DynamicQuickPatch - Configuration]" << std::endl;
@@ -142,46 +763,91 @@ namespace DynamicQuickPatchConfig
             if (maxVariableId <= 0) {
                 maxVariableId = 1000;
             }
+            if (maxVariableId > MAX_CONFIG_ID) {
+                if (Debug::enableConsole) {
+                    std::cout << "[DynamicQuickPatch - Configuration]" << std::endl;
+                    std::cout << "MaxVariableId=" << maxVariableId << " exceeds " << MAX_CONFIG_ID
+                              << ", using " << MAX_CONFIG_ID << "." << std::endl;
+                    std::cout << std::endl;
+                }
+                maxVariableId = MAX_CONFIG_ID;
+            }
         } else {
             maxVariableId = 1000;
         }
+
+        // Load watch sweep interval with fallback to every frame
+        watchInterval = 1;
+        if (config.find("WatchInterval") != config.end()) {
+            watchInterval = std::max(1, stringToInt(config["WatchInterval"], 1));
+        }
         
         int quickpatchCount = 0;
         bool hasErrors = false;
         
-        // Process up to 100 QuickPatch entries
-        for (int i = 1; i <= 100; i++) {
-            std::string prefix = "QuickPatch" + std::to_string(i) + "_";
-            
-            // Check for existence of any settings with this prefix
-            bool entryExists = false;
-            for (const auto& pair : config) {
-                if (pair.first.find(prefix) == 0) {
-                    entryExists = true;
-                    break;
+        // Collect all QuickPatchN_, QuickPatchGroupN_ and QuickWatchN_ settings in a single pass, ordered by N
+        std::map<int, QuickPatchEntry> entries;
+        std::map<int, PatchGroupEntry> groupEntries;
+        std::map<int, QuickWatchEntry> watchEntries;
+        std::string field;
+        for (const auto& pair : config) {
+            int index = 0;
+            if (parseIndexedKey(pair.first, "QuickWatch", index, field)) {
+                QuickWatchEntry& watchEntry = watchEntries[index];
+                if (field == "VariableId") {
+                    watchEntry.variableId = pair.second;
+                } else if (field == "Address") {
+                    watchEntry.address = pair.second;
+                } else if (field == "Type") {
+                    watchEntry.type = pair.second;
                 }
+                continue;
             }
-            
-            // Skip if no settings found for this index
-            if (!entryExists) {
+            if (parseIndexedKey(pair.first, "QuickPatchGroup", index, field)) {
+                PatchGroupEntry& groupEntry = groupEntries[index];
+                if (field == "VariableId") {
+                    groupEntry.variableId = pair.second;
+                } else if (field == "OnLoadGame") {
+                    groupEntry.onLoadGame = pair.second;
+                } else if (field.compare(0, 5, "Value") == 0 && field.length() > 5) {
+                    char* endPtr;
+                    long value = strtol(field.c_str() + 5, &endPtr, 10);
+                    if (*endPtr == '\0') {
+                        groupEntry.values[(int)value] = pair.second;
+                    }
+                }
                 continue;
             }
-        
+            if (!parseIndexedKey(pair.first, "QuickPatch", index, field)) {
+                continue;
+            }
+
+            QuickPatchEntry& entry = entries[index];
+            if (field == "VariableId") {
+                entry.variableId = pair.second;
+            } else if (field == "Address") {
+                entry.address = pair.second;
+            } else if (field == "Type") {
+                entry.type = pair.second;
+            } else if (field == "HexValue") {
+                entry.hexValue = pair.second;
+            } else if (field == "OnLoadGame") {
+                entry.onLoadGame = pair.second;
+            }
+        }
+
+        // Process all QuickPatch entries
+        for (const auto& indexedEntry : entries) {
+            int i = indexedEntry.first;
+            std::string prefix = "QuickPatch" + std::to_string(i) + "_";
+
             // Extract configuration values with appropriate defaults
-            std::string varIdStr = config.find(prefix + "VariableId") != config.end() 
-                ? config[prefix + "VariableId"] : "0";
-            
-            std::string addressStr = config.find(prefix + "Address") != config.end() 
-                ? config[prefix + "Address"] : "0";
-            
-            std::string typeStr = config.find(prefix + "Type") != config.end() 
-                ? config[prefix + "Type"] : "";
-            
-            std::string hexValueStr = config.find(prefix + "HexValue") != config.end() 
-                ? config[prefix + "HexValue"] : "";
-            
-            std::string onLoadGameStr = config.find(prefix + "OnLoadGame") != config.end() 
-                ? config[prefix + "OnLoadGame"] : "true";
+            const QuickPatchEntry& entry = indexedEntry.second;
+            const std::string& varIdStr = entry.variableId;
+            const std::string& addressStr = entry.address;
+            const std::string& typeStr = entry.type;
+            const std::string& hexValueStr = entry.hexValue;
+            const std::string& onLoadGameStr = entry.onLoadGame;
             
             // Log configuration details in debug mode
             if (Debug::enableConsole) {
@@ -293,16 +959,101 @@ namespace DynamicQuickPatchConfig
             mapping.type = type;
             mapping.hexValue = hexValueStr;
             mapping.applyOnLoadGame = applyOnLoadGame;
+            compileMapping(mapping);
             
             quickpatchMappings.push_back(mapping);
             quickpatchCount++;
         }
+
+        // Process all QuickPatchGroup entries
+        int groupCount = 0;
+        for (const auto& indexedEntry : groupEntries) {
+            std::string prefix = "QuickPatchGroup" + std::to_string(indexedEntry.first) + "_";
+            const PatchGroupEntry& entry = indexedEntry.second;
+
+            // Validate variable ID range
+            int variableId = stringToInt(entry.variableId, 0);
+            if (variableId <= 0 || variableId > maxVariableId) {
+                if (Debug::enableConsole) {
+                    std::cout << "[DynamicQuickPatch - Configuration Error]" << std::endl;
+                    std::cout << "Error in " << prefix << ": Invalid VariableId '" << entry.variableId
+                           << "'. Must be between 1 and " << maxVariableId << "." << std::endl;
+                    std::cout << std::endl;
+                }
+                hasErrors = true;
+                continue;
+            }
+
+            PatchGroup group;
+            group.groupId = indexedEntry.first;
+            group.variableId = variableId;
+            group.applyOnLoadGame = entry.onLoadGame == "true";
+
+            // Compile every value's patch set (std::map keeps them sorted by value)
+            for (const auto& valueEntry : entry.values) {
+                PatchSet set;
+                set.value = valueEntry.first;
+                if (!parsePatchSet(valueEntry.second, set)) {
+                    if (Debug::enableConsole) {
+                        std::cout << "[DynamicQuickPatch - Configuration Error]" << std::endl;
+                        std::cout << "Invalid patch set in " << prefix << "Value" << valueEntry.first << std::endl;
+                        std::cout << std::endl;
+                    }
+                    hasErrors = true;
+                    continue;
+                }
+                for (const auto& write : set.writes) {
+                    group.footprint.push_back(write);
+                }
+                group.sets.push_back(set);
+            }
+
+            if (group.sets.empty()) {
+                if (Debug::enableConsole) {
+                    std::cout << "[DynamicQuickPatch - Configuration]" << std::endl;
+                    std::cout << "Skipping " << prefix << " because it has no valid patch sets" << std::endl;
+                    std::cout << std::endl;
+                }
+                continue;
+            }
+
+            // Keep each address range of the footprint once
+            std::sort(group.footprint.begin(), group.footprint.end(),
+                [](const PatchSetWrite& a, const PatchSetWrite& b) {
+                    return a.address < b.address || (a.address == b.address && a.length < b.length);
+                });
+            group.footprint.erase(std::unique(group.footprint.begin(), group.footprint.end(),
+                [](const PatchSetWrite& a, const PatchSetWrite& b) {
+                    return a.address == b.address && a.length == b.length;
+                }), group.footprint.end());
+
+            if (Debug::enableConsole) {
+                std::cout << "[DynamicQuickPatch - Configuration]" << std::endl;
+                std::cout << prefix << " Configuration:" << std::endl;
+                std::cout << "VariableId: " << variableId << std::endl;
+                std::cout << "Patch Sets: " << group.sets.size() << std::endl;
+                std::cout << "Addresses: " << group.footprint.size() << std::endl;
+                std::cout << "OnLoadGame: " << entry.onLoadGame << std::endl;
+                std::cout << std::endl;
+            }
+
+            patchGroups.push_back(group);
+            groupCount++;
+        }
         
+        // Build the variable dispatch index used by onSetVariable
+        buildVariableIndex();
+
+        // Watches are checked against the patched variables in the index
+        int watchCount = loadWatches(watchEntries, hasErrors);
+
         // Log configuration summary
         if (Debug::enableConsole) {
             std::cout << "[DynamicQuickPatch - Configuration Summary]" << std::endl;
             std::cout << "Configuration loaded successfully." << std::endl;
             std::cout << "Loaded " << quickpatchCount << " quickpatch mappings." << std::endl;
+            std::cout << "Loaded " << groupCount << " patch groups." << std::endl;
+            std::cout << "Loaded " << watchCount << " memory watches (every " << watchInterval << " frames)." << std::endl;
             std::cout << "Maximum Variable ID: " << maxVariableId << std::endl;
             if (hasErrors) {
                 std::cout << "Warning: Some entries had errors and were skipped." << std::endl;
@@ -2,8 +2,12 @@
  * @file dynamic_quickpatch_debug.cpp
  * @brief Debugging utilities for the DynamicQuickPatch plugin.
  * @details Provides console output functionality for debugging purposes.
+ *          Output is written through the shared asynchronous log, so debug
+ *          messages do not block the game thread.
  */
 
+#include "../common/async_log.cpp"
+
 /**
  * @namespace Debug
  * @brief Contains debugging utilities and console management functions.
@@ -18,11 +22,44 @@ namespace Debug
     /** @brief Tracks whether the console has been initialized. */
     bool consoleInitialized = false;
 
+    /** @brief Tracks whether a console window was allocated by this plugin. */
+    bool consoleAllocated = false;
+
+    /** @brief Selected debug output sinks (AsyncLog::SINK_CONSOLE and/or AsyncLog::SINK_FILE). */
+    int outputSinks = AsyncLog::SINK_CONSOLE;
+
+    /** @brief Path of the log file used by the file sink. */
+    std::string logFilePath = "dynamic_quickpatch_debug.log";
+
+    /**
+     * @brief Reads the debug output settings.
+     * @param configuration The plugin's settings from DynRPG.ini.
+     * @details Reads DebugOutput (console, file or both, default console) and
+     *          DebugLogFile (default dynamic_quickpatch_debug.log).
+     * @note Must be called before initConsole().
+     */
+    void loadOutputSettings(std::map<std::string, std::string>& configuration) {
+        outputSinks = AsyncLog::SINK_CONSOLE;
+        if (configuration.find("DebugOutput") != configuration.end()) {
+            const std::string& output = configuration["DebugOutput"];
+            if (output == "file") {
+                outputSinks = AsyncLog::SINK_FILE;
+            } else if (output == "both") {
+                outputSinks = AsyncLog::SINK_CONSOLE | AsyncLog::SINK_FILE;
+            }
+        }
+        if (configuration.find("DebugLogFile") != configuration.end() && !configuration["DebugLogFile"].empty()) {
+            logFilePath = configuration["DebugLogFile"];
+        }
+    }
+
     /**
      * @brief Initializes a console window for debug output.
      * @details Creates and attaches a console window to the application
      *          if one doesn't already exist. It redirects standard output and input
      *          to this console, allowing for debug messages to be displayed.
+     *          Then starts the asynchronous log for the selected sinks, which
+     *          takes over std::cout until cleanupConsole() is called.
      * @note This function is idempotent - it will only initialize the console once.
      *       Subsequent calls will have no effect until cleanupConsole() is called.
      * @warning On Windows, this uses the Win32 API's AllocConsole() function,
@@ -31,18 +68,23 @@ namespace Debug
      */
     void initConsole() {
         if (!consoleInitialized && enableConsole) {
-            if (AllocConsole()) {
+            if ((outputSinks & AsyncLog::SINK_CONSOLE) && AllocConsole()) {
                 // Redirect standard output and input streams
                 freopen("CONOUT$", "w", stdout);
                 freopen("CONIN$", "r", stdin);
-
-                // Mark console as ready for use
-                consoleInitialized = true;
+                consoleAllocated = true;
 
                 // Clear any stream error states
                 std::cout.clear();
                 std::cin.clear();
             }
+
+            // Start the background writer for the available sinks
+            int sinks = (consoleAllocated ? AsyncLog::SINK_CONSOLE : 0) | (outputSinks & AsyncLog::SINK_FILE);
+            if (sinks != 0 && AsyncLog::start(sinks, logFilePath.c_str())) {
+                // Mark console as ready for use
+                consoleInitialized = true;
+            }
         }
     }
 
@@ -57,15 +99,22 @@ namespace Debug
      */
     void cleanupConsole() {
         if (consoleInitialized) {
-            // Ensure pending output is written
+            // Ensure pending output is written; in the suite build the log and console are
+            // shared and released by the suite after every module exited
+            if (!AsyncLog::detach()) {
+                return;
+            }
             std::cout.flush();
 
-            // Close redirected stream handles
-            fclose(stdout);
-            fclose(stdin);
+            if (consoleAllocated) {
+                // Close redirected stream handles
+                fclose(stdout);
+                fclose(stdin);
 
-            // Free system console resources
-            FreeConsole();
+                // Free system console resources
+                FreeConsole();
+                consoleAllocated = false;
+            }
 
             // Mark console as uninitialized
             consoleInitialized = false;
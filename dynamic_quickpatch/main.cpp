@@ -15,18 +15,22 @@
 #include <iostream>   // For console output
 #include <limits>     // For numeric limits
 #include <map>        // For configuration and memory storage
-#include <set>        // For storing unique indices
 #include <sstream>    // For string formatting
 #include <string>     // For text processing
 #include <vector>     // For storing quickpatch mappings
 #include <stdio.h>    // For freopen, stdout, stdin
 #include <stdlib.h>   // For atoi
 #include <stdint.h>   // For standard integer types
+#include <string.h>   // For memcpy
 #include <windows.h>  // For console functions and memory operations
 
 // Main implementation file - contains all namespaced code
 #include "dynamic_quickpatch.cpp"
 
+// Opt-in callback profiler and trace recorder
+#include "../common/profiler.cpp"
+#include "../common/trace_recorder.cpp"
+
 /**
  * @defgroup callbacks DynRPG Plugin Callbacks
  * @brief Global callback functions called by the DynRPG system.
@@ -43,6 +47,8 @@
  * @see DynamicQuickPatch::onStartup
  */
 bool onStartup(char *pluginName) {
+    Profiler::start(pluginName);
+    TraceRecorder::start(pluginName);
     return DynamicQuickPatch::onStartup(pluginName);
 }
 
@@ -53,6 +59,8 @@ bool onStartup(char *pluginName) {
  * @see DynamicQuickPatch::onNewGame
  */
 void onNewGame() {
+    TraceRecorder::Call trace(TraceRecorder::TR_NEW_GAME);
+    Profiler::Scope scope(Profiler::PC_ON_NEW_GAME);
     DynamicQuickPatch::onNewGame();
 }
 
@@ -65,6 +73,8 @@ void onNewGame() {
  * @see DynamicQuickPatch::onLoadGame
  */
 void onLoadGame(int id, char* data, int length) {
+    TraceRecorder::Call trace(TraceRecorder::TR_LOAD_GAME, id, length);
+    Profiler::Scope scope(Profiler::PC_ON_LOAD_GAME);
     DynamicQuickPatch::onLoadGame(id, data, length);
 }
 
@@ -75,6 +85,8 @@ void onLoadGame(int id, char* data, int length) {
  */
 void onExit() {
     DynamicQuickPatch::onExit();
+    Profiler::stop();
+    TraceRecorder::stop();
 }
 
 /**
@@ -85,6 +97,8 @@ void onExit() {
  * @see DynamicQuickPatch::onFrame
  */
 void onFrame(RPG::Scene scene) {
+    TraceRecorder::Call trace(TraceRecorder::TR_FRAME, scene);
+    Profiler::Scope scope(Profiler::PC_ON_FRAME);
     DynamicQuickPatch::onFrame(scene);
 }
 
@@ -98,7 +112,18 @@ void onFrame(RPG::Scene scene) {
  * @see DynamicQuickPatch::onSetVariable
  */
 bool onSetVariable(int id, int value) {
-    return DynamicQuickPatch::onSetVariable(id, value);
+    TraceRecorder::Call trace(TraceRecorder::TR_SET_VARIABLE, id, value);
+    Profiler::Scope scope(Profiler::PC_ON_SET_VARIABLE);
+    return trace.result(DynamicQuickPatch::onSetVariable(id, value));
+}
+
+/**
+ * @brief Called after the screen was drawn.
+ * @note Draws the profiler overlay while it is enabled and its switch is ON.
+ * @see Profiler::drawOverlay
+ */
+void onDrawScreen() {
+    Profiler::drawOverlay();
 }
 
 /** @} */ // end of callbacks group
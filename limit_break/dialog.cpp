@@ -1,42 +1,129 @@
 /* 
  * Dialog functions for the Limit Break plugin.
  * Contains helper functions for showing debug messages.
+ * Debug messages are written to a non-modal trace log (file and/or console)
+ * through the shared asynchronous log, so they never pause the battle.
  */
 
+#include "../common/async_log.cpp"
+
 namespace Dialog
 {
 
+// Whether the trace log is running
+static bool traceInitialized = false;
+
+// Whether a console window was allocated for the trace log
+static bool traceConsoleAllocated = false;
+
+/**
+ * @brief Starts the non-modal debug trace log
+ * 
+ * @param config The plugin's settings from DynRPG.ini
+ * 
+ * @note Reads DebugOutput (file, console or both, default file) and
+ *       DebugLogFile (default limit_break_debug.log).
+ *       Only called when EnableDebugMessages is true.
+ */
+void InitTrace(std::map<std::string, std::string>& config)
+{
+    if (traceInitialized) return;
+
+    // Select the trace sinks
+    int sinks = AsyncLog::SINK_FILE;
+    if (config.find("DebugOutput") != config.end()) {
+        if (config["DebugOutput"] == "console") {
+            sinks = AsyncLog::SINK_CONSOLE;
+        } else if (config["DebugOutput"] == "both") {
+            sinks = AsyncLog::SINK_CONSOLE | AsyncLog::SINK_FILE;
+        }
+    }
+
+    std::string logFile = "limit_break_debug.log";
+    if (config.find("DebugLogFile") != config.end() && !config["DebugLogFile"].empty()) {
+        logFile = config["DebugLogFile"];
+    }
+
+    // Attach a console window for the console sink
+    if ((sinks & AsyncLog::SINK_CONSOLE) && AllocConsole()) {
+        freopen("CONOUT$", "w", stdout);
+        traceConsoleAllocated = true;
+    }
+    if (!traceConsoleAllocated) {
+        sinks &= ~AsyncLog::SINK_CONSOLE;
+    }
+
+    traceInitialized = sinks != 0 && AsyncLog::start(sinks, logFile.c_str());
+}
+
+/**
+ * @brief Writes all pending trace output and stops the trace log
+ * 
+ * @note Called from onExit, safe to call if the trace was never started.
+ *       In the suite build the log is shared, so this does nothing until
+ *       the suite has stopped it and calls CloseTrace again.
+ */
+void CloseTrace()
+{
+    if (!traceInitialized) return;
+
+    if (!AsyncLog::detach()) return;
+    if (traceConsoleAllocated) {
+        fclose(stdout);
+        FreeConsole();
+        traceConsoleAllocated = false;
+    }
+    traceInitialized = false;
+}
+
 /**
- * @brief Displays an integer value in a message box
+ * @brief Writes an integer value to the debug trace
  * 
  * @param value The integer value to display
- * @param caption The window caption/title for the message box
+ * @param caption The caption of the trace record
  * 
  * @note This function is primarily used for debugging purposes
  */
 void Show(int value, const std::string& caption)
 {
-    std::stringstream stream;
-    stream.clear();
-    stream << value;
-    MessageBoxA(NULL, stream.str().c_str(), caption.c_str(), MB_OK);
+    if (!traceInitialized) return;
+    AsyncLog::writef(caption.c_str(), "%d", value);
 }
 
 /**
- * @brief Displays a text message in a message box
+ * @brief Writes a text message to the debug trace
  * 
  * @param text The text message to display
- * @param caption The window caption/title for the message box
+ * @param caption The caption of the trace record
  * 
- * @note This function is primarily used for debugging purposes
+ * @note This function is primarily used for debugging purposes.
+ *       The record is queued and written by the log thread, the
+ *       game keeps running. It is queued with a single write so
+ *       records from other modules cannot end up inside it.
  */
 void Show(const std::string& text, const std::string& caption)
 {
-    MessageBoxA(NULL, text.c_str(), caption.c_str(), MB_OK);
+    if (!traceInitialized) return;
+
+    // Records longer than AsyncLog::writef's buffer (e.g. the configuration
+    // summary) are assembled in full instead of being truncated
+    if (caption.length() + text.length() + 5 < AsyncLog::AL_RECORD_SIZE) {
+        AsyncLog::writef(caption.c_str(), "%s", text.c_str());
+        return;
+    }
+
+    std::string record;
+    record.reserve(caption.length() + text.length() + 5);
+    record += '[';
+    record += caption;
+    record += "]\n";
+    record += text;
+    record += "\n\n";
+    AsyncLog::write(record.data(), record.length());
 }
 
 /**
- * @brief Displays a text message with the default "Limit Break Debug" caption
+ * @brief Writes a text message with the default "Limit Break Debug" caption
  * 
  * @param value The text message to display
  * 
@@ -48,11 +135,25 @@ void Show(const std::string& value)
 }
 
 /**
- * @brief Displays a message only once during program execution
+ * @brief Displays a modal message box
  * 
  * @param text The text message to display
  * @param caption The window caption/title for the message box
  * 
+ * @note Reserved for errors the user must see, such as an invalid
+ *       configuration at startup. Blocks until the box is closed.
+ */
+void Alert(const std::string& text, const std::string& caption)
+{
+    MessageBoxA(NULL, text.c_str(), caption.c_str(), MB_OK);
+}
+
+/**
+ * @brief Writes a message only once during program execution
+ * 
+ * @param text The text message to display
+ * @param caption The caption of the trace record
+ * 
  * @note Useful for notifications that should only appear once
  *       regardless of how many times the code path is executed
  */
@@ -8,7 +8,9 @@
 #include <DynRPG/DynRPG.h>
 
 // Include our modular code
+#include "../common/party_snapshot.cpp"
 #include "dialog.cpp"
+#include "limit_break_modes.cpp"
 #include "limit_break_config.cpp"
 #include "limit_break_calculate.cpp"
 #include "limit_break_graphics.cpp"
@@ -22,6 +24,9 @@ static bool limitCommandSelected = false;
 // Flag to track if Ultimate Limit command was selected
 static bool ultimateLimitCommandSelected = false;
 
+// Flag to track if the battle action window was visible on its last draw
+static bool actionWindowWasVisible = false;
+
 /**
  * @brief Initializes the Limit Break plugin
  * 
@@ -35,6 +40,16 @@ bool onStartup(char *pluginName) {
     return LimitBreakConfig::LoadConfig(pluginName);
 }
 
+/**
+ * @brief Preloads session resources once the game is initialized
+ * 
+ * @note Decodes the Ultimate Limit Bar images before the title screen,
+ *       so the first battle does not stall on file I/O
+ */
+void onInitFinished() {
+    LimitBreakGraphics::preloadUltimateBarImages();
+}
+
 /**
  * @brief Monitors the battle command selection
  * 
@@ -58,7 +73,7 @@ bool onDrawBattleStatusWindow(int x, int selection, bool selActive, bool isTarge
         if (!actor) return true;
 
         // Note: x is the battle position index (0-3), but we need to use actor->id (database ID)
-        // when looking up configurations in actorConfig
+        // when looking up actor profiles
         
         // Initialize command selection flags to false
         limitCommandSelected = false;
@@ -93,8 +108,16 @@ bool onDrawBattleStatusWindow(int x, int selection, bool selActive, bool isTarge
  * 
  * @note Used to draw the ultimate limit bar on top of all battle elements
  *       The drawing itself is delegated to LimitBreakGraphics::drawUltimateLimitBar
+ *       With DamageDetection=action, HP changes that arrived after the last
+ *       action was done are settled once when the window opens, so the gauge
+ *       is current during command input
  */
 bool onDrawBattleActionWindow(int* x, int* y, int selection, bool selActive, bool isVisible) {
+    if (isVisible && !actionWindowWasVisible && !LimitBreakConfig::pollDamageEveryFrame) {
+        LimitBreakCalculate::checkDamageAndApplyGain();
+    }
+    actionWindowWasVisible = isVisible;
+
     // Draw the ultimate limit bar on top of all battle elements
     LimitBreakGraphics::drawUltimateLimitBar();
     return true;
@@ -108,7 +131,8 @@ bool onDrawBattleActionWindow(int* x, int* y, int selection, bool selActive, boo
  * @return bool Always returns true to continue normal processing
  * 
  * @note This function:
- *       1. Stops any ongoing damage monitoring from previous actions
+ *       1. Stops any ongoing damage monitoring from previous actions,
+ *          settling the previous action's damage ledger first
  *       2. Records which battler is performing the action
  *       3. For actors using the Limit command, checks if limit gauge is at 100%
  *          If so, converts the action from Attack to a specific Limit Skill
@@ -119,26 +143,17 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
     // Original damage monitoring code
     if (!firstTry) return true;
 
-    std::string actionType;
-    std::string battlerInfo;
-    
-    if (battler->isMonster()) {
-        RPG::Monster* monster = reinterpret_cast<RPG::Monster*>(battler);
-        battlerInfo = "Monster " + std::to_string(monster->id);
-    } else {
-        RPG::Actor* actor = reinterpret_cast<RPG::Actor*>(battler);
-        battlerInfo = "Actor " + std::to_string(actor->id);
-    }
-
     // If we're monitoring damage, stop monitoring
     if (LimitBreakCalculate::monitoringDamage) {
+        // Settle HP changes that arrived after the previous action was done
+        if (!LimitBreakConfig::pollDamageEveryFrame) {
+            LimitBreakCalculate::checkDamageAndApplyGain();
+        }
         LimitBreakCalculate::monitoringDamage = false;
         
-        if (LimitBreakConfig::enableDebugMessages) {
-            std::string debugMessage = "Damage Monitoring Stopped\n";
-            debugMessage += "New Action Starting: " + battlerInfo;
-            Dialog::Show(debugMessage, "Limit Break - Monitoring Status");
-        }
+        ASYNC_LOGF(LimitBreakConfig::enableDebugMessages, "Limit Break - Monitoring Status",
+                   "Damage Monitoring Stopped\nNew Action Starting: %s %d",
+                   battler->isMonster() ? "Monster" : "Actor", battler->id);
     }
 
     // Now proceed with the new action
@@ -167,9 +182,9 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
                 
                 // Get the actor's limit variable and skill ID
                 int actorId = LimitBreakCalculate::lastActionActor->id; // Use database ID, not battle position
-                auto cfgIt = LimitBreakConfig::actorConfig.find(actorId);
-                if (cfgIt != LimitBreakConfig::actorConfig.end()) {
-                    int limitVarId = std::get<0>(cfgIt->second);
+                LimitBreakConfig::ActorProfile* profile = LimitBreakConfig::getActorProfile(actorId);
+                if (profile) {
+                    int limitVarId = profile->limitVarId;
                     int limitValue = RPG::variables[limitVarId];
                     
                     // Get the actor's limit skill ID using the helper function
@@ -181,16 +196,12 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
                         action->kind = RPG::AK_SKILL;
                         action->skillId = limitSkillId;
                         
-                        if (LimitBreakConfig::enableDebugMessages) {
-                            std::string debugMessage = "Limit Break Used!\n";
-                            debugMessage += "Actor: " + std::to_string(actorId) + "\n";
-                            debugMessage += "Skill ID: " + std::to_string(limitSkillId) + "\n";
-                            debugMessage += "Limit gauge reset from 100% to 0%";
-                            Dialog::Show(debugMessage, "Limit Break - Limit Used");
-                        }
+                        ASYNC_LOGF(LimitBreakConfig::enableDebugMessages, "Limit Break - Limit Used",
+                                   "Limit Break Used!\nActor: %d\nSkill ID: %d\nLimit gauge reset from 100%% to 0%%",
+                                   actorId, limitSkillId);
                         
                         // Reset the limit gauge to 0
-                        RPG::variables[limitVarId] = 0;
+                        LimitBreakCalculate::setLimitValue(limitVarId, 0);
                         
                         // Update the ultimate limit bar after using a limit break
                         LimitBreakCalculate::updateUltimateLimitBar();
@@ -246,10 +257,9 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
                         RPG::Actor* partyMember = RPG::Actor::partyMember(i);
                         if (partyMember) {
                             int memberId = partyMember->id;
-                            auto cfgIt = LimitBreakConfig::actorConfig.find(memberId);
-                            if (cfgIt != LimitBreakConfig::actorConfig.end()) {
-                                int limitVarId = std::get<0>(cfgIt->second);
-                                RPG::variables[limitVarId] = 0;
+                            LimitBreakConfig::ActorProfile* profile = LimitBreakConfig::getActorProfile(memberId);
+                            if (profile) {
+                                LimitBreakCalculate::setLimitValue(profile->limitVarId, 0);
                             }
                         }
                     }
@@ -260,13 +270,10 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
                     // Update battle events to refresh command display
                     RPG::updateBattleEvents(RPG::BEUM_BATTLE_START, nullptr);
                     
-                    if (LimitBreakConfig::enableDebugMessages) {
-                        std::string debugMessage = "Ultimate Limit Break Used!\n";
-                        debugMessage += "Actor: " + std::to_string(actorId) + "\n";
-                        debugMessage += "Ultimate Skill ID: " + std::to_string(ultimateLimitSkillId) + "\n";
-                        debugMessage += "Ultimate gauge and all actor limit gauges reset to 0%";
-                        Dialog::Show(debugMessage, "Limit Break - Ultimate Limit Used");
-                    }
+                    ASYNC_LOGF(LimitBreakConfig::enableDebugMessages, "Limit Break - Ultimate Limit Used",
+                               "Ultimate Limit Break Used!\nActor: %d\nUltimate Skill ID: %d\n"
+                               "Ultimate gauge and all actor limit gauges reset to 0%%",
+                               actorId, ultimateLimitSkillId);
                     
                     // Reset the flag
                     ultimateLimitCommandSelected = false;
@@ -282,22 +289,9 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
     }
 
     // Record HP of all relevant battlers before action
-    LimitBreakCalculate::preHP.clear();
-
-    // Always record HP of all actors for both actor and monster actions
-    // This is needed for both damage tracking and healing tracking
-    for (int i = 1; i <= RPG::actors.count(); ++i) { // Actor IDs start at 1
-        RPG::Actor* a = RPG::actors[i];
-        if (a) LimitBreakCalculate::preHP[a] = a->hp;
-    }
-
-    // Record monster HP only when an actor acts (for damage tracking)
-    if (LimitBreakCalculate::nextIsActorAction) {
-        for (int i = 0; i < RPG::monsters.count(); ++i) {
-            RPG::Monster* m = RPG::monsters[i];
-            if (m) LimitBreakCalculate::preHP[m] = m->hp;
-        }
-    }
+    // Party HP is always recorded (damage and healing tracking),
+    // monster HP only when an actor acts (damage tracking)
+    LimitBreakCalculate::takeHpSnapshot(LimitBreakCalculate::nextIsActorAction);
 
     return true;
 }
@@ -311,32 +305,29 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
  * 
  * @note This function:
  *       1. Starts damage monitoring to track HP changes for limit gain
- *       2. The actual damage detection occurs in the onFrame callback
+ *       2. With DamageDetection=action, settles the HP changes of the action
+ *          right away; with DamageDetection=frame, detection occurs in the
+ *          onFrame callback
  *       3. Records which battler performed the action for proper attribution
  *       4. Updates the ultimate limit bar after the action completes
  */
 bool onBattlerActionDone(RPG::Battler* battler, bool success) {
     if (!success) return true;
 
-    std::string battlerInfo;
-    
-    if (battler->isMonster()) {
-        RPG::Monster* monster = reinterpret_cast<RPG::Monster*>(battler);
-        battlerInfo = "Monster " + std::to_string(monster->id);
-    } else {
-        RPG::Actor* actor = reinterpret_cast<RPG::Actor*>(battler);
-        battlerInfo = "Actor " + std::to_string(actor->id);
-    }
-
     // For both actor and monster actions, start monitoring damage
     if (battler) {
         LimitBreakCalculate::monitoringDamage = true;
         
-        if (LimitBreakConfig::enableDebugMessages) {
-            std::string debugMessage = "Damage Monitoring Started\n";
-            debugMessage += "Action Completed: " + battlerInfo + "\n";
-            debugMessage += "Monitoring for multi-hit damage/healing...";
-            Dialog::Show(debugMessage, "Limit Break - Monitoring Status");
+        ASYNC_LOGF(LimitBreakConfig::enableDebugMessages, "Limit Break - Monitoring Status",
+                   "Damage Monitoring Started\nAction Completed: %s %d\n%s",
+                   battler->isMonster() ? "Monster" : "Actor", battler->id,
+                   LimitBreakConfig::pollDamageEveryFrame ?
+                       "Monitoring for multi-hit damage/healing..." :
+                       "Settling damage/healing of the action...");
+        
+        // Settle the action's damage ledger once instead of polling every frame
+        if (!LimitBreakConfig::pollDamageEveryFrame) {
+            LimitBreakCalculate::checkDamageAndApplyGain();
         }
     }
 
@@ -352,9 +343,12 @@ bool onBattlerActionDone(RPG::Battler* battler, bool success) {
  * @param scene Current game scene
  * 
  * @note This function:
- *       1. Detects battle scene transitions (entering/exiting battle)
- *       2. Initializes the ultimate limit bar upon battle entry
- *       3. Monitors for damage during active battles
+ *       1. Detects battle scene transitions (entering/exiting battle),
+ *          settling the last action's HP changes when leaving battle
+ *       2. Builds the battle roster and initializes the ultimate limit bar upon battle entry
+ *       3. Polls for damage during active battles (DamageDetection=frame only)
+ *          and refreshes the ultimate limit bar if a limit variable was
+ *          changed without an onSetVariable callback
  *       4. Resets the ultimate limit bar to 0 when exiting battle
  *       5. Handles tracking for sound effect playback at 100% limit
  */
@@ -364,8 +358,10 @@ void onFrame(RPG::Scene scene) {
     
     // Only process in battle scenes
     if (scene != RPG::SCENE_BATTLE) {
-        // If we leave battle while monitoring damage, clean up
+        // If we leave battle while monitoring damage, settle the killing blow
+        // and any other HP changes of the last action before cleaning up
         if (LimitBreakCalculate::monitoringDamage) {
+            LimitBreakCalculate::checkDamageAndApplyGain();
             LimitBreakCalculate::monitoringDamage = false;
         }
         
@@ -373,30 +369,56 @@ void onFrame(RPG::Scene scene) {
         if (LimitBreakCalculate::wasInBattle && !isInBattle) {
             // Just exited battle
             RPG::variables[LimitBreakConfig::ultimateLimitVarId] = 0;
+            LimitBreakCalculate::clearBattleRoster();
             // Reset sound playback tracking flag
             LimitBreakConfig::wasAt100Percent = false;
         }
     } else {
         // In battle scene
         
-        // If we just entered battle, initialize the ultimate limit bar
+        // If we just entered battle, build the battle roster and initialize the ultimate limit bar
         if (!LimitBreakCalculate::wasInBattle) {
+            LimitBreakCalculate::buildBattleRoster();
             // Calculate initial value for the ultimate bar
             LimitBreakCalculate::updateUltimateLimitBar();
             // Reset sound playback tracking flag
             LimitBreakConfig::wasAt100Percent = false;
+            actionWindowWasVisible = false;
         }
         
-        // If we're monitoring for damage, check each frame for HP changes
-        if (LimitBreakCalculate::monitoringDamage) {
+        // If we're polling for damage, check each frame for HP changes
+        if (LimitBreakCalculate::monitoringDamage && LimitBreakConfig::pollDamageEveryFrame) {
             LimitBreakCalculate::checkDamageAndApplyGain();
         }
+
+        // Pick up limit values written behind the plugin's back
+        if (LimitBreakCalculate::syncUltimateAggregate()) {
+            LimitBreakCalculate::updateUltimateLimitBar();
+        }
     }
 
     // Update the battle state tracker
     LimitBreakCalculate::wasInBattle = isInBattle;
 }
 
+/**
+ * @brief Keeps the ultimate limit bar in sync with limit values set by events
+ * 
+ * @param id The ID of the variable being set
+ * @param value The new value of the variable
+ * @return bool Always returns true to let the game set the variable
+ * 
+ * @note Events may change an actor's limit variable during battle (e.g. an item
+ *       that fills the gauge). The ultimate aggregate is updated in place and
+ *       the ultimate bar value is refreshed, no recount of the party is needed.
+ */
+bool onSetVariable(int id, int value) {
+    if (LimitBreakCalculate::onLimitValueChanged(id, value)) {
+        LimitBreakCalculate::updateUltimateLimitBar();
+    }
+    return true;
+}
+
 /**
  * @brief Cleanup resources when the game exits
  * 
@@ -405,6 +427,7 @@ void onFrame(RPG::Scene scene) {
  */
 void onExit() {
     LimitBreakGraphics::freeUltimateBarImages();
+    Dialog::CloseTrace();
 }
 
 } // namespace LimitBreak
\ No newline at end of file
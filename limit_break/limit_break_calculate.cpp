@@ -9,9 +9,60 @@ namespace LimitBreakCalculate
 // Runtime state variables
 // ========================================================================
 
-// Tracks previous HP values of all battlers to detect damage/healing between frames
-// Key: Pointer to battler, Value: Previous HP value
-static std::map<RPG::Battler*, int> preHP;
+// Maximum number of battlers that can take part in a battle on each side
+static const int MAX_PARTY_SLOTS = 4;
+static const int MAX_MONSTER_SLOTS = 8;
+
+/**
+ * @brief HP snapshot of one party or monster slot
+ */
+struct HpSnapshot {
+    RPG::Battler* battler;  // Battler in this slot, nullptr if the slot is empty
+    int hp;                 // HP when the snapshot was taken
+    int delta;              // HP change since the snapshot (positive = healed, negative = damaged)
+};
+
+// HP of the party members and monsters before the current action, indexed by
+// party slot and monster slot, to detect damage/healing between frames
+static HpSnapshot actorHP[MAX_PARTY_SLOTS];
+static HpSnapshot monsterHP[MAX_MONSTER_SLOTS];
+
+// Number of monster slots in the snapshot (monsters are only recorded for actor actions)
+static int monsterSlotCount = 0;
+
+/**
+ * @brief Party member taking part in the current battle
+ */
+struct RosterEntry {
+    RPG::Actor* actor;                       // Party member in this slot, nullptr if the slot is empty
+    LimitBreakConfig::ActorProfile* profile; // The actor's limit profile, nullptr if not configured
+};
+
+// Battle party, indexed by party slot; built when a battle starts so
+// per-frame and per-action loops never walk the actor database
+static RosterEntry battleRoster[MAX_PARTY_SLOTS];
+
+// Whether battleRoster describes the current battle
+static bool battleRosterActive = false;
+
+/**
+ * @brief Running totals the ultimate limit bar is calculated from
+ * 
+ * @note Covers the first 3 or 4 party slots (UseFourActorsForUltimate).
+ *       Updated whenever the plugin or an event changes a party member's
+ *       limit value, and fully recalculated only when the roster is built.
+ *       Writes that bypass onSetVariable (other plugins writing the variable
+ *       array, e.g. DynamicQuickPatch watches) are picked up by
+ *       syncUltimateAggregate.
+ */
+struct UltimateAggregate {
+    int partySize;         // Number of party members in battle
+    int configuredCount;   // Configured actors within the counted slots
+    int limitSum;          // Sum of the limit values of the configured actors
+    int atMaxCount;        // Configured actors with a limit value of 100 or more
+    int slotLimit[MAX_PARTY_SLOTS];  // Limit value counted for each slot
+};
+static UltimateAggregate ultimateAggregate;
 
 // Indicates if the next action to check will be from an actor (true) or monster (false)
 // Used to determine which damage calculation to apply
@@ -33,6 +84,204 @@ static bool monitoringDamage = false;  // Flag to monitor damage between turns
 // Used to detect battle start and end events
 static bool wasInBattle = false;       // Flag to track if we were in battle scene
 
+/**
+ * @brief Recalculates the ultimate aggregate from the battle roster
+ * 
+ * @note Only needed when the roster changes; everything else updates the
+ *       aggregate through setLimitValue or onLimitValueChanged
+ */
+void recalculateUltimateAggregate() {
+    int countedSlots = LimitBreakConfig::useFourActorsForUltimate ? 4 : 3;
+    UltimateAggregate& agg = ultimateAggregate;
+    agg.partySize = 0;
+    agg.configuredCount = 0;
+    agg.limitSum = 0;
+    agg.atMaxCount = 0;
+
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        agg.slotLimit[i] = 0;
+        if (battleRoster[i].actor) agg.partySize++;
+        if (i >= countedSlots || !battleRoster[i].profile) continue;
+
+        int value = RPG::variables[battleRoster[i].profile->limitVarId];
+        agg.slotLimit[i] = value;
+        agg.configuredCount++;
+        agg.limitSum += value;
+        if (value >= 100) agg.atMaxCount++;
+    }
+}
+
+/**
+ * @brief Updates the ultimate aggregate after a limit variable changed
+ * 
+ * @param varId The changed variable ID
+ * @param value The new value of the variable
+ * @return bool True if the variable is the limit variable of a counted party member
+ * 
+ * @note Every counted party slot using this limit variable is updated.
+ *       Does nothing outside of battle.
+ */
+bool onLimitValueChanged(int varId, int value) {
+    if (!battleRosterActive) return false;
+
+    bool found = false;
+    int countedSlots = LimitBreakConfig::useFourActorsForUltimate ? 4 : 3;
+    UltimateAggregate& agg = ultimateAggregate;
+    for (int i = 0; i < countedSlots; ++i) {
+        LimitBreakConfig::ActorProfile* profile = battleRoster[i].profile;
+        if (!profile || profile->limitVarId != varId) continue;
+
+        int oldValue = agg.slotLimit[i];
+        agg.slotLimit[i] = value;
+        agg.limitSum += value - oldValue;
+        agg.atMaxCount += (value >= 100) - (oldValue >= 100);
+        found = true;
+    }
+    return found;
+}
+
+/**
+ * @brief Compares the ultimate aggregate with the limit variables of the roster
+ * 
+ * @return bool True if a counted slot's limit value had changed
+ * 
+ * @note Called every battle frame and before the ultimate bar is calculated,
+ *       so the aggregate can not stay stale when a limit variable was changed
+ *       without an onSetVariable callback. Only reads the counted slots'
+ *       variables. Does nothing outside of battle.
+ */
+bool syncUltimateAggregate() {
+    if (!battleRosterActive) return false;
+
+    bool changed = false;
+    int countedSlots = LimitBreakConfig::useFourActorsForUltimate ? 4 : 3;
+    for (int i = 0; i < countedSlots; ++i) {
+        LimitBreakConfig::ActorProfile* profile = battleRoster[i].profile;
+        if (!profile) continue;
+
+        int value = RPG::variables[profile->limitVarId];
+        if (value != ultimateAggregate.slotLimit[i]) {
+            onLimitValueChanged(profile->limitVarId, value);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief Sets an actor's limit variable and keeps the ultimate aggregate in sync
+ * 
+ * @param varId The actor's limit variable ID
+ * @param value The new limit value
+ */
+void setLimitValue(int varId, int value) {
+    RPG::variables[varId] = value;
+    onLimitValueChanged(varId, value);
+}
+
+/**
+ * @brief Builds the battle roster from the current party
+ * 
+ * @note Called when a battle starts. The profile lookup is done once
+ *       here instead of for every actor on every action. The ultimate
+ *       aggregate is recalculated for the new roster.
+ */
+void buildBattleRoster() {
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        RPG::Actor* a = PartySnapshot::member(i);
+        battleRoster[i].actor = a;
+        battleRoster[i].profile = a ? LimitBreakConfig::getActorProfile(a->id) : nullptr;
+    }
+    battleRosterActive = true;
+    recalculateUltimateAggregate();
+}
+
+/**
+ * @brief Marks the battle roster as inactive when a battle ends
+ */
+void clearBattleRoster() {
+    battleRosterActive = false;
+}
+
+/**
+ * @brief Rebuilds the battle roster if the party changed during battle
+ * 
+ * @note Party changes from battle events are rare, so this only compares
+ *       the four party slots before each action
+ */
+void refreshBattleRoster() {
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        if (battleRoster[i].actor != RPG::Actor::partyMember(i)) {
+            buildBattleRoster();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Records the HP of the battle party and optionally the monsters
+ * 
+ * @param includeMonsters Whether monster HP is recorded as well
+ * 
+ * @note Called before each battler action. The snapshot is only overwritten
+ *       in place, so damage monitoring never allocates.
+ */
+void takeHpSnapshot(bool includeMonsters) {
+    refreshBattleRoster();
+
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        RPG::Actor* a = battleRoster[i].actor;
+        actorHP[i].battler = a;
+        actorHP[i].hp = a ? a->hp : 0;
+        actorHP[i].delta = 0;
+    }
+
+    monsterSlotCount = 0;
+    if (includeMonsters) {
+        monsterSlotCount = std::min(RPG::monsters.count(), MAX_MONSTER_SLOTS);
+        for (int i = 0; i < monsterSlotCount; ++i) {
+            RPG::Monster* m = RPG::monsters[i];
+            monsterHP[i].battler = m;
+            monsterHP[i].hp = m ? m->hp : 0;
+            monsterHP[i].delta = 0;
+        }
+    }
+}
+
+/**
+ * @brief Calculates the HP change of every recorded slot since the snapshot
+ * 
+ * @note Run once per frame before any damage or healing check reads the deltas
+ */
+void updateHpDeltas() {
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        HpSnapshot& s = actorHP[i];
+        s.delta = s.battler ? s.battler->hp - s.hp : 0;
+    }
+    for (int i = 0; i < monsterSlotCount; ++i) {
+        HpSnapshot& s = monsterHP[i];
+        s.delta = s.battler ? s.battler->hp - s.hp : 0;
+    }
+}
+
+/**
+ * @brief Makes the current HP the new snapshot after a change was processed
+ * 
+ * @note Allows multi-hit actions to be detected hit by hit
+ */
+void rebaseHpSnapshot() {
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        HpSnapshot& s = actorHP[i];
+        s.hp += s.delta;
+        s.delta = 0;
+    }
+    for (int i = 0; i < monsterSlotCount; ++i) {
+        HpSnapshot& s = monsterHP[i];
+        s.hp += s.delta;
+        s.delta = 0;
+    }
+}
+
 /**
  * @brief Calculates the equipment-based multiplier for an actor's limit gain
  * 
@@ -43,13 +292,12 @@ static bool wasInBattle = false;       // Flag to track if we were in battle sce
  *       This function checks all equipment slots (weapon, shield, armor, helmet, accessory)
  *       and adds any configured multipliers from the LimitBreakConfig::equipmentMultipliers map.
  *       The result is capped at a minimum of 0.0 (no negative multipliers).
+ *       For configured actors the result is cached in the actor profile and only
+ *       recalculated when one of the equipment IDs changes.
  */
 float getEquipmentMultiplier(RPG::Actor* actor) {
     if (!actor) return 1.0f; // Default multiplier if no actor
     
-    // Start with base multiplier of 1.0
-    float multiplier = 1.0f;
-    
     // Check each equipment slot
     short equipIds[] = {
         actor->weaponId,
@@ -59,6 +307,15 @@ float getEquipmentMultiplier(RPG::Actor* actor) {
         actor->accessoryId
     };
     
+    // Use the cached multiplier if the equipment is unchanged
+    LimitBreakConfig::ActorProfile* profile = LimitBreakConfig::getActorProfile(actor->id);
+    if (profile && profile->multiplierCached && memcmp(profile->equipIds, equipIds, sizeof(equipIds)) == 0) {
+        return profile->equipMultiplier;
+    }
+    
+    // Start with base multiplier of 1.0
+    float multiplier = 1.0f;
+    
     // Add multipliers for each equipped item found in the configuration
     for (int i = 0; i < 5; ++i) {
         short equipId = equipIds[i];
@@ -71,7 +328,14 @@ float getEquipmentMultiplier(RPG::Actor* actor) {
     }
     
     // Apply floor cap (no multiplier below 0)
-    return std::max(0.0f, multiplier);
+    multiplier = std::max(0.0f, multiplier);
+    
+    if (profile) {
+        memcpy(profile->equipIds, equipIds, sizeof(equipIds));
+        profile->equipMultiplier = multiplier;
+        profile->multiplierCached = true;
+    }
+    return multiplier;
 }
 
 /**
@@ -93,47 +357,28 @@ void applyLimitGain(RPG::Battler* battler, int percentGain) {
     RPG::Actor* actor = reinterpret_cast<RPG::Actor*>(battler);
     int actorId = actor->id;
 
-    auto cfgIt = LimitBreakConfig::actorConfig.find(actorId);
-    if (cfgIt == LimitBreakConfig::actorConfig.end())
+    LimitBreakConfig::ActorProfile* profile = LimitBreakConfig::getActorProfile(actorId);
+    if (!profile)
         return;
 
     // Check if actor should be skipped based on mode
-    int mode = LimitBreakConfig::getActorMode(actorId);
-    if (mode < 0)
+    const LimitBreakModes::LimitMode* mode = LimitBreakModes::getMode(LimitBreakConfig::getActorMode(actorId));
+    if (!mode)
         return; // Skip limit gain for this actor
 
     // Apply equipment multiplier to the percentGain
     float multiplier = getEquipmentMultiplier(actor);
     int adjustedGain = static_cast<int>(percentGain * multiplier);
 
-    int varId = std::get<0>(cfgIt->second);
-    int& current = RPG::variables[varId];
-    int oldValue = current;
-    current = std::min(100, current + adjustedGain);
+    int oldValue = RPG::variables[profile->limitVarId];
+    int current = std::min(100, oldValue + adjustedGain);
+    setLimitValue(profile->limitVarId, current);
     
-    // Create debug message
-    if (LimitBreakConfig::enableDebugMessages) {
-        std::string modeStr;
-        switch (mode) {
-            case 0: modeStr = "Stoic"; break;
-            case 1: modeStr = "Warrior"; break;
-            case 2: modeStr = "Comrade"; break;
-            case 3: modeStr = "Healer"; break;
-            case 4: modeStr = "Knight"; break;
-            default: modeStr = "Unknown"; break;
-        }
-        
-        std::string debugMessage = "Limit Gain Applied:\n";
-        debugMessage += "Actor: " + std::to_string(actorId) + "\n";
-        debugMessage += "Mode: " + modeStr + "\n";
-        debugMessage += "Base Gain: " + std::to_string(percentGain) + "%\n";
-        debugMessage += "Equipment Multiplier: " + std::to_string(multiplier) + "\n";
-        debugMessage += "Adjusted Gain: " + std::to_string(adjustedGain) + "%\n";
-        debugMessage += "Previous Limit: " + std::to_string(oldValue) + "%\n";
-        debugMessage += "New Limit: " + std::to_string(current) + "%\n";
-        
-        Dialog::Show(debugMessage, "Limit Break - Gain Applied");
-    }
+    // Write debug trace
+    ASYNC_LOGF(LimitBreakConfig::enableDebugMessages, "Limit Break - Gain Applied",
+               "Limit Gain Applied:\nActor: %d\nMode: %s\nBase Gain: %d%%\nEquipment Multiplier: %f\n"
+               "Adjusted Gain: %d%%\nPrevious Limit: %d%%\nNew Limit: %d%%\n",
+               actorId, mode->name, percentGain, multiplier, adjustedGain, oldValue, current);
 }
 
 /**
@@ -142,12 +387,13 @@ void applyLimitGain(RPG::Battler* battler, int percentGain) {
  * @note This function:
  *       1. Checks if the ultimate limit system is enabled
  *       2. Verifies if the party is at max capacity (either 3 or 4 actors based on config)
- *       3. Calculates the ultimate limit value based on all configured actors
+ *       3. Calculates the ultimate limit value from the running ultimate aggregate
  *       4. Applies special rules to ensure 100% only occurs when all actors are at 100%
  *       5. Updates the RPG Maker variable with the new ultimate limit value
  * 
  *       The ultimate bar percentage is calculated by averaging all actors' limit values,
- *       with unconfigured actors counting as 0% toward the total.
+ *       with unconfigured actors counting as 0% toward the total. The aggregate is
+ *       maintained incrementally, so this only combines a few counters.
  */
 void updateUltimateLimitBar() {
     // If UltimateLimitVarId is 0, the ultimate limit system is disabled
@@ -155,77 +401,29 @@ void updateUltimateLimitBar() {
         return;
     }
     
-    int requiredPartySize = LimitBreakConfig::useFourActorsForUltimate ? 4 : 3;
-    int currentPartySize = 0;
-    
-    // Count the number of actors in the party
-    for (int i = 0; i < 4; ++i) { // Max party size is 4
-        if (RPG::Actor::partyMember(i)) {
-            currentPartySize++;
-        }
+    // Make sure the aggregate describes the current party and limit values
+    if (!battleRosterActive) {
+        buildBattleRoster();
+    } else {
+        syncUltimateAggregate();
     }
     
+    int requiredPartySize = LimitBreakConfig::useFourActorsForUltimate ? 4 : 3;
+    const UltimateAggregate& agg = ultimateAggregate;
+    
     // Only calculate if the party is at max capacity
-    if (currentPartySize < requiredPartySize) {
+    if (agg.partySize < requiredPartySize) {
         // Party not at required size, set ultimate limit to 0
         RPG::variables[LimitBreakConfig::ultimateLimitVarId] = 0;
         return;
     }
     
-    // Party is at required size, calculate the ultimate limit
-    int totalLimitValue = 0;
-    
-    // Sum the limit values of all actors in the battle party
-    for (int battlePosIdx = 0; battlePosIdx < requiredPartySize; ++battlePosIdx) {
-        RPG::Actor* actor = RPG::Actor::partyMember(battlePosIdx);
-        if (!actor) continue; // Should not happen since we checked party size
-        
-        int actorId = actor->id; // Use the actor's database ID, not the battle position
-        auto cfgIt = LimitBreakConfig::actorConfig.find(actorId);
-        
-        // If actor is not configured, treat their limit value as 0
-        if (cfgIt == LimitBreakConfig::actorConfig.end()) {
-            // Actor not configured, contributes 0 to the total
-            continue;
-        }
-        
-        int limitVarId = std::get<0>(cfgIt->second);
-        int limitValue = RPG::variables[limitVarId];
-        
-        // Add this actor's limit value to the total
-        totalLimitValue += limitValue;
-    }
-    
     // Calculate the percentage fill for the ultimate bar
     // Always divide by the required party size, regardless of how many actors are configured
-    int ultimateValue = totalLimitValue / requiredPartySize;
-    
-    // Only if all actors have 100% limit, ensure ultimate is also 100%
-    // This requires checking if all actors are at 100% AND configured
-    bool allConfiguredActorsAtMax = true;
-    int configuredActorCount = 0;
-    
-    for (int battlePosIdx = 0; battlePosIdx < requiredPartySize; ++battlePosIdx) {
-        RPG::Actor* actor = RPG::Actor::partyMember(battlePosIdx);
-        if (!actor) continue;
-        
-        int actorId = actor->id; // Use the actor's database ID, not the battle position
-        auto cfgIt = LimitBreakConfig::actorConfig.find(actorId);
-        
-        if (cfgIt != LimitBreakConfig::actorConfig.end()) {
-            configuredActorCount++;
-            int limitVarId = std::get<0>(cfgIt->second);
-            int limitValue = RPG::variables[limitVarId];
-            
-            if (limitValue < 100) {
-                allConfiguredActorsAtMax = false;
-                break;
-            }
-        }
-    }
+    int ultimateValue = agg.limitSum / requiredPartySize;
     
-    // Only set to 100% if all configured actors are at 100% AND at least one actor is configured
-    if (allConfiguredActorsAtMax && configuredActorCount > 0 && configuredActorCount == requiredPartySize) {
+    // Only set to 100% if all actors are configured AND all of them are at 100%
+    if (agg.configuredCount == requiredPartySize && agg.atMaxCount == requiredPartySize) {
         ultimateValue = 100;
     }
     
@@ -240,9 +438,9 @@ void updateUltimateLimitBar() {
  * @brief Analyzes and applies limit gain for actors who heal other party members
  * 
  * @note This function:
- *       1. Only processes if the current actor has Healer mode (mode 3)
+ *       1. Only processes if the current actor's mode gains limit from healing (Healer)
  *       2. Calculates total healing done across all targets
- *       3. Applies the Healer formula: (healingDone * 16) / targetMaxHP * multiplier
+ *       3. Applies the mode's healing formula, for Healer: (healingDone * 16) / targetMaxHP * multiplier
  *       4. Applies equipment multipliers to the final value
  *       5. Generates debug output if debug messages are enabled
  *       
@@ -253,36 +451,38 @@ void checkActorHealing() {
     if (!lastActionActor) return;
 
     int actorId = lastActionActor->id; // Use database ID, not battle position
-    int mode = LimitBreakConfig::getActorMode(actorId);
+    const LimitBreakModes::LimitMode* mode = LimitBreakModes::getMode(LimitBreakConfig::getActorMode(actorId));
 
-    // Only for Healer mode
-    if (mode != 3) return;
+    // Only for modes that gain limit from healing
+    if (!mode || !mode->healingDone.gain) return;
+    const LimitBreakModes::GainRule& rule = mode->healingDone;
 
     int totalHealing = 0;
     int totalMaxHP = 0;
     bool healingFound = false;
-    std::string debugMessage = "Healer Mode Calculation:\n";
+    
+    // Debug text is only built when debug messages are enabled
+    const bool debug = LimitBreakConfig::enableDebugMessages;
+    std::string debugMessage;
+    if (debug) debugMessage = std::string(mode->name) + " Mode Calculation:\n";
 
     // Calculate total healing done to actors and their max HP
-    for (auto& kv : preHP) {
-        RPG::Battler* target = kv.first;
-        if (!target || target->isMonster()) continue;  // Only actor healing counts
-
-        int before = kv.second;
-        int after = target->hp;
-        int healing = std::max(0, after - before);  // Positive for healing
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        int healing = actorHP[i].delta;  // Positive for healing
 
         if (healing > 0) {
             healingFound = true;
             totalHealing += healing;
 
             // Store target max HP
-            RPG::Actor* actorTarget = reinterpret_cast<RPG::Actor*>(target);
+            RPG::Actor* actorTarget = reinterpret_cast<RPG::Actor*>(actorHP[i].battler);
             totalMaxHP += actorTarget->getMaxHp();
             
-            debugMessage += "Actor " + std::to_string(actorTarget->id) + " healed: " + 
-                           std::to_string(healing) + " HP (MaxHP: " + 
-                           std::to_string(actorTarget->getMaxHp()) + ")\n";
+            if (debug) {
+                debugMessage += "Actor " + std::to_string(actorTarget->id) + " healed: " + 
+                               std::to_string(healing) + " HP (MaxHP: " + 
+                               std::to_string(actorTarget->getMaxHp()) + ")\n";
+            }
         }
     }
 
@@ -290,17 +490,15 @@ void checkActorHealing() {
         // Get the equipment multiplier for the actor
         float multiplier = getEquipmentMultiplier(lastActionActor);
         
-        // Apply the formula: (healingDone * 16) / targetMaxHP * multiplier
-        int gain = static_cast<int>((totalHealing * 16.0f) / totalMaxHP * multiplier);
+        int gain = rule.gain(totalHealing, totalMaxHP, multiplier);
 
         if (gain > 0) {
-            debugMessage += "\nTotal Healing: " + std::to_string(totalHealing) + 
-                           "\nTotal Target MaxHP: " + std::to_string(totalMaxHP) + 
-                           "\nEquipment Multiplier: " + std::to_string(multiplier) + 
-                           "\nFormula: (totalHealing * 16) / totalMaxHP * multiplier" +
-                           "\nLimit Gain: " + std::to_string(gain);
-            
-            if (LimitBreakConfig::enableDebugMessages) {
+            if (debug) {
+                debugMessage += "\nTotal Healing: " + std::to_string(totalHealing) + 
+                               "\nTotal Target MaxHP: " + std::to_string(totalMaxHP) + 
+                               "\nEquipment Multiplier: " + std::to_string(multiplier) + 
+                               "\nFormula: " + LimitBreakModes::describe(rule, totalHealing, totalMaxHP, multiplier) +
+                               "\nLimit Gain: " + std::to_string(gain);
                 Dialog::Show(debugMessage, "Limit Break - Healing Calculation");
             }
             
@@ -313,12 +511,12 @@ void checkActorHealing() {
  * @brief Analyzes and applies limit gain for actors who damage monsters
  * 
  * @note This function:
- *       1. Only processes if the current actor has Warrior (mode 1) or Knight (mode 4) mode
+ *       1. Only processes if the current actor's mode gains limit from dealing damage (Warrior, Knight)
  *       2. Calculates damage dealt to each monster as a percentage of their max HP
- *       3. Applies the formula: min(16, (damageDealt * 30) / targetMaxHP) * multiplier
- *       4. For Warrior mode, applies gain from all monster damage
- *       5. For Knight mode, handles only the offensive portion of limit gain
- *       6. Applies equipment multipliers to the final value
+ *       3. Applies the mode's formula per monster, for Warrior and Knight:
+ *          min(16, (damageDealt * 30) / targetMaxHP * multiplier)
+ *       4. For Knight mode, this is only the offensive portion of limit gain
+ *       5. Applies equipment multipliers to the final value
  *       
  *       Warrior and Knight modes reward actors for dealing significant damage 
  *       relative to the monster's maximum HP.
@@ -327,10 +525,11 @@ void checkActorDamageToMonsters() {
     if (!lastActionActor) return;
 
     int actorId = lastActionActor->id; // Use database ID, not battle position
-    int mode = LimitBreakConfig::getActorMode(actorId);
+    const LimitBreakModes::LimitMode* mode = LimitBreakModes::getMode(LimitBreakConfig::getActorMode(actorId));
 
-    // Only for Warrior or Knight modes
-    if (mode != 1 && mode != 4) return;
+    // Only for modes that gain limit from dealing damage
+    if (!mode || !mode->damageDealt.gain) return;
+    const LimitBreakModes::GainRule& rule = mode->damageDealt;
 
     int gain = 0;
     int maxH = lastActionActor->getMaxHp();
@@ -339,35 +538,34 @@ void checkActorDamageToMonsters() {
 
     int totalDamageDealt = 0;
     bool damageFound = false;
-    std::string debugMessage = "Warrior/Knight Mode Calculation:\n";
-    std::string modeStr = (mode == 1) ? "Warrior" : "Knight";
-    debugMessage += "Mode: " + modeStr + "\n\n";
+    
+    // Debug text is only built when debug messages are enabled
+    const bool debug = LimitBreakConfig::enableDebugMessages;
+    std::string debugMessage;
+    if (debug) {
+        debugMessage = "Damage Dealt Calculation:\n";
+        debugMessage += "Mode: " + std::string(mode->name) + "\n\n";
+    }
 
     // For tracking total monster maxHP for formula
     int totalTargetMaxHP = 0;
-    std::map<RPG::Battler*, std::pair<int, int>> targetDamageAndMaxHP;
 
     // Calculate total damage dealt to monsters and track target max HP
-    for (auto& kv : preHP) {
-        RPG::Battler* target = kv.first;
-        if (!target || !target->isMonster()) continue;
-
-        int before = kv.second;
-        int after = target->hp;
-        int delta = std::max(0, before - after);
+    for (int i = 0; i < monsterSlotCount; ++i) {
+        int delta = std::max(0, -monsterHP[i].delta);
 
         if (delta > 0) {
             damageFound = true;
             totalDamageDealt += delta;
 
-            // Store damage and maxHP for each target
-            RPG::Monster* monster = reinterpret_cast<RPG::Monster*>(target);
-            targetDamageAndMaxHP[target] = std::make_pair(delta, monster->getMaxHp());
+            RPG::Monster* monster = reinterpret_cast<RPG::Monster*>(monsterHP[i].battler);
             totalTargetMaxHP += monster->getMaxHp();
             
-            debugMessage += "Monster " + std::to_string(monster->id) + " damage: " + 
-                           std::to_string(delta) + " (MaxHP: " + 
-                           std::to_string(monster->getMaxHp()) + ")\n";
+            if (debug) {
+                debugMessage += "Monster " + std::to_string(monster->id) + " damage: " + 
+                               std::to_string(delta) + " (MaxHP: " + 
+                               std::to_string(monster->getMaxHp()) + ")\n";
+            }
         }
     }
 
@@ -378,38 +576,33 @@ void checkActorDamageToMonsters() {
         // Calculate gain based on damage as percentage of target's max HP
         int totalGainPercent = 0;
 
-        debugMessage += "\nGain calculations per monster:\n";
+        if (debug) debugMessage += "\nGain calculations per monster:\n";
         
-        for (const auto& entry : targetDamageAndMaxHP) {
-            int damage = entry.second.first;
-            int targetMaxHP = entry.second.second;
+        for (int i = 0; i < monsterSlotCount; ++i) {
+            int damage = std::max(0, -monsterHP[i].delta);
+            if (damage <= 0) continue;
+
+            RPG::Monster* monster = reinterpret_cast<RPG::Monster*>(monsterHP[i].battler);
+            int targetMaxHP = monster->getMaxHp();
 
             if (targetMaxHP > 0) {
-                // Formula: min(16, (damageDealt * 30) / targetMaxHP) * multiplier for each target
-                int gainFromTarget = std::min(16, static_cast<int>((damage * 30.0f) / targetMaxHP * multiplier));
+                int gainFromTarget = rule.gain(damage, targetMaxHP, multiplier);
                 totalGainPercent += gainFromTarget;
                 
-                RPG::Monster* monster = reinterpret_cast<RPG::Monster*>(entry.first);
-                debugMessage += "Monster " + std::to_string(monster->id) + " gain: " + 
-                               std::to_string(gainFromTarget) + " (min(16, (" + 
-                               std::to_string(damage) + " * 30) / " + 
-                               std::to_string(targetMaxHP) + ") * " + 
-                               std::to_string(multiplier) + ")\n";
+                if (debug) {
+                    debugMessage += "Monster " + std::to_string(monster->id) + " gain: " + 
+                                   std::to_string(gainFromTarget) + " (" + 
+                                   LimitBreakModes::describe(rule, damage, targetMaxHP, multiplier) + ")\n";
+                }
             }
         }
 
-        // Use appropriate final gain based on mode
-        if (mode == 1) {  // Warrior
-            gain = totalGainPercent;
-        } else if (mode == 4) {  // Knight (damage dealt part)
-            gain = totalGainPercent;
-        }
+        gain = totalGainPercent;
 
         if (gain > 0) {
-            debugMessage += "\nEquipment Multiplier: " + std::to_string(multiplier) + 
-                           "\nTotal Limit Gain: " + std::to_string(gain);
-            
-            if (LimitBreakConfig::enableDebugMessages) {
+            if (debug) {
+                debugMessage += "\nEquipment Multiplier: " + std::to_string(multiplier) + 
+                               "\nTotal Limit Gain: " + std::to_string(gain);
                 Dialog::Show(debugMessage, "Limit Break - Damage Calculation");
             }
             
@@ -423,10 +616,11 @@ void checkActorDamageToMonsters() {
  * 
  * @note This function:
  *       1. Calculates damage taken by all actors in the battle party
- *       2. Processes each actor based on their mode:
+ *       2. Processes each actor with the damage taken rules of their mode:
  *          - Stoic (mode 0): Gains limit from direct damage ((damage * 30) / maxHP * multiplier)
  *          - Comrade (mode 2): Gains limit from damage to OTHER actors ((otherDamage * 20) / maxHP * multiplier)
  *          - Knight (mode 4): Gains limit from direct damage, in addition to offensive limit gain
+ *          The mode is looked up once per actor in LimitBreakModes::limitModes
  *       3. Applies equipment multipliers to all calculations
  *       4. Updates the ultimate limit bar after all limit gains are applied
  *       
@@ -436,56 +630,57 @@ void checkActorDamageToMonsters() {
 void checkMonsterDamageToActors() {
     // For modes that gain limit on damage taken (Stoic, Comrade, Knight)
     bool anyDamageDetected = false;
-    std::string debugMessage = "Monster Damage Calculation:\n\n";
+    
+    // Debug text is only built when debug messages are enabled
+    const bool debug = LimitBreakConfig::enableDebugMessages;
+    std::string debugMessage;
+    if (debug) debugMessage = "Monster Damage Calculation:\n\n";
 
     // First, calculate total damage to all actors for Comrade mode
     int totalGroupDamage = 0;
-    std::map<RPG::Actor*, int> actorDamage;
-
-    for (auto& kv : preHP) {
-        RPG::Battler* a = kv.first;
-        if (!a || a->isMonster()) continue;
 
-        int before = kv.second;
-        int after = a->hp;
-        int delta = std::max(0, before - after);
+    for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+        int delta = std::max(0, -actorHP[i].delta);
 
         if (delta > 0) {
             anyDamageDetected = true;
             totalGroupDamage += delta;
 
-            RPG::Actor* actor = reinterpret_cast<RPG::Actor*>(a);
-            actorDamage[actor] = delta;
+            RPG::Actor* actor = reinterpret_cast<RPG::Actor*>(actorHP[i].battler);
             
-            debugMessage += "Actor " + std::to_string(actor->id) + " took " + 
-                           std::to_string(delta) + " damage (MaxHP: " + 
-                           std::to_string(actor->getMaxHp()) + ")\n";
+            if (debug) {
+                debugMessage += "Actor " + std::to_string(actor->id) + " took " + 
+                               std::to_string(delta) + " damage (MaxHP: " + 
+                               std::to_string(actor->getMaxHp()) + ")\n";
+            }
         }
     }
 
-    debugMessage += "\nTotal group damage: " + std::to_string(totalGroupDamage) + "\n\n";
-    debugMessage += "Limit gain calculations:\n";
+    if (debug) {
+        debugMessage += "\nTotal group damage: " + std::to_string(totalGroupDamage) + "\n\n";
+        debugMessage += "Limit gain calculations:\n";
+    }
 
-    // Now process each actor for all modes
-    for (int i = 1; i <= RPG::actors.count(); ++i) {
-        RPG::Actor* actor = RPG::actors[i];
-        if (!actor) continue;
+    // Now process each battle party member for all modes
+    for (int slot = 0; slot < MAX_PARTY_SLOTS; ++slot) {
+        RPG::Actor* actor = battleRoster[slot].actor;
+        if (!actor || !battleRoster[slot].profile) continue;
 
         int actorId = actor->id; // Use database ID, not battle position
-        int mode = LimitBreakConfig::getActorMode(actorId);
+        const LimitBreakModes::LimitMode* mode = LimitBreakModes::getMode(LimitBreakConfig::getActorMode(actorId));
 
-        // Skip actors with negative mode values
-        if (mode < 0) continue;
+        // Skip actors without a mode (negative mode values)
+        if (!mode) continue;
 
-        std::string modeStr;
-        switch (mode) {
-            case 0: modeStr = "Stoic"; break;
-            case 2: modeStr = "Comrade"; break;
-            case 4: modeStr = "Knight"; break;
-            default: modeStr = "Unknown"; break;
+        if (debug) {
+            debugMessage += "\nActor " + std::to_string(actorId) + " (" + mode->name + " mode):\n";
         }
 
-        debugMessage += "\nActor " + std::to_string(actorId) + " (" + modeStr + " mode):\n";
+        // Modes without damage taken rules need no further work
+        if (!mode->damageTaken.gain && !mode->allyDamageTaken.gain) {
+            if (debug) debugMessage += "  No gain\n";
+            continue;
+        }
 
         int gain = 0;
         int maxH = actor->getMaxHp();
@@ -495,58 +690,41 @@ void checkMonsterDamageToActors() {
         float multiplier = getEquipmentMultiplier(actor);
 
         // Get this actor's damage (if any)
-        int actorDelta = 0;
-        auto dmgIt = actorDamage.find(actor);
-        if (dmgIt != actorDamage.end()) {
-            actorDelta = dmgIt->second;
+        int actorDelta = std::max(0, -actorHP[slot].delta);
+
+        const LimitBreakModes::GainRule& own = mode->damageTaken;
+        if (own.gain && actorDelta > 0) {
+            int ownGain = own.gain(actorDelta, maxH, multiplier);
+            gain += ownGain;
+            if (debug) {
+                debugMessage += "  " + std::string(mode->name) + " formula: " +
+                               LimitBreakModes::describe(own, actorDelta, maxH, multiplier) +
+                               " = " + std::to_string(ownGain) + "\n";
+            }
         }
 
-        switch (mode) {
-            case 0: // Stoic
-                if (actorDelta > 0) {
-                    gain = static_cast<int>((actorDelta * 30.0f) / maxH * multiplier);
-                    debugMessage += "  Stoic formula: (" + std::to_string(actorDelta) + 
-                                   " * 30) / " + std::to_string(maxH) + " * " + 
-                                   std::to_string(multiplier) + " = " + std::to_string(gain) + "\n";
-                }
-                break;
-
-            case 2: { // Comrade
-                // Calculate damage to all OTHER actors
-                int otherActorsDamage = totalGroupDamage - actorDelta;
-
-                // Apply gain even if this actor wasn't hit
-                if (otherActorsDamage > 0) {
-                    gain = static_cast<int>((otherActorsDamage * 20.0f) / maxH * multiplier);
-                    debugMessage += "  Comrade formula: (" + std::to_string(otherActorsDamage) + 
-                                   " * 20) / " + std::to_string(maxH) + " * " + 
-                                   std::to_string(multiplier) + " = " + std::to_string(gain) + "\n";
-                }
-                break;
+        // Calculate damage to all OTHER actors; applies even if this actor wasn't hit
+        const LimitBreakModes::GainRule& ally = mode->allyDamageTaken;
+        int otherActorsDamage = totalGroupDamage - actorDelta;
+        if (ally.gain && otherActorsDamage > 0) {
+            int allyGain = ally.gain(otherActorsDamage, maxH, multiplier);
+            gain += allyGain;
+            if (debug) {
+                debugMessage += "  " + std::string(mode->name) + " formula: " +
+                               LimitBreakModes::describe(ally, otherActorsDamage, maxH, multiplier) +
+                               " = " + std::to_string(allyGain) + "\n";
             }
-
-            case 4: // Knight - handle damage taken part here
-                if (actorDelta > 0) {
-                    gain = static_cast<int>((actorDelta * 30.0f) / maxH * multiplier);
-                    debugMessage += "  Knight formula: (" + std::to_string(actorDelta) + 
-                                   " * 30) / " + std::to_string(maxH) + " * " + 
-                                   std::to_string(multiplier) + " = " + std::to_string(gain) + "\n";
-                }
-                break;
-
-            default:
-                break;
         }
 
         if (gain > 0) {
-            debugMessage += "  Final gain: " + std::to_string(gain) + "\n";
+            if (debug) debugMessage += "  Final gain: " + std::to_string(gain) + "\n";
             applyLimitGain(actor, gain);
-        } else {
+        } else if (debug) {
             debugMessage += "  No gain\n";
         }
     }
 
-    if (anyDamageDetected && LimitBreakConfig::enableDebugMessages) {
+    if (anyDamageDetected && debug) {
         Dialog::Show(debugMessage, "Limit Break - Monster Damage Calculation");
         
         // Update the ultimate limit bar
@@ -568,63 +746,57 @@ void checkMonsterDamageToActors() {
  *       4. Updates the ultimate limit bar after limit gain is applied
  *       5. Maintains HP tracking between frames for multi-hit actions
  *
- *       This is the central damage detection system that runs every frame while
- *       monitoringDamage is active.
+ *       This is the central damage detection system. The HP snapshot serves as
+ *       the damage ledger of the current action: with DamageDetection=action it
+ *       is settled once when the action is done and once before the next action,
+ *       with DamageDetection=frame it runs every frame while monitoringDamage
+ *       is active.
  */
 void checkDamageAndApplyGain() {
     if (!monitoringDamage) return;
 
     bool damageFound = false;
-    std::string debugMessage = "";
+    
+    // First HP change found, for the debug trace
+    const char* detectedBattler = "";
+    const char* detectedChange = "";
+    const char* detectedUnit = "";
+    int detectedId = 0;
+    int detectedAmount = 0;
+
+    // Compare the current HP against the snapshot once for all checks below
+    updateHpDeltas();
 
     if (nextIsActorAction) {
         // Actor action - check for damage to monsters and healing to actors
-        // Store the current state of HP for comparison on next frame
-        std::map<RPG::Battler*, int> currentHP;
-        
-        // Record current HP of monsters
-        for (int i = 0; i < RPG::monsters.count(); ++i) {
-            RPG::Monster* m = RPG::monsters[i];
-            if (m) currentHP[m] = m->hp;
-        }
-        
-        // Record current HP of actors (for healing detection)
-        for (int i = 1; i <= RPG::actors.count(); ++i) {
-            RPG::Actor* a = RPG::actors[i];
-            if (a) currentHP[a] = a->hp;
-        }
         
         // Check for damage to monsters
-        for (auto& kv : preHP) {
-            RPG::Battler* target = kv.first;
-            if (!target || !target->isMonster()) continue;
-            
-            int before = kv.second;
-            int after = target->hp;
-            int delta = std::max(0, before - after);
+        for (int i = 0; i < monsterSlotCount; ++i) {
+            int delta = -monsterHP[i].delta;
             
             if (delta > 0) {
                 damageFound = true;
-                RPG::Monster* monster = reinterpret_cast<RPG::Monster*>(target);
-                debugMessage += "Monster " + std::to_string(monster->id) + " took " + std::to_string(delta) + " damage\n";
+                detectedBattler = "Monster";
+                detectedChange = "took";
+                detectedUnit = "damage";
+                detectedId = monsterHP[i].battler->id;
+                detectedAmount = delta;
                 break;  // Found damage, no need to check further
             }
         }
         
         // Check for healing to actors
         if (!damageFound) {
-            for (auto& kv : preHP) {
-                RPG::Battler* target = kv.first;
-                if (!target || target->isMonster()) continue;
-                
-                int before = kv.second;
-                int after = target->hp;
-                int healing = std::max(0, after - before);
+            for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+                int healing = actorHP[i].delta;
                 
                 if (healing > 0) {
                     damageFound = true;
-                    RPG::Actor* actor = reinterpret_cast<RPG::Actor*>(target);
-                    debugMessage += "Actor " + std::to_string(actor->id) + " healed " + std::to_string(healing) + " HP\n";
+                    detectedBattler = "Actor";
+                    detectedChange = "healed";
+                    detectedUnit = "HP";
+                    detectedId = actorHP[i].battler->id;
+                    detectedAmount = healing;
                     break;  // Found healing, no need to check further
                 }
             }
@@ -632,65 +804,55 @@ void checkDamageAndApplyGain() {
         
         // If damage/healing was found, apply the appropriate gain
         if (damageFound) {
-            // Show debug message box if enabled
-            if (LimitBreakConfig::enableDebugMessages && lastActionActor) {
-                std::string actionType = "Actor " + std::to_string(lastActionActor->id) + " action detected:\n";
-                Dialog::Show(actionType + debugMessage, "Limit Break Debug");
+            // Write debug trace if enabled
+            if (lastActionActor) {
+                ASYNC_LOGF(LimitBreakConfig::enableDebugMessages, "Limit Break Debug",
+                           "Actor %d action detected:\n%s %d %s %d %s", lastActionActor->id,
+                           detectedBattler, detectedId, detectedChange, detectedAmount, detectedUnit);
             }
             
             checkActorDamageToMonsters();
             checkActorHealing();
             
-            // Update preHP with current HP for next frame's comparison
-            preHP = currentHP;
+            // Use the current HP as the snapshot for next frame's comparison
+            rebaseHpSnapshot();
             
             // Update the ultimate limit bar
             updateUltimateLimitBar();
         }
     } else {
         // Monster action - check for damage to actors
-        std::map<RPG::Battler*, int> currentHP;
-        
-        // Record current HP of actors
-        for (int i = 1; i <= RPG::actors.count(); ++i) {
-            RPG::Actor* a = RPG::actors[i];
-            if (a) currentHP[a] = a->hp;
-        }
-        
-        // Check for damage to actors
-        for (auto& kv : preHP) {
-            RPG::Battler* target = kv.first;
-            if (!target || target->isMonster()) continue;
-            
-            int before = kv.second;
-            int after = target->hp;
-            int delta = std::max(0, before - after);
+        for (int i = 0; i < MAX_PARTY_SLOTS; ++i) {
+            int delta = -actorHP[i].delta;
             
             if (delta > 0) {
                 damageFound = true;
-                RPG::Actor* actor = reinterpret_cast<RPG::Actor*>(target);
-                debugMessage += "Actor " + std::to_string(actor->id) + " took " + std::to_string(delta) + " damage\n";
+                detectedBattler = "Actor";
+                detectedChange = "took";
+                detectedUnit = "damage";
+                detectedId = actorHP[i].battler->id;
+                detectedAmount = delta;
                 break;  // Found damage, no need to check further
             }
         }
         
         // If damage was found, apply the appropriate gain
         if (damageFound) {
-            // Show debug message box if enabled
-            if (LimitBreakConfig::enableDebugMessages && lastActionMonster) {
-                std::string actionType = "Monster " + std::to_string(lastActionMonster->id) + " action detected:\n";
-                Dialog::Show(actionType + debugMessage, "Limit Break Debug");
+            // Write debug trace if enabled
+            if (lastActionMonster) {
+                ASYNC_LOGF(LimitBreakConfig::enableDebugMessages, "Limit Break Debug",
+                           "Monster %d action detected:\n%s %d %s %d %s", lastActionMonster->id,
+                           detectedBattler, detectedId, detectedChange, detectedAmount, detectedUnit);
             }
             
             checkMonsterDamageToActors();
             
-            // Update preHP with current HP for next frame's comparison
-            preHP = currentHP;
+            // Use the current HP as the snapshot for next frame's comparison
+            rebaseHpSnapshot();
             
             // Update the ultimate limit bar
             updateUltimateLimitBar();
         }
     }
 }
-
 } // namespace LimitBreakCalculate 
\ No newline at end of file
@@ -3,6 +3,8 @@
  * Loads and manages all settings from DynRPG.ini.
  */
 
+#include "../common/ini_cache.cpp"
+
 namespace LimitBreakConfig
 {
 // ========================================================================
@@ -19,14 +21,45 @@ static bool useFourActorsForUltimate = false;  // false = 3 actors (33% each), t
 static int ultimateLimitCommandId = 0;  // ID of the "Ultimate Limit" command in battle
 static bool ultimateLimitCommandSelected = false; // Flag to track if Ultimate Limit command was selected
 
+// Damage Detection Configuration
+static bool pollDamageEveryFrame = false;  // false = settle HP changes at action boundaries, true = poll HP every frame
+
 // Debug Configuration
-static bool enableDebugMessages = false;  // Whether to show debug message boxes
+static bool enableDebugMessages = false;  // Whether to write debug messages to the trace log
 
 // Actor Configuration
 static int maxActorId = 20;  // Maximum actor ID to check for configuration (default: 20)
 
-// Actor configuration
-static std::map<int, std::tuple<int, int, int, int, int>> actorConfig;
+// Highest accepted MaxActorId; the actor tables are sized from MaxActorId, so a
+// mistyped value must not allocate huge tables (RPG Maker 2003 database limit)
+const int MAX_CONFIG_ACTOR_ID = 5000;
+
+/**
+ * @brief Precomputed limit configuration of one actor
+ * 
+ * @note Built once by LoadConfig so gain calculations only need array reads.
+ *       The equipment multiplier is cached and recalculated only when the
+ *       actor's equipment changes.
+ */
+struct ActorProfile {
+    bool configured;           // Whether all required limit settings are present
+    int limitVarId;            // Variable storing the limit gauge value
+    int modeVarId;             // Variable storing the limit mode
+    int defaultMode;           // Mode used when the mode variable is out of range
+    int limitSkillVarId;       // Variable storing the limit skill ID
+    int defaultLimitSkillId;   // Limit skill used when the skill variable has no valid ID
+    int ultimateLimitSkillId;  // Ultimate limit skill ID (0 = none)
+    short equipIds[5];         // Equipment the cached multiplier was calculated for
+    float equipMultiplier;     // Cached equipment multiplier
+    bool multiplierCached;     // Whether equipMultiplier is valid
+};
+
+// Actor profiles indexed by actor database ID (1 to maxActorId, index 0 is unused)
+static std::vector<ActorProfile> actorProfiles;
+
+// Ultimate Limit skill IDs of actors above maxActorId
+// Key: Actor ID, Value: Ultimate Limit skill ID
+static std::map<int, int> extraUltimateLimitSkillIds;
 
 // Equipment-Based Multipliers for Limit Gain
 // Key: Equipment Item ID, Value: Multiplier value to add to base 1.0
@@ -35,6 +68,12 @@ static std::map<short, float> equipmentMultipliers;
 // Configuration for enabling and positioning the ultimate limit bar
 // Determines whether the ultimate limit bar should be drawn at all
 static bool drawUltimateBar = true;
+// Cut all three bar layers out of atlas.png instead of loading three files
+static bool useImageAtlas = false;
+// Layer rectangles in atlas.png as x,y,width,height
+static std::vector<int> atlasBackgroundRect;
+static std::vector<int> atlasBarRect;
+static std::vector<int> atlasForegroundRect;
 // X coordinate for the background image of the ultimate bar (from left edge of screen)
 static int ultimateBarBgX = 160;
 // Y coordinate for the background image of the ultimate bar (from top edge of screen)
@@ -75,10 +114,6 @@ static int barFrameHeight = 0;
 static int barFrameWidth = 0;
 // Animation speed control - higher values create slower animations
 static int barAnimationSpeed = 5;
-// Tracks which animation frame is currently being displayed
-static int currentBarFrame = 0;
-// Internal counter for controlling animation timing
-static int barAnimationCounter = 0;
 // Master switch to enable/disable bar animation
 static bool barUseAnimation = false;
 // Sequence of frame indices to display when bar is not at 100%
@@ -95,10 +130,6 @@ static int bgFrameHeight = 0;
 static int bgFrameWidth = 0;
 // Background animation speed - higher values create slower animations
 static int bgAnimationSpeed = 5;
-// Tracks which background frame is currently being displayed
-static int currentBgFrame = 0;
-// Internal counter for controlling background animation timing
-static int bgAnimationCounter = 0;
 // Master switch to enable/disable background animation
 static bool bgUseAnimation = false;
 // Sequence of background frames to display when bar is not at 100%
@@ -115,10 +146,6 @@ static int fgFrameHeight = 0;
 static int fgFrameWidth = 0;
 // Foreground animation speed - higher values create slower animations
 static int fgAnimationSpeed = 5;
-// Tracks which foreground frame is currently being displayed
-static int currentFgFrame = 0;
-// Internal counter for controlling foreground animation timing
-static int fgAnimationCounter = 0;
 // Master switch to enable/disable foreground animation
 static bool fgUseAnimation = false;
 // Sequence of foreground frames to display when bar is not at 100%
@@ -228,7 +255,7 @@ std::vector<int> parseIntList(const std::string& str) {
  */
 bool LoadConfig(char *pluginName) {
     // Load configuration dictionary from DynRPG.ini using the plugin name as section
-    std::map<std::string, std::string> config = RPG::loadConfiguration(pluginName);
+    std::map<std::string, std::string> config = IniCache::loadConfiguration(pluginName);
     
     // Process core game settings
     // These control basic plugin functionality and must be properly configured
@@ -250,16 +277,47 @@ bool LoadConfig(char *pluginName) {
         enableDebugMessages = stringToBool(config["EnableDebugMessages"], false);
     }
     
+    // Start the trace log before any debug message is written
+    if (enableDebugMessages) {
+        Dialog::InitTrace(config);
+    }
+    
+    if (config.find("DamageDetection") != config.end()) {
+        pollDamageEveryFrame = (config["DamageDetection"] == "frame");
+    }
+    
     if (config.find("MaxActorId") != config.end()) {
         maxActorId = stringToInt(config["MaxActorId"], 20);
         // Ensure maxActorId is at least 1
         maxActorId = std::max(1, maxActorId);
+        if (maxActorId > MAX_CONFIG_ACTOR_ID) {
+            if (enableDebugMessages) {
+                Dialog::Show("MaxActorId=" + std::to_string(maxActorId) + " exceeds " +
+                             std::to_string(MAX_CONFIG_ACTOR_ID) + ", using " +
+                             std::to_string(MAX_CONFIG_ACTOR_ID), "Configuration Error");
+            }
+            maxActorId = MAX_CONFIG_ACTOR_ID;
+        }
     }
 	
     // Process UI configuration for the Ultimate Bar display
     if (config.find("DrawUltimateBar") != config.end()) {
         drawUltimateBar = stringToBool(config["DrawUltimateBar"], true);
     }
+
+    // Optional image atlas holding all three bar layers
+    if (config.find("UseImageAtlas") != config.end()) {
+        useImageAtlas = stringToBool(config["UseImageAtlas"], false);
+    }
+    if (config.find("AtlasBackground") != config.end()) {
+        atlasBackgroundRect = parseIntList(config["AtlasBackground"]);
+    }
+    if (config.find("AtlasBar") != config.end()) {
+        atlasBarRect = parseIntList(config["AtlasBar"]);
+    }
+    if (config.find("AtlasForeground") != config.end()) {
+        atlasForegroundRect = parseIntList(config["AtlasForeground"]);
+    }
     
     // Load vertical bar configuration first to determine defaults
     if (config.find("UseVerticalBar") != config.end()) useVerticalBar = stringToBool(config["UseVerticalBar"], false);
@@ -547,84 +605,98 @@ bool LoadConfig(char *pluginName) {
     }
     
     // Process actor-specific configurations
-    actorConfig.clear();
-    
-    // Iterate through possible actor IDs (1 to maxActorId)
-    // RPG Maker 2003 actor IDs start at 1, not 0
-    for (int i = 1; i <= maxActorId; ++i) { // Support up to maxActorId actors
-        // Create the prefix used for all keys related to this actor (e.g., "Actor1LimitVarID")
-        std::string actorPrefix = "Actor" + std::to_string(i);
+    actorProfiles.assign(maxActorId + 1, ActorProfile());
+    
+    // Collect the Actor<N><Setting> keys of each actor from the pre-indexed section
+    // Each actor needs 5 configuration values to be fully set up
+    const IniCache::Section& section = IniCache::getSection(pluginName);
+    static const char* const requiredSettings[5] = {
+        "LimitVarID",          // Variable to store limit value (0-100%)
+        "ModeVarID",           // Variable to store current limit mode
+        "DefaultMode",         // Default mode if variable is out of range
+        "LimitSkillVarID",     // Variable to store limit skill ID
+        "DefaultLimitSkillID"  // Default skill if variable has no value
+    };
+    struct ActorKeys {
+        bool exists;
+        const std::string* required[5];
+    };
+    std::vector<ActorKeys> actorKeys(maxActorId + 1, ActorKeys());
+    extraUltimateLimitSkillIds.clear();
+    
+    for (const IniCache::IndexedKey& key : section.getIndexed("Actor")) {
+        // RPG Maker 2003 actor IDs start at 1, not 0
+        if (key.index < 1) {
+            continue;
+        }
         
-        // Check if any configuration for this actor exists by searching for keys with this prefix
-        bool actorConfigExists = false;
-        for (const auto& entry : config) {
-            if (entry.first.find(actorPrefix) == 0) {
-                actorConfigExists = true;
-                break;
+        // Ultimate-only actors are found at any ID, like before the profile table
+        if (key.index > maxActorId) {
+            if (key.suffix == "UltimateLimitSkillID") {
+                extraUltimateLimitSkillIds[key.index] = stringToInt(key.value, 0);
             }
+            continue;
         }
         
-        if (!actorConfigExists) {
-            continue; // Skip to next actor if no config for this one
+        ActorKeys& keys = actorKeys[key.index];
+        keys.exists = true;
+        
+        // The Ultimate Limit skill is optional and also used by actors without limit gain
+        if (key.suffix == "UltimateLimitSkillID") {
+            actorProfiles[key.index].ultimateLimitSkillId = stringToInt(key.value, 0);
+            continue;
         }
         
-        // Define all required configuration keys for this actor
-        // Each actor needs 5 configuration values to be fully set up
-        std::string limitVarKey = actorPrefix + "LimitVarID";       // Variable to store limit value (0-100%)
-        std::string modeVarKey = actorPrefix + "ModeVarID";         // Variable to store current limit mode
-        std::string defaultModeKey = actorPrefix + "DefaultMode";   // Default mode if variable is out of range
-        std::string limitSkillVarKey = actorPrefix + "LimitSkillVarID"; // Variable to store limit skill ID
-        std::string defaultLimitSkillKey = actorPrefix + "DefaultLimitSkillID"; // Default skill if variable has no value
+        for (int k = 0; k < 5; ++k) {
+            if (key.suffix == requiredSettings[k]) {
+                keys.required[k] = &key.value;
+                break;
+            }
+        }
+    }
+    
+    for (int i = 1; i <= maxActorId; ++i) { // Support up to maxActorId actors
+        const ActorKeys& keys = actorKeys[i];
+        if (!keys.exists) {
+            continue; // Skip to next actor if no config for this one
+        }
         
         // Ensure all required keys are present for this actor
         bool allKeysPresent = true;
         std::string missingKeys;
         
         // Check each required key and track any missing ones
-        if (config.find(limitVarKey) == config.end()) {
-            allKeysPresent = false;
-            missingKeys += limitVarKey + " ";
-        }
-        
-        if (config.find(modeVarKey) == config.end()) {
-            allKeysPresent = false;
-            missingKeys += modeVarKey + " ";
-        }
-        
-        if (config.find(defaultModeKey) == config.end()) {
-            allKeysPresent = false;
-            missingKeys += defaultModeKey + " ";
-        }
-        
-        if (config.find(limitSkillVarKey) == config.end()) {
-            allKeysPresent = false;
-            missingKeys += limitSkillVarKey + " ";
-        }
-        
-        if (config.find(defaultLimitSkillKey) == config.end()) {
-            allKeysPresent = false;
-            missingKeys += defaultLimitSkillKey + " ";
+        for (int k = 0; k < 5; ++k) {
+            if (!keys.required[k]) {
+                allKeysPresent = false;
+                missingKeys += "Actor" + std::to_string(i) + requiredSettings[k] + " ";
+            }
         }
         
         // Skip actors with incomplete configuration
         if (!allKeysPresent) {
             if (enableDebugMessages) {
-                std::string msg = "Missing required keys for " + actorPrefix + ": " + missingKeys;
+                std::string msg = "Missing required keys for Actor" + std::to_string(i) + ": " + missingKeys;
                 Dialog::Show(msg, "Configuration Error");
             }
             continue; // Skip to next actor
         }
         
         // All required keys are present, read the values and convert from strings
-        int limitVarId = stringToInt(config[limitVarKey]);           // Variable storing the limit gauge value
-        int modeVarId = stringToInt(config[modeVarKey]);             // Variable storing the limit mode
-        int defaultMode = stringToInt(config[defaultModeKey]);       // Default mode (0=Stoic, 1=Warrior, 2=Comrade, 3=Healer, 4=Knight)
-        int limitSkillVarId = stringToInt(config[limitSkillVarKey]); // Variable storing the limit skill ID
-        int defaultLimitSkillId = stringToInt(config[defaultLimitSkillKey]); // Default limit skill ID to use
-        
-        // Store the configuration in the actor map using a tuple to pack all values together
-        // This allows efficient storage and retrieval of all actor settings
-        actorConfig[i] = std::make_tuple(limitVarId, modeVarId, defaultMode, limitSkillVarId, defaultLimitSkillId);
+        int limitVarId = stringToInt(*keys.required[0]);          // Variable storing the limit gauge value
+        int modeVarId = stringToInt(*keys.required[1]);           // Variable storing the limit mode
+        int defaultMode = stringToInt(*keys.required[2]);         // Default mode (0=Stoic, 1=Warrior, 2=Comrade, 3=Healer, 4=Knight)
+        int limitSkillVarId = stringToInt(*keys.required[3]);     // Variable storing the limit skill ID
+        int defaultLimitSkillId = stringToInt(*keys.required[4]); // Default limit skill ID to use
+        
+        // Store the configuration in the actor's profile
+        ActorProfile& profile = actorProfiles[i];
+        profile.configured = true;
+        profile.limitVarId = limitVarId;
+        profile.modeVarId = modeVarId;
+        profile.defaultMode = defaultMode;
+        profile.limitSkillVarId = limitSkillVarId;
+        profile.defaultLimitSkillId = defaultLimitSkillId;
     }
     
     // Process equipment-based limit gain multipliers
@@ -675,30 +747,45 @@ bool LoadConfig(char *pluginName) {
     if (!configValid) {
         std::string errorMsg = "Limit Break Plugin Configuration Error:\n\n" + missingConfig + 
                               "\nPlease check your DynRPG.ini file.";
-        Dialog::Show(errorMsg, "Limit Break Plugin Error");
+        Dialog::Alert(errorMsg, "Limit Break Plugin Error");
         return false;
     }
     
     return true;
 }
 
+/**
+ * @brief Gets the profile of a configured actor
+ * 
+ * @param actorId The database ID of the actor
+ * @return ActorProfile* The actor's profile, or nullptr if the actor has no
+ *         complete limit configuration
+ */
+ActorProfile* getActorProfile(int actorId) {
+    if (actorId <= 0 || actorId >= static_cast<int>(actorProfiles.size()))
+        return nullptr;
+
+    ActorProfile* profile = &actorProfiles[actorId];
+    return profile->configured ? profile : nullptr;
+}
+
 /**
  * @brief Gets the current mode for an actor based on configuration
  * 
  * @param actorId The database ID of the actor to check
- * @return int The active mode (0-4) or -1 if the actor should be skipped
+ * @return int The active mode (index into LimitBreakModes::limitModes) or -1 if the actor should be skipped
  * 
- * @note Modes: 0=Stoic, 1=Warrior, 2=Comrade, 3=Healer, 4=Knight
+ * @note Modes: 0=Stoic, 1=Warrior, 2=Comrade, 3=Healer, 4=Knight, followed by any custom modes
  *       A return value of -1 indicates the actor should not gain limit
  */
 int getActorMode(int actorId) {
-    auto cfgIt = actorConfig.find(actorId);
-    if (cfgIt == actorConfig.end())
+    ActorProfile* profile = getActorProfile(actorId);
+    if (!profile)
         return -1; // No config for this actor - skip processing
 
     // Get the mode variable ID and default mode from config
-    int modeVarId = std::get<1>(cfgIt->second);
-    int defaultMode = std::get<2>(cfgIt->second);
+    int modeVarId = profile->modeVarId;
+    int defaultMode = profile->defaultMode;
 
     // Get the current mode value from the RPG Maker variable
     int currentMode = RPG::variables[modeVarId];
@@ -706,7 +793,7 @@ int getActorMode(int actorId) {
     // Apply the logic for mode selection based on variable value
     if (currentMode < 0)
         return -1; // Skip processing for this actor (no limit gain)
-    else if (currentMode >= 0 && currentMode <= 4)
+    else if (currentMode < LimitBreakModes::MODE_COUNT)
         return currentMode; // Valid mode range, use the variable value
     else
         return defaultMode; // Out of range, use the default mode
@@ -723,13 +810,13 @@ int getActorMode(int actorId) {
  *       Otherwise, the default skill ID from configuration is used.
  */
 int getActorLimitSkillId(int actorId) {
-    auto cfgIt = actorConfig.find(actorId);
-    if (cfgIt == actorConfig.end())
+    ActorProfile* profile = getActorProfile(actorId);
+    if (!profile)
         return 0; // No config for this actor - return 0 (invalid skill ID)
         
     // Get the limit skill variable ID and default skill ID from config
-    int limitSkillVarId = std::get<3>(cfgIt->second);
-    int defaultLimitSkillId = std::get<4>(cfgIt->second);
+    int limitSkillVarId = profile->limitSkillVarId;
+    int defaultLimitSkillId = profile->defaultLimitSkillId;
     
     // If the variable ID is valid, get the skill ID from the variable
     if (limitSkillVarId > 0) {
@@ -748,17 +835,20 @@ int getActorLimitSkillId(int actorId) {
  * 
  * @param actorId The database ID of the actor
  * @return int The actor's Ultimate Limit skill ID, or 0 if not configured
+ * 
+ * @note Read from the actor profile, which LoadConfig fills for actor IDs
+ *       up to MaxActorId. Actors above MaxActorId are looked up in a small
+ *       side table, so Actor<N>UltimateLimitSkillID works for any N.
  */
 int getActorUltimateLimitSkillId(int actorId) {
-    std::string key = "Actor" + std::to_string(actorId) + "UltimateLimitSkillID";
-    
-    // Use the same approach as other config values - lookup in the configuration map
-    std::map<std::string, std::string> config = RPG::loadConfiguration("limit_break");
-    if (config.find(key) != config.end()) {
-        return stringToInt(config[key], 0);
+    if (actorId <= 0)
+        return 0; // Return 0 if no Ultimate Limit skill is configured for this actor
+
+    if (actorId >= static_cast<int>(actorProfiles.size())) {
+        std::map<int, int>::const_iterator it = extraUltimateLimitSkillIds.find(actorId);
+        return it != extraUltimateLimitSkillIds.end() ? it->second : 0;
     }
-    
-    return 0; // Return 0 if no Ultimate Limit skill is configured for this actor
+    return actorProfiles[actorId].ultimateLimitSkillId;
 }
 
 } // namespace LimitBreakConfig 
@@ -3,6 +3,8 @@
  * Contains functions for drawing the Ultimate Limit Bar gauge.
  */
 
+#include "../common/sprite_timeline.cpp"
+
 namespace LimitBreakGraphics
 {
 // ========================================================================
@@ -14,6 +16,46 @@ static RPG::Image* ultimateBarBgImg = nullptr;
 static RPG::Image* ultimateBarBarImg = nullptr;
 static RPG::Image* ultimateBarFgImg = nullptr;
 
+// Bar image pre-stretched to the full bar length for every animation frame,
+// drawn with one clipped blit per frame
+static RPG::Image* ultimateBarStripImg = nullptr;
+
+// Whether loadUltimateBarImages has run since the images were last freed
+static bool imagesLoaded = false;
+
+// Retained composite of background, bar and foreground, drawn with one blit
+// and rebuilt only when the fill or an animation frame changes
+static RPG::Image* ultimateBarCompositeImg = nullptr;
+// Screen position of the composite (top-left corner of all layers)
+static int compositeX = 0;
+static int compositeY = 0;
+// Composite palette index for each color of the layer images
+static unsigned char bgColorMap[256];
+static unsigned char barColorMap[256];
+static unsigned char fgColorMap[256];
+// Layer state the composite currently shows
+static bool compositeValid = false;
+static int composedFill = -1;
+static int composedBgFrame = -1;
+static int composedBarFrame = -1;
+static int composedFgFrame = -1;
+
+// Animation states of every layer, used as timeline state indices
+enum LayerState {
+    LAYER_UNFILLED = 0,  // Bar below 100%
+    LAYER_FILLED = 1     // Bar at 100%
+};
+
+// Precomputed frame timeline of each layer, built when the images are loaded
+static SpriteTimeline::Timeline bgTimeline;
+static SpriteTimeline::Timeline barTimeline;
+static SpriteTimeline::Timeline fgTimeline;
+
+// Playback position of each layer in its timeline
+static SpriteTimeline::Player bgPlayer;
+static SpriteTimeline::Player barPlayer;
+static SpriteTimeline::Player fgPlayer;
+
 /**
  * @brief Check if a file exists at the specified path
  *
@@ -28,183 +70,533 @@ bool FileExist(const std::string& filename) {
 }
 
 /**
- * @brief Loads the images needed for the Ultimate Limit Bar
+ * @brief Builds the cached bar strip from the loaded bar image
  *
- * @note This function:
- *       1. Loads background.png, bar.png, and foreground.png from the DynRessource\limit_break folder
- *       2. Configures image properties (alpha, mask color, etc.)
- *       3. Calculates frame dimensions if animation is enabled
- *       4. Handles both horizontal and vertical bar layouts
- *       5. Logs debug messages if image loading fails
+ * @note The bar is drawn by repeating the first pixel column (horizontal bar)
+ *       or the first pixel row (vertical bar) of the current frame up to the
+ *       fill length. The strip holds that repetition at the full bar length
+ *       for every frame, laid out like bar.png:
+ *       - Horizontal: UltimateBarWidth wide, frames stacked vertically
+ *       - Vertical: frames side by side, UltimateBarHeight high
  *
- *       Only bar.png is strictly required; the others are optional.
+ *       Any fill level of any frame is then a sub-rectangle of the strip.
+ *       The strip is left empty if the bar size or frame size is invalid.
  */
-void loadUltimateBarImages() {
-    // Load background image
-    if (!ultimateBarBgImg) {
-        ultimateBarBgImg = RPG::Image::create();
-        ultimateBarBgImg->useMaskColor = true;
-
-        std::string bgPath = "DynRessource\\limit_break\\background.png";
-        if (FileExist(bgPath)) {
-            ultimateBarBgImg->loadFromFile(bgPath, false);
-            ultimateBarBgImg->alpha = 255;
-
-            // Calculate frame dimensions based on layout type
-            if (LimitBreakConfig::bgUseAnimation && LimitBreakConfig::bgFrameCount > 1) {
-                if (LimitBreakConfig::useVerticalBar) {
-                    // For vertical bars, split frames horizontally
-                    LimitBreakConfig::bgFrameWidth = ultimateBarBgImg->width / LimitBreakConfig::bgFrameCount;
-
-                    if (LimitBreakConfig::enableDebugMessages) {
-                        std::string msg = "Background loaded with horizontal animation. Size: ";
-                        msg += std::to_string(ultimateBarBgImg->width) + "x" + std::to_string(ultimateBarBgImg->height);
-                        msg += ", Frames: " + std::to_string(LimitBreakConfig::bgFrameCount);
-                        msg += ", Frame Width: " + std::to_string(LimitBreakConfig::bgFrameWidth);
-                        Dialog::Show(msg, "Ultimate Bar Debug");
-                    }
-                } else {
-                    // For horizontal bars, split frames vertically into multiple images
-                    LimitBreakConfig::bgFrameHeight = ultimateBarBgImg->height / LimitBreakConfig::bgFrameCount;
-
-                    if (LimitBreakConfig::enableDebugMessages) {
-                        std::string msg = "Background loaded with vertical animation. Size: ";
-                        msg += std::to_string(ultimateBarBgImg->width) + "x" + std::to_string(ultimateBarBgImg->height);
-                        msg += ", Frames: " + std::to_string(LimitBreakConfig::bgFrameCount);
-                        msg += ", Frame Height: " + std::to_string(LimitBreakConfig::bgFrameHeight);
-                        Dialog::Show(msg, "Ultimate Bar Debug");
-                    }
-                }
-            } else if (LimitBreakConfig::enableDebugMessages) {
-                std::string msg = "Background loaded. Size: ";
-                msg += std::to_string(ultimateBarBgImg->width) + "x" + std::to_string(ultimateBarBgImg->height);
-                Dialog::Show(msg, "Ultimate Bar Debug");
+void buildUltimateBarStrip() {
+    RPG::Image* src = ultimateBarBarImg;
+    bool animated = LimitBreakConfig::barUseAnimation && LimitBreakConfig::barFrameCount > 1;
+    int frames = animated ? LimitBreakConfig::barFrameCount : 1;
+
+    int stripWidth = 0;
+    int stripHeight = 0;
+    if (LimitBreakConfig::useVerticalBar) {
+        int frameWidth = animated ? LimitBreakConfig::barFrameWidth : src->width;
+        stripWidth = std::min(src->width, frames * frameWidth);
+        stripHeight = LimitBreakConfig::ultimateBarHeight;
+    } else {
+        int frameHeight = animated ? LimitBreakConfig::barFrameHeight : src->height;
+        stripWidth = LimitBreakConfig::ultimateBarWidth;
+        stripHeight = std::min(src->height, frames * frameHeight);
+    }
+    if (stripWidth <= 0 || stripHeight <= 0) return;
+
+    ultimateBarStripImg = RPG::Image::create(stripWidth, stripHeight);
+    ultimateBarStripImg->useMaskColor = true;
+    ultimateBarStripImg->alpha = 255;
+    memcpy(ultimateBarStripImg->palette, src->palette, sizeof(src->palette));
+
+    unsigned char* dst = ultimateBarStripImg->pixels;
+    if (LimitBreakConfig::useVerticalBar) {
+        // Every row is the first row of bar.png
+        for (int y = 0; y < stripHeight; ++y) {
+            memcpy(dst + y * stripWidth, src->pixels, stripWidth);
+        }
+    } else {
+        // Every column is the first column of bar.png
+        for (int y = 0; y < stripHeight; ++y) {
+            memset(dst + y * stripWidth, src->pixels[y * src->width], stripWidth);
+        }
+    }
+
+    if (LimitBreakConfig::enableDebugMessages) {
+        std::string msg = "Bar strip built. Size: ";
+        msg += std::to_string(stripWidth) + "x" + std::to_string(stripHeight);
+        msg += ", Frames: " + std::to_string(frames);
+        Dialog::Show(msg, "Ultimate Bar Debug");
+    }
+}
+
+/**
+ * @brief Part of a layer image that is drawn at a screen position
+ */
+struct LayerRect {
+    RPG::Image* image;  // Source image, nullptr if the layer is not drawn
+    int srcX;           // Left edge of the drawn part in the source image
+    int srcY;           // Top edge of the drawn part in the source image
+    int width;          // Width of the drawn part
+    int height;         // Height of the drawn part
+    int x;              // Screen X position
+    int y;              // Screen Y position
+};
+
+/**
+ * @brief Gets the drawn part of the background or foreground image
+ *
+ * @param image The layer image
+ * @param player The layer's playback position
+ * @param x Screen X position of the layer
+ * @param y Screen Y position of the layer
+ * @return LayerRect The shown frame, with image set to nullptr if nothing is drawn
+ */
+LayerRect getFrameLayerRect(RPG::Image* image, const SpriteTimeline::Player& player, int x, int y) {
+    LayerRect rect = { nullptr, 0, 0, 0, 0, x, y };
+    if (!image || !player.active()) return rect;
+
+    const SpriteTimeline::Frame& frame = player.frame();
+    rect.image = image;
+    rect.srcX = frame.srcX;
+    rect.srcY = frame.srcY;
+    rect.width = frame.width;
+    rect.height = frame.height;
+    return rect;
+}
+
+/**
+ * @brief Gets the drawn part of the cached bar strip
+ *
+ * @param fill The fill percentage (0-100)
+ * @return LayerRect The filled part of the current bar frame, with image
+ *         set to nullptr if nothing is drawn
+ *
+ * @note Horizontal bars fill from the left, vertical bars from the bottom
+ */
+LayerRect getBarLayerRect(int fill) {
+    LayerRect rect = { nullptr, 0, 0, 0, 0, LimitBreakConfig::ultimateBarBarX, LimitBreakConfig::ultimateBarBarY };
+    if (!ultimateBarStripImg || !barPlayer.active()) return rect;
+
+    const SpriteTimeline::Frame& frame = barPlayer.frame();
+    rect.srcX = frame.srcX;
+    rect.srcY = frame.srcY;
+    if (LimitBreakConfig::useVerticalBar) {
+        int length = (LimitBreakConfig::ultimateBarHeight * fill) / 100;
+        rect.width = frame.width;
+        rect.height = length;
+        rect.y += LimitBreakConfig::ultimateBarHeight - length;
+    } else {
+        rect.width = (LimitBreakConfig::ultimateBarWidth * fill) / 100;
+        rect.height = frame.height;
+    }
+
+    if (rect.width > 0 && rect.height > 0) rect.image = ultimateBarStripImg;
+    return rect;
+}
+
+/**
+ * @brief Grows a bounding box to contain a layer rectangle
+ *
+ * @param rect The layer rectangle (ignored if it has no image)
+ * @param left, top, right, bottom The bounding box (updated)
+ */
+void addLayerBounds(const LayerRect& rect, int& left, int& top, int& right, int& bottom) {
+    if (!rect.image) return;
+    left = std::min(left, rect.x);
+    top = std::min(top, rect.y);
+    right = std::max(right, rect.x + rect.width);
+    bottom = std::max(bottom, rect.y + rect.height);
+}
+
+/**
+ * @brief Adds the colors used by a layer image to the composite palette
+ *
+ * @param image The layer image
+ * @param colorMap Receives the composite palette index for each layer color
+ * @param colorCount Number of composite palette entries in use (updated)
+ * @return bool False if the composite palette is full
+ *
+ * @note Index 0 is the mask color in every image and is never mapped
+ */
+bool mapLayerColors(RPG::Image* image, unsigned char* colorMap, int& colorCount) {
+    if (!image) return true;
+
+    bool used[256] = { false };
+    int pixelCount = image->width * image->height;
+    for (int i = 0; i < pixelCount; ++i) {
+        used[image->pixels[i]] = true;
+    }
+
+    for (int color = 1; color < 256; ++color) {
+        if (!used[color]) continue;
+
+        int index = 0;
+        for (int i = 1; i < colorCount; ++i) {
+            if (ultimateBarCompositeImg->palette[i] == image->palette[color]) {
+                index = i;
+                break;
             }
-        } else if (LimitBreakConfig::enableDebugMessages) {
-            std::string msg = "Background image not found: " + bgPath;
-            Dialog::Show(msg, "Ultimate Bar Debug");
         }
+        if (index == 0) {
+            if (colorCount >= 256) return false;
+            index = colorCount++;
+            ultimateBarCompositeImg->palette[index] = image->palette[color];
+        }
+        colorMap[color] = static_cast<unsigned char>(index);
     }
+    return true;
+}
 
-    // Load bar image
-    if (!ultimateBarBarImg) {
-        ultimateBarBarImg = RPG::Image::create();
-        ultimateBarBarImg->useMaskColor = true;
-        // Set autoResize to true to ensure the image resizes properly when loaded
-        ultimateBarBarImg->autoResize = true;
-
-        std::string barPath = "DynRessource\\limit_break\\bar.png";
-        if (FileExist(barPath)) {
-            // Try loading with throwErrors=true to see any loading errors
-            try {
-                ultimateBarBarImg->loadFromFile(barPath, true);
-                ultimateBarBarImg->alpha = 255;
-
-                // Calculate frame dimensions based on layout type
-                if (LimitBreakConfig::barUseAnimation && LimitBreakConfig::barFrameCount > 1) {
-                    if (LimitBreakConfig::useVerticalBar) {
-                        // For vertical bars, split frames horizontally
-                        LimitBreakConfig::barFrameWidth = ultimateBarBarImg->width / LimitBreakConfig::barFrameCount;
-
-                        if (LimitBreakConfig::enableDebugMessages) {
-                            std::string msg = "Bar loaded with horizontal animation. Size: ";
-                            msg += std::to_string(ultimateBarBarImg->width) + "x" + std::to_string(ultimateBarBarImg->height);
-                            msg += ", Frames: " + std::to_string(LimitBreakConfig::barFrameCount);
-                            msg += ", Frame Width: " + std::to_string(LimitBreakConfig::barFrameWidth);
-                            Dialog::Show(msg, "Ultimate Bar Debug");
-                        }
-                    } else {
-                        // For horizontal bars, split frames vertically into multiple images
-                        LimitBreakConfig::barFrameHeight = ultimateBarBarImg->height / LimitBreakConfig::barFrameCount;
-
-                        if (LimitBreakConfig::enableDebugMessages) {
-                            std::string msg = "Bar loaded with vertical animation. Size: ";
-                            msg += std::to_string(ultimateBarBarImg->width) + "x" + std::to_string(ultimateBarBarImg->height);
-                            msg += ", Frames: " + std::to_string(LimitBreakConfig::barFrameCount);
-                            msg += ", Frame Height: " + std::to_string(LimitBreakConfig::barFrameHeight);
-                            Dialog::Show(msg, "Ultimate Bar Debug");
-                        }
-                    }
-                } else {
-                    if (LimitBreakConfig::enableDebugMessages) {
-                        std::string msg = "Bar loaded without animation. Size: ";
-                        msg += std::to_string(ultimateBarBarImg->width) + "x" + std::to_string(ultimateBarBarImg->height);
-                        Dialog::Show(msg, "Ultimate Bar Debug");
-                    }
-                }
-            } catch (...) {
-                if (LimitBreakConfig::enableDebugMessages) {
-                    Dialog::Show("Error loading bar image", "Ultimate Bar Debug");
-                }
+/**
+ * @brief Creates the retained composite image for background, bar and foreground
+ *
+ * @note The composite covers all three layers at their largest extent and
+ *       uses a palette merged from the layer images. If the layers use more
+ *       than 255 colors together, no composite is created and the layers are
+ *       drawn one by one instead.
+ */
+void buildUltimateBarComposite() {
+    // Largest drawn part of every layer; all frames of a layer have the same size
+    LayerRect bgRect = getFrameLayerRect(ultimateBarBgImg, bgPlayer,
+                                         LimitBreakConfig::ultimateBarBgX, LimitBreakConfig::ultimateBarBgY);
+    LayerRect barRect = getBarLayerRect(100);
+    LayerRect fgRect = getFrameLayerRect(ultimateBarFgImg, fgPlayer,
+                                         LimitBreakConfig::ultimateBarBgX, LimitBreakConfig::ultimateBarBgY);
+    if (!barRect.image) return;
+
+    int left = barRect.x;
+    int top = barRect.y;
+    int right = barRect.x + barRect.width;
+    int bottom = barRect.y + barRect.height;
+    addLayerBounds(bgRect, left, top, right, bottom);
+    addLayerBounds(fgRect, left, top, right, bottom);
+
+    ultimateBarCompositeImg = RPG::Image::create(right - left, bottom - top);
+    ultimateBarCompositeImg->useMaskColor = true;
+    ultimateBarCompositeImg->alpha = 255;
+    ultimateBarCompositeImg->palette[0] = 0;
+    compositeX = left;
+    compositeY = top;
+    compositeValid = false;
+
+    int colorCount = 1;
+    if (!mapLayerColors(bgRect.image, bgColorMap, colorCount) ||
+        !mapLayerColors(ultimateBarStripImg, barColorMap, colorCount) ||
+        !mapLayerColors(fgRect.image, fgColorMap, colorCount)) {
+        RPG::Image::destroy(ultimateBarCompositeImg);
+        ultimateBarCompositeImg = nullptr;
+
+        if (LimitBreakConfig::enableDebugMessages) {
+            Dialog::Show("Bar layers use more than 255 colors, drawing layers separately", "Ultimate Bar Debug");
+        }
+        return;
+    }
+
+    if (LimitBreakConfig::enableDebugMessages) {
+        std::string msg = "Bar composite built. Size: ";
+        msg += std::to_string(right - left) + "x" + std::to_string(bottom - top);
+        msg += ", Colors: " + std::to_string(colorCount - 1);
+        Dialog::Show(msg, "Ultimate Bar Debug");
+    }
+}
+
+/**
+ * @brief Copies a layer into the composite image
+ *
+ * @param rect The drawn part of the layer
+ * @param colorMap Composite palette index for each layer color
+ *
+ * @note Mask color pixels are skipped so lower layers stay visible
+ */
+void composeLayer(const LayerRect& rect, const unsigned char* colorMap) {
+    if (!rect.image) return;
+
+    RPG::Image* dst = ultimateBarCompositeImg;
+    int width = std::min(rect.width, rect.image->width - rect.srcX);
+    int height = std::min(rect.height, rect.image->height - rect.srcY);
+    int dstX = rect.x - compositeX;
+    int dstY = rect.y - compositeY;
+
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* srcRow = rect.image->pixels + (rect.srcY + y) * rect.image->width + rect.srcX;
+        unsigned char* dstRow = dst->pixels + (dstY + y) * dst->width + dstX;
+        for (int x = 0; x < width; ++x) {
+            if (srcRow[x]) dstRow[x] = colorMap[srcRow[x]];
+        }
+    }
+}
+
+/**
+ * @brief Draws a layer directly to the screen
+ *
+ * @param rect The drawn part of the layer
+ *
+ * @note Used when no composite image is available
+ */
+void drawLayer(const LayerRect& rect) {
+    if (!rect.image) return;
+    RPG::screen->canvas->draw(rect.x, rect.y, rect.image, rect.srcX, rect.srcY, rect.width, rect.height);
+}
+
+/**
+ * @brief Builds the frame timeline of a layer and starts its playback
+ *
+ * @param timeline The layer's timeline (rebuilt)
+ * @param player The layer's playback position (reset)
+ * @param image The layer image, or the bar strip for the bar
+ * @param useAnimation Whether animation is enabled for the layer
+ * @param frameCount Number of frames in the layer image
+ * @param frameWidth Frame width (vertical bars)
+ * @param frameHeight Frame height (horizontal bars)
+ * @param unfilledFrames Frame sequence while the bar is below 100%
+ * @param filledFrames Frame sequence while the bar is at 100%
+ * @param speed Draws each frame is shown for
+ *
+ * @note Vertical bars lay out their frames side by side, horizontal bars
+ *       stack them. A layer that is not animated gets a single frame covering
+ *       the whole image; a layer without a valid frame size draws nothing.
+ */
+void buildLayerTimeline(SpriteTimeline::Timeline& timeline, SpriteTimeline::Player& player, RPG::Image* image,
+                        bool useAnimation, int frameCount, int frameWidth, int frameHeight,
+                        const std::vector<int>& unfilledFrames, const std::vector<int>& filledFrames, int speed) {
+    std::vector<const std::vector<int>*> sequences(2);
+    sequences[LAYER_UNFILLED] = &unfilledFrames;
+    sequences[LAYER_FILLED] = &filledFrames;
+
+    if (!image || image->width <= 0 || image->height <= 0) {
+        timeline.clear();
+    } else if (!useAnimation || frameCount <= 1) {
+        SpriteTimeline::build(timeline, 1, image->width, image->height, false, sequences, 1);
+    } else if (LimitBreakConfig::useVerticalBar) {
+        SpriteTimeline::build(timeline, frameCount, frameWidth, image->height, true, sequences, speed);
+    } else {
+        SpriteTimeline::build(timeline, frameCount, image->width, frameHeight, false, sequences, speed);
+    }
+    player.reset(&timeline);
+}
+
+/**
+ * @brief Calculates the frame size of an animated layer image
+ *
+ * @param image The loaded layer image
+ * @param layerName Name of the layer used in debug messages
+ * @param useAnimation Whether animation is enabled for the layer
+ * @param frameCount Number of frames in the image
+ * @param frameWidth Frame width to update for vertical bars
+ * @param frameHeight Frame height to update for horizontal bars
+ *
+ * @note Vertical bars split their frames horizontally, horizontal bars
+ *       split them vertically.
+ */
+void calculateLayerFrames(RPG::Image* image, const char* layerName, bool useAnimation,
+                          int frameCount, int& frameWidth, int& frameHeight) {
+    if (useAnimation && frameCount > 1) {
+        if (LimitBreakConfig::useVerticalBar) {
+            // For vertical bars, split frames horizontally
+            frameWidth = image->width / frameCount;
+
+            if (LimitBreakConfig::enableDebugMessages) {
+                std::string msg = std::string(layerName) + " loaded with horizontal animation. Size: ";
+                msg += std::to_string(image->width) + "x" + std::to_string(image->height);
+                msg += ", Frames: " + std::to_string(frameCount);
+                msg += ", Frame Width: " + std::to_string(frameWidth);
+                Dialog::Show(msg, "Ultimate Bar Debug");
             }
         } else {
+            // For horizontal bars, split frames vertically into multiple images
+            frameHeight = image->height / frameCount;
+
             if (LimitBreakConfig::enableDebugMessages) {
-                std::string msg = "Bar image not found: " + barPath;
+                std::string msg = std::string(layerName) + " loaded with vertical animation. Size: ";
+                msg += std::to_string(image->width) + "x" + std::to_string(image->height);
+                msg += ", Frames: " + std::to_string(frameCount);
+                msg += ", Frame Height: " + std::to_string(frameHeight);
                 Dialog::Show(msg, "Ultimate Bar Debug");
             }
         }
+    } else if (LimitBreakConfig::enableDebugMessages) {
+        std::string msg = std::string(layerName) + " loaded. Size: ";
+        msg += std::to_string(image->width) + "x" + std::to_string(image->height);
+        Dialog::Show(msg, "Ultimate Bar Debug");
     }
+}
 
-    // Load foreground image
-    if (!ultimateBarFgImg) {
-        ultimateBarFgImg = RPG::Image::create();
-        ultimateBarFgImg->useMaskColor = true;
-        // Set autoResize to true to ensure the image resizes properly when loaded
-        ultimateBarFgImg->autoResize = true;
-
-        std::string fgPath = "DynRessource\\limit_break\\foreground.png";
-        if (FileExist(fgPath)) {
-            // Try loading with throwErrors=true to see any loading errors
-            try {
-                ultimateBarFgImg->loadFromFile(fgPath, true);
-                ultimateBarFgImg->alpha = 255;
-
-                // Calculate frame dimensions based on layout type
-                if (LimitBreakConfig::fgUseAnimation && LimitBreakConfig::fgFrameCount > 1) {
-                    if (LimitBreakConfig::useVerticalBar) {
-                        // For vertical bars, split frames horizontally
-                        LimitBreakConfig::fgFrameWidth = ultimateBarFgImg->width / LimitBreakConfig::fgFrameCount;
-
-                        if (LimitBreakConfig::enableDebugMessages) {
-                            std::string msg = "Foreground loaded with horizontal animation. Size: ";
-                            msg += std::to_string(ultimateBarFgImg->width) + "x" + std::to_string(ultimateBarFgImg->height);
-                            msg += ", Frames: " + std::to_string(LimitBreakConfig::fgFrameCount);
-                            msg += ", Frame Width: " + std::to_string(LimitBreakConfig::fgFrameWidth);
-                            Dialog::Show(msg, "Ultimate Bar Debug");
-                        }
-                    } else {
-                        // For horizontal bars, split frames vertically into multiple images
-                        LimitBreakConfig::fgFrameHeight = ultimateBarFgImg->height / LimitBreakConfig::fgFrameCount;
-
-                        if (LimitBreakConfig::enableDebugMessages) {
-                            std::string msg = "Foreground loaded with vertical animation. Size: ";
-                            msg += std::to_string(ultimateBarFgImg->width) + "x" + std::to_string(ultimateBarFgImg->height);
-                            msg += ", Frames: " + std::to_string(LimitBreakConfig::fgFrameCount);
-                            msg += ", Frame Height: " + std::to_string(LimitBreakConfig::fgFrameHeight);
-                            Dialog::Show(msg, "Ultimate Bar Debug");
-                        }
-                    }
-                } else if (LimitBreakConfig::enableDebugMessages) {
-                    std::string msg = "Foreground loaded. Size: ";
-                    msg += std::to_string(ultimateBarFgImg->width) + "x" + std::to_string(ultimateBarFgImg->height);
-                    Dialog::Show(msg, "Ultimate Bar Debug");
-                }
-            } catch (...) {
-                if (LimitBreakConfig::enableDebugMessages) {
-                    Dialog::Show("Error loading foreground image", "Ultimate Bar Debug");
-                }
+/**
+ * @brief Loads one layer image from its own file
+ *
+ * @param path Path of the image file
+ * @param layerName Name of the layer used in debug messages
+ * @param autoResize Whether the image resizes to the loaded file
+ * @return The layer image, empty if the file is missing or invalid
+ */
+RPG::Image* loadLayerFile(const std::string& path, const char* layerName, bool autoResize) {
+    RPG::Image* image = RPG::Image::create();
+    image->useMaskColor = true;
+    image->autoResize = autoResize;
+
+    if (FileExist(path)) {
+        // Try loading with throwErrors=true to see any loading errors
+        try {
+            image->loadFromFile(path, true);
+            image->alpha = 255;
+        } catch (...) {
+            if (LimitBreakConfig::enableDebugMessages) {
+                Dialog::Show(std::string("Error loading ") + layerName + " image", "Ultimate Bar Debug");
             }
-        } else if (LimitBreakConfig::enableDebugMessages) {
-            std::string msg = "Foreground image not found: " + fgPath;
-            Dialog::Show(msg, "Ultimate Bar Debug");
+        }
+    } else if (LimitBreakConfig::enableDebugMessages) {
+        std::string msg = std::string(layerName) + " image not found: " + path;
+        Dialog::Show(msg, "Ultimate Bar Debug");
+    }
+
+    return image;
+}
+
+/**
+ * @brief Cuts one layer image out of the atlas
+ *
+ * @param atlas The loaded atlas image
+ * @param rect Layer rectangle in the atlas as x,y,width,height
+ * @param layerName Name of the layer used in debug messages
+ * @return The layer image, empty if the rectangle is missing or outside the atlas
+ *
+ * @note The layer keeps the atlas palette, so all layers share it.
+ */
+RPG::Image* cutAtlasLayer(RPG::Image* atlas, const std::vector<int>& rect, const char* layerName) {
+    bool valid = rect.size() == 4 && rect[0] >= 0 && rect[1] >= 0 && rect[2] > 0 && rect[3] > 0 &&
+                 rect[0] + rect[2] <= atlas->width && rect[1] + rect[3] <= atlas->height;
+
+    RPG::Image* image;
+    if (valid) {
+        image = RPG::Image::create(rect[2], rect[3]);
+        memcpy(image->palette, atlas->palette, sizeof(image->palette));
+        for (int y = 0; y < rect[3]; y++) {
+            memcpy(image->pixels + y * image->width,
+                   atlas->pixels + (rect[1] + y) * atlas->width + rect[0], rect[2]);
+        }
+    } else {
+        image = RPG::Image::create();
+        if (LimitBreakConfig::enableDebugMessages && !rect.empty()) {
+            Dialog::Show(std::string(layerName) + " rectangle is outside the atlas", "Ultimate Bar Debug");
+        }
+    }
+
+    image->useMaskColor = true;
+    image->alpha = 255;
+    return image;
+}
+
+/**
+ * @brief Loads all three layers from the single atlas image
+ *
+ * @note The atlas is read once and destroyed after the layers are cut out.
+ *       Layers without a rectangle stay empty, just like a missing file.
+ */
+void loadUltimateBarAtlas() {
+    std::string atlasPath = "DynRessource\\limit_break\\atlas.png";
+    RPG::Image* atlas = loadLayerFile(atlasPath, "Atlas", true);
+
+    if (!ultimateBarBgImg) {
+        ultimateBarBgImg = cutAtlasLayer(atlas, LimitBreakConfig::atlasBackgroundRect, "Background");
+    }
+    if (!ultimateBarBarImg) {
+        ultimateBarBarImg = cutAtlasLayer(atlas, LimitBreakConfig::atlasBarRect, "Bar");
+    }
+    if (!ultimateBarFgImg) {
+        ultimateBarFgImg = cutAtlasLayer(atlas, LimitBreakConfig::atlasForegroundRect, "Foreground");
+    }
+
+    RPG::Image::destroy(atlas);
+}
+
+/**
+ * @brief Loads the images needed for the Ultimate Limit Bar
+ *
+ * @note This function:
+ *       1. Loads background.png, bar.png, and foreground.png from the DynRessource\limit_break folder,
+ *          or cuts all three out of atlas.png when UseImageAtlas is enabled
+ *       2. Configures image properties (alpha, mask color, etc.)
+ *       3. Calculates frame dimensions if animation is enabled
+ *       4. Handles both horizontal and vertical bar layouts
+ *       5. Logs debug messages if image loading fails
+ *       6. Builds the cached bar strip used for drawing the fill
+ *       7. Precomputes the animation timeline of every layer
+ *       8. Builds the retained composite of all layers
+ *
+ *       Only bar.png is strictly required; the others are optional.
+ *       The images are kept until the game exits.
+ */
+void loadUltimateBarImages() {
+    if (LimitBreakConfig::useImageAtlas) {
+        loadUltimateBarAtlas();
+    } else {
+        if (!ultimateBarBgImg) {
+            ultimateBarBgImg = loadLayerFile("DynRessource\\limit_break\\background.png", "Background", false);
+        }
+        if (!ultimateBarBarImg) {
+            ultimateBarBarImg = loadLayerFile("DynRessource\\limit_break\\bar.png", "Bar", true);
+        }
+        if (!ultimateBarFgImg) {
+            ultimateBarFgImg = loadLayerFile("DynRessource\\limit_break\\foreground.png", "Foreground", true);
         }
     }
 
+    if (ultimateBarBgImg->width > 0) {
+        calculateLayerFrames(ultimateBarBgImg, "Background", LimitBreakConfig::bgUseAnimation,
+                             LimitBreakConfig::bgFrameCount, LimitBreakConfig::bgFrameWidth,
+                             LimitBreakConfig::bgFrameHeight);
+    }
+    if (ultimateBarBarImg->width > 0) {
+        calculateLayerFrames(ultimateBarBarImg, "Bar", LimitBreakConfig::barUseAnimation,
+                             LimitBreakConfig::barFrameCount, LimitBreakConfig::barFrameWidth,
+                             LimitBreakConfig::barFrameHeight);
+    }
+    if (ultimateBarFgImg->width > 0) {
+        calculateLayerFrames(ultimateBarFgImg, "Foreground", LimitBreakConfig::fgUseAnimation,
+                             LimitBreakConfig::fgFrameCount, LimitBreakConfig::fgFrameWidth,
+                             LimitBreakConfig::fgFrameHeight);
+    }
+
     // If bar image failed to load, log a debug message but don't create a fallback
-    if (!ultimateBarBarImg || ultimateBarBarImg->width == 0 || ultimateBarBarImg->height == 0) {
+    if (ultimateBarBarImg->width == 0 || ultimateBarBarImg->height == 0) {
         if (LimitBreakConfig::enableDebugMessages) {
             Dialog::Show("Bar image not loaded or invalid", "Ultimate Bar Debug");
         }
+    } else if (!ultimateBarStripImg) {
+        buildUltimateBarStrip();
+    }
+
+    buildLayerTimeline(bgTimeline, bgPlayer, ultimateBarBgImg, LimitBreakConfig::bgUseAnimation,
+                       LimitBreakConfig::bgFrameCount, LimitBreakConfig::bgFrameWidth, LimitBreakConfig::bgFrameHeight,
+                       LimitBreakConfig::bgUnfilledFrames, LimitBreakConfig::bgFilledFrames,
+                       LimitBreakConfig::bgAnimationSpeed);
+    buildLayerTimeline(barTimeline, barPlayer, ultimateBarStripImg, LimitBreakConfig::barUseAnimation,
+                       LimitBreakConfig::barFrameCount, LimitBreakConfig::barFrameWidth, LimitBreakConfig::barFrameHeight,
+                       LimitBreakConfig::unfilledFrames, LimitBreakConfig::filledFrames,
+                       LimitBreakConfig::barAnimationSpeed);
+    buildLayerTimeline(fgTimeline, fgPlayer, ultimateBarFgImg, LimitBreakConfig::fgUseAnimation,
+                       LimitBreakConfig::fgFrameCount, LimitBreakConfig::fgFrameWidth, LimitBreakConfig::fgFrameHeight,
+                       LimitBreakConfig::fgUnfilledFrames, LimitBreakConfig::fgFilledFrames,
+                       LimitBreakConfig::fgAnimationSpeed);
+
+    if (ultimateBarStripImg && !ultimateBarCompositeImg) {
+        buildUltimateBarComposite();
+    }
+
+    imagesLoaded = true;
+}
+
+/**
+ * @brief Preloads the Ultimate Limit Bar images once per session
+ *
+ * @note Called when the game has finished initialising, so the first battle
+ *       does not pay for decoding the layers. Decoding stays on the game
+ *       thread because RPG::Image is not safe to use from other threads.
+ */
+void preloadUltimateBarImages() {
+    if (LimitBreakConfig::ultimateLimitVarId <= 0 || !LimitBreakConfig::drawUltimateBar) {
+        return;
+    }
+
+    if (!imagesLoaded) {
+        loadUltimateBarImages();
     }
 }
 
@@ -218,10 +610,23 @@ void freeUltimateBarImages() {
     if (ultimateBarBgImg) RPG::Image::destroy(ultimateBarBgImg);
     if (ultimateBarBarImg) RPG::Image::destroy(ultimateBarBarImg);
     if (ultimateBarFgImg) RPG::Image::destroy(ultimateBarFgImg);
+    if (ultimateBarStripImg) RPG::Image::destroy(ultimateBarStripImg);
+    if (ultimateBarCompositeImg) RPG::Image::destroy(ultimateBarCompositeImg);
 
     ultimateBarBgImg = nullptr;
     ultimateBarBarImg = nullptr;
     ultimateBarFgImg = nullptr;
+    ultimateBarStripImg = nullptr;
+    ultimateBarCompositeImg = nullptr;
+    compositeValid = false;
+    imagesLoaded = false;
+
+    bgTimeline.clear();
+    barTimeline.clear();
+    fgTimeline.clear();
+    bgPlayer.reset(nullptr);
+    barPlayer.reset(nullptr);
+    fgPlayer.reset(nullptr);
 }
 
 /**
@@ -236,9 +641,10 @@ void freeUltimateBarImages() {
  *          - Party must be at full capacity
  *       2. Loads images if not already loaded
  *       3. Calculates the fill percentage based on the ultimateLimitVarId variable
- *       4. Draws the background, bar, and foreground with proper animations
+ *       4. Advances every layer one step in its precomputed timeline
  *       5. Plays a sound effect when the bar first reaches 100%
- *       6. Updates animation frames for each component
+ *       6. Draws the background, bar, and foreground as one retained composite,
+ *          rebuilt only when the fill or an animation frame has changed
  *
  *       The bar can be drawn in either horizontal or vertical orientation,
  *       with different animation patterns based on the fill percentage.
@@ -330,10 +736,13 @@ void drawUltimateLimitBar() {
         return;
     }
 
-    loadUltimateBarImages();
+    // Normally already preloaded in onInitFinished
+    if (!imagesLoaded) {
+        loadUltimateBarImages();
+    }
 
-    // Check if bar image is loaded properly - this is the only required image
-    if (!ultimateBarBarImg || ultimateBarBarImg->width == 0 || ultimateBarBarImg->height == 0) {
+    // Check if the bar strip was built - the bar image is the only required image
+    if (!ultimateBarStripImg) {
         if (LimitBreakConfig::enableDebugMessages) {
             static bool firstTime = true;
             if (firstTime) {
@@ -344,91 +753,22 @@ void drawUltimateLimitBar() {
         return;
     }
 
-    // Set alpha for all loaded images to ensure visibility
-    ultimateBarBarImg->alpha = 255;
-    if (ultimateBarBgImg) ultimateBarBgImg->alpha = 255;
-    if (ultimateBarFgImg) ultimateBarFgImg->alpha = 255;
-
     // Get the fill percentage for the bar (0-100)
     int fill = 0;
     if (LimitBreakConfig::ultimateLimitVarId > 0) {
         int value = RPG::variables[LimitBreakConfig::ultimateLimitVarId];
         fill = std::max(0, std::min(100, value));
     }
+    bool filled = (fill == 100);
 
-    // Draw background if it exists
-    if (ultimateBarBgImg && ultimateBarBgImg->width > 0 && ultimateBarBgImg->height > 0) {
-        // Handle background animation
-        if (LimitBreakConfig::bgUseAnimation && LimitBreakConfig::bgFrameCount > 1) {
-            // Update animation counter
-            LimitBreakConfig::bgAnimationCounter++;
-            if (LimitBreakConfig::bgAnimationCounter >= LimitBreakConfig::bgAnimationSpeed) {
-                LimitBreakConfig::bgAnimationCounter = 0;
-
-                // Select which set of frames to use based on fill percentage
-                std::vector<int>& activeBgFrames = (fill == 100) ? LimitBreakConfig::bgFilledFrames : LimitBreakConfig::bgUnfilledFrames;
-
-                // If we have frames defined, cycle through them
-                if (!activeBgFrames.empty()) {
-                    // Find the index of the current frame in the frames list
-                    int currentIndex = 0;
-                    for (size_t i = 0; i < activeBgFrames.size(); i++) {
-                        if (activeBgFrames[i] == LimitBreakConfig::currentBgFrame) {
-                            currentIndex = i;
-                            break;
-                        }
-                    }
-
-                    // Move to the next frame in the sequence
-                    currentIndex = (currentIndex + 1) % activeBgFrames.size();
-                    LimitBreakConfig::currentBgFrame = activeBgFrames[currentIndex];
-                }
-                else {
-                    // No frames defined, just cycle through all frames
-                    LimitBreakConfig::currentBgFrame = (LimitBreakConfig::currentBgFrame + 1) % LimitBreakConfig::bgFrameCount;
-                }
-            }
-
-            if (LimitBreakConfig::useVerticalBar && LimitBreakConfig::bgFrameWidth > 0) {
-                // For vertical bars, use horizontal frame splitting
-                // Calculate the X position for the current frame
-                int frameX = LimitBreakConfig::currentBgFrame * LimitBreakConfig::bgFrameWidth;
-
-                // Draw the current background frame
-                RPG::screen->canvas->draw(
-                    LimitBreakConfig::ultimateBarBgX,
-                    LimitBreakConfig::ultimateBarBgY,
-                    ultimateBarBgImg,
-                    frameX,
-                    0,
-                    LimitBreakConfig::bgFrameWidth,
-                    ultimateBarBgImg->height
-                );
-            } else if (LimitBreakConfig::bgFrameHeight > 0) {
-                // For horizontal bars, use vertical frame splitting
-                // Calculate the Y position for the current frame
-                int frameY = LimitBreakConfig::currentBgFrame * LimitBreakConfig::bgFrameHeight;
-
-                // Draw the current background frame
-                RPG::screen->canvas->draw(
-                    LimitBreakConfig::ultimateBarBgX,
-                    LimitBreakConfig::ultimateBarBgY,
-                    ultimateBarBgImg,
-                    0,
-                    frameY,
-                    ultimateBarBgImg->width,
-                    LimitBreakConfig::bgFrameHeight
-                );
-            }
-        }
-        else {
-            // Non-animated version - just draw the background normally
-            RPG::screen->canvas->draw(LimitBreakConfig::ultimateBarBgX, LimitBreakConfig::ultimateBarBgY, ultimateBarBgImg);
-        }
-    }
+    // Advance the layer animations
+    LayerState state = filled ? LAYER_FILLED : LAYER_UNFILLED;
+    bgPlayer.advance(state);
+    barPlayer.advance(state);
+    fgPlayer.advance(state);
 
     // Check if we need to play the sound for reaching 100%
-    if (LimitBreakConfig::playSound100Percent && fill == 100 && !LimitBreakConfig::wasAt100Percent && !LimitBreakConfig::sound100PercentFile.empty()) {
+    if (LimitBreakConfig::playSound100Percent && filled && !LimitBreakConfig::wasAt100Percent && !LimitBreakConfig::sound100PercentFile.empty()) {
         // Create and play the sound
         RPG::Sound sound(LimitBreakConfig::sound100PercentFile, LimitBreakConfig::sound100PercentVolume,
                          LimitBreakConfig::sound100PercentSpeed, LimitBreakConfig::sound100PercentPan);
@@ -444,191 +784,39 @@ void drawUltimateLimitBar() {
     }
 
     // Update the tracking flag for sound playback
-    LimitBreakConfig::wasAt100Percent = (fill == 100);
-
-    // Calculate the bar dimensions based on fill percentage and orientation
-    int barDrawWidth = LimitBreakConfig::useVerticalBar ? 1 : (LimitBreakConfig::ultimateBarWidth * fill) / 100;
-    int barDrawHeight = LimitBreakConfig::useVerticalBar ? (LimitBreakConfig::ultimateBarHeight * fill) / 100 : ultimateBarBarImg->height;
-
-    // Handle animation frame selection
-    if (LimitBreakConfig::barUseAnimation && LimitBreakConfig::barFrameCount > 1) {
-        // Update animation counter
-        LimitBreakConfig::barAnimationCounter++;
-        if (LimitBreakConfig::barAnimationCounter >= LimitBreakConfig::barAnimationSpeed) {
-            LimitBreakConfig::barAnimationCounter = 0;
-
-            // Select which set of frames to use based on fill percentage
-            std::vector<int>& activeFrames = (fill == 100) ? LimitBreakConfig::filledFrames : LimitBreakConfig::unfilledFrames;
-
-            // If we have frames defined, cycle through them
-            if (!activeFrames.empty()) {
-                // Find the index of the current frame in the active frames list
-                int currentIndex = 0;
-                for (size_t i = 0; i < activeFrames.size(); i++) {
-                    if (activeFrames[i] == LimitBreakConfig::currentBarFrame) {
-                        currentIndex = i;
-                        break;
-                    }
-                }
-
-                // Move to the next frame in the sequence
-                currentIndex = (currentIndex + 1) % activeFrames.size();
-                LimitBreakConfig::currentBarFrame = activeFrames[currentIndex];
-            }
-            else {
-                // No frames defined, just cycle through all frames
-                LimitBreakConfig::currentBarFrame = (LimitBreakConfig::currentBarFrame + 1) % LimitBreakConfig::barFrameCount;
-            }
+    LimitBreakConfig::wasAt100Percent = filled;
+
+    // Get the drawn part of every layer
+    LayerRect bgRect = getFrameLayerRect(ultimateBarBgImg, bgPlayer,
+                                         LimitBreakConfig::ultimateBarBgX, LimitBreakConfig::ultimateBarBgY);
+    LayerRect barRect = getBarLayerRect(fill);
+    LayerRect fgRect = getFrameLayerRect(ultimateBarFgImg, fgPlayer,
+                                         LimitBreakConfig::ultimateBarBgX, LimitBreakConfig::ultimateBarBgY);
+    int bgFrame = bgPlayer.frame().index;
+    int barFrame = barPlayer.frame().index;
+    int fgFrame = fgPlayer.frame().index;
+
+    if (ultimateBarCompositeImg) {
+        // Rebuild the composite only when the fill or an animation frame changed
+        if (!compositeValid || fill != composedFill || bgFrame != composedBgFrame ||
+            barFrame != composedBarFrame || fgFrame != composedFgFrame) {
+            memset(ultimateBarCompositeImg->pixels, 0, ultimateBarCompositeImg->width * ultimateBarCompositeImg->height);
+            composeLayer(bgRect, bgColorMap);
+            composeLayer(barRect, barColorMap);
+            composeLayer(fgRect, fgColorMap);
+
+            composedFill = fill;
+            composedBgFrame = bgFrame;
+            composedBarFrame = barFrame;
+            composedFgFrame = fgFrame;
+            compositeValid = true;
         }
 
-        if (LimitBreakConfig::useVerticalBar && LimitBreakConfig::barFrameWidth > 0) {
-            // For vertical bars with horizontal frame splitting
-            // Calculate the X position for the current frame
-            int frameX = LimitBreakConfig::currentBarFrame * LimitBreakConfig::barFrameWidth;
-
-            // Draw the bar with the current animation frame (vertical)
-            if (barDrawHeight > 0) {
-                // Stretch the bar image vertically using the current frame from horizontal strips
-                for (int y = 0; y < barDrawHeight; ++y) {
-                    RPG::screen->canvas->draw(
-                        LimitBreakConfig::ultimateBarBarX,
-                        LimitBreakConfig::ultimateBarBarY + (LimitBreakConfig::ultimateBarHeight - barDrawHeight) + y,
-                        ultimateBarBarImg,
-                        frameX,
-                        0,
-                        LimitBreakConfig::barFrameWidth,
-                        1
-                    );
-                }
-            }
-        } else if (LimitBreakConfig::barFrameHeight > 0) {
-            // For horizontal bars with vertical frame splitting
-            // Calculate the Y position for the current frame
-            int frameY = LimitBreakConfig::currentBarFrame * LimitBreakConfig::barFrameHeight;
-
-            // Draw the bar with the current animation frame (horizontal)
-            if (barDrawWidth > 0) {
-                // Stretch the bar image horizontally using the current frame
-                for (int x = 0; x < barDrawWidth; ++x) {
-                    RPG::screen->canvas->draw(
-                        LimitBreakConfig::ultimateBarBarX + x,
-                        LimitBreakConfig::ultimateBarBarY,
-                        ultimateBarBarImg,
-                        0,
-                        frameY,
-                        1,
-                        LimitBreakConfig::barFrameHeight
-                    );
-                }
-            }
-        }
-    }
-    else {
-        // Non-animated version
-        if (LimitBreakConfig::useVerticalBar) {
-            // Draw vertical bar
-            if (barDrawHeight > 0) {
-                // Stretch the bar image vertically
-                for (int y = 0; y < barDrawHeight; ++y) {
-                    RPG::screen->canvas->draw(
-                        LimitBreakConfig::ultimateBarBarX,
-                        LimitBreakConfig::ultimateBarBarY + (LimitBreakConfig::ultimateBarHeight - barDrawHeight) + y,
-                        ultimateBarBarImg,
-                        0,
-                        0,
-                        ultimateBarBarImg->width,
-                        1
-                    );
-                }
-            }
-        } else {
-            // Draw horizontal bar
-            if (barDrawWidth > 0) {
-                // Stretch the bar image horizontally
-                for (int x = 0; x < barDrawWidth; ++x) {
-                    RPG::screen->canvas->draw(
-                        LimitBreakConfig::ultimateBarBarX + x,
-                        LimitBreakConfig::ultimateBarBarY,
-                        ultimateBarBarImg,
-                        0,
-                        0,
-                        1,
-                        ultimateBarBarImg->height
-                    );
-                }
-            }
-        }
-    }
-
-    // Draw foreground if it exists
-    if (ultimateBarFgImg && ultimateBarFgImg->width > 0 && ultimateBarFgImg->height > 0) {
-        // Handle foreground animation
-        if (LimitBreakConfig::fgUseAnimation && LimitBreakConfig::fgFrameCount > 1) {
-            // Update animation counter
-            LimitBreakConfig::fgAnimationCounter++;
-            if (LimitBreakConfig::fgAnimationCounter >= LimitBreakConfig::fgAnimationSpeed) {
-                LimitBreakConfig::fgAnimationCounter = 0;
-
-                // Select which set of frames to use based on fill percentage
-                std::vector<int>& activeFgFrames = (fill == 100) ? LimitBreakConfig::fgFilledFrames : LimitBreakConfig::fgUnfilledFrames;
-
-                // If we have frames defined, cycle through them
-                if (!activeFgFrames.empty()) {
-                    // Find the index of the current frame in the frames list
-                    int currentIndex = 0;
-                    for (size_t i = 0; i < activeFgFrames.size(); i++) {
-                        if (activeFgFrames[i] == LimitBreakConfig::currentFgFrame) {
-                            currentIndex = i;
-                            break;
-                        }
-                    }
-
-                    // Move to the next frame in the sequence
-                    currentIndex = (currentIndex + 1) % activeFgFrames.size();
-                    LimitBreakConfig::currentFgFrame = activeFgFrames[currentIndex];
-                }
-                else {
-                    // No frames defined, just cycle through all frames
-                    LimitBreakConfig::currentFgFrame = (LimitBreakConfig::currentFgFrame + 1) % LimitBreakConfig::fgFrameCount;
-                }
-            }
-
-            if (LimitBreakConfig::useVerticalBar && LimitBreakConfig::fgFrameWidth > 0) {
-                // For vertical bars, use horizontal frame splitting
-                // Calculate the X position for the current frame
-                int frameX = LimitBreakConfig::currentFgFrame * LimitBreakConfig::fgFrameWidth;
-
-                // Draw the current foreground frame
-                RPG::screen->canvas->draw(
-                    LimitBreakConfig::ultimateBarBgX,
-                    LimitBreakConfig::ultimateBarBgY,
-                    ultimateBarFgImg,
-                    frameX,
-                    0,
-                    LimitBreakConfig::fgFrameWidth,
-                    ultimateBarFgImg->height
-                );
-            } else if (LimitBreakConfig::fgFrameHeight > 0) {
-                // For horizontal bars, use vertical frame splitting
-                // Calculate the Y position for the current frame
-                int frameY = LimitBreakConfig::currentFgFrame * LimitBreakConfig::fgFrameHeight;
-
-                // Draw the current foreground frame
-                RPG::screen->canvas->draw(
-                    LimitBreakConfig::ultimateBarBgX,
-                    LimitBreakConfig::ultimateBarBgY,
-                    ultimateBarFgImg,
-                    0,
-                    frameY,
-                    ultimateBarFgImg->width,
-                    LimitBreakConfig::fgFrameHeight
-                );
-            }
-        }
-        else {
-            // Non-animated version - just draw the foreground normally
-            RPG::screen->canvas->draw(LimitBreakConfig::ultimateBarBgX, LimitBreakConfig::ultimateBarBgY, ultimateBarFgImg);
-        }
+        RPG::screen->canvas->draw(compositeX, compositeY, ultimateBarCompositeImg);
+    } else {
+        drawLayer(bgRect);
+        drawLayer(barRect);
+        drawLayer(fgRect);
     }
 
     if (LimitBreakConfig::enableDebugMessages) {
@@ -636,27 +824,28 @@ void drawUltimateLimitBar() {
         if (firstTime) {
             std::string msg = "Drawing bar: fill=" + std::to_string(fill) + "%";
             if (LimitBreakConfig::useVerticalBar) {
-                msg += ", height=" + std::to_string(barDrawHeight) + " (vertical)";
+                msg += ", height=" + std::to_string(barRect.height) + " (vertical)";
                 if (LimitBreakConfig::barUseAnimation) {
                     msg += ", using horizontal frame splitting";
                 }
             } else {
-                msg += ", width=" + std::to_string(barDrawWidth) + " (horizontal)";
+                msg += ", width=" + std::to_string(barRect.width) + " (horizontal)";
                 if (LimitBreakConfig::barUseAnimation) {
                     msg += ", using vertical frame splitting";
                 }
             }
 
             if (LimitBreakConfig::barUseAnimation) {
-                msg += ", bar frame=" + std::to_string(LimitBreakConfig::currentBarFrame);
+                msg += ", bar frame=" + std::to_string(barFrame);
             }
             if (LimitBreakConfig::bgUseAnimation && ultimateBarBgImg) {
-                msg += ", bg frame=" + std::to_string(LimitBreakConfig::currentBgFrame);
+                msg += ", bg frame=" + std::to_string(bgFrame);
             }
             if (LimitBreakConfig::fgUseAnimation && ultimateBarFgImg) {
-                msg += ", fg frame=" + std::to_string(LimitBreakConfig::currentFgFrame);
+                msg += ", fg frame=" + std::to_string(fgFrame);
             }
             msg += ", at (" + std::to_string(LimitBreakConfig::ultimateBarBgX) + "," + std::to_string(LimitBreakConfig::ultimateBarBgY) + ")";
+            msg += ultimateBarCompositeImg ? ", composite" : ", separate layers";
             Dialog::Show(msg, "Ultimate Bar Debug");
             firstTime = false;
         }
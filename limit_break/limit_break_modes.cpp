@@ -0,0 +1,117 @@
+/*
+ * Limit gain modes for the Limit Break plugin.
+ * Contains the gain formulas of each mode as a table the damage checks dispatch through.
+ */
+
+namespace LimitBreakModes
+{
+// ========================================================================
+// Gain kernels
+// ========================================================================
+
+/**
+ * @brief Gain formula: (amount * Factor) / maxHp * multiplier, capped at Cap
+ *
+ * @tparam Factor Percentage of limit gained when the amount equals maxHp
+ * @tparam Cap Maximum gain per call (0 = no cap)
+ *
+ * @note The constants are template arguments, so every mode gets its own
+ *       kernel with them compiled in.
+ */
+template<int Factor, int Cap>
+struct ScaledGain {
+    static int gain(int amount, int maxHp, float multiplier) {
+        int value = static_cast<int>((amount * static_cast<float>(Factor)) / maxHp * multiplier);
+        return (Cap > 0) ? std::min(Cap, value) : value;
+    }
+};
+
+/**
+ * @brief One gain formula of a mode
+ */
+struct GainRule {
+    int (*gain)(int amount, int maxHp, float multiplier);  // Gain kernel, nullptr if the mode gains nothing here
+    int factor;                                            // Factor of the formula, for debug messages
+    int cap;                                               // Cap of the formula (0 = none), for debug messages
+};
+
+/**
+ * @brief Builds the rule for a ScaledGain kernel
+ */
+template<int Factor, int Cap>
+constexpr GainRule scaled() {
+    return GainRule{ &ScaledGain<Factor, Cap>::gain, Factor, Cap };
+}
+
+/**
+ * @brief Rule for events a mode does not gain limit from
+ */
+constexpr GainRule none() {
+    return GainRule{ nullptr, 0, 0 };
+}
+
+// ========================================================================
+// Mode table
+// ========================================================================
+
+/**
+ * @brief Gain rules of one limit mode
+ *
+ * @note A mode may have any combination of rules. Damage taken gains are
+ *       added up when a mode has both damageTaken and allyDamageTaken.
+ */
+struct LimitMode {
+    const char* name;           // Mode name for debug messages
+    GainRule damageDealt;       // Per damaged monster, relative to the monster's max HP
+    GainRule healingDone;       // Total healing, relative to the healed party members' total max HP
+    GainRule damageTaken;       // Own damage, relative to the actor's max HP
+    GainRule allyDamageTaken;   // Damage to the other party members, relative to the actor's max HP
+};
+
+/**
+ * @brief All limit modes, indexed by the value of the actor's mode variable
+ *
+ * @note To add a custom mode, append a row here. The damage checks in
+ *       LimitBreakCalculate only read this table, and mode variable values
+ *       up to MODE_COUNT - 1 become valid automatically.
+ */
+static const LimitMode limitModes[] = {
+    //  name       damageDealt         healingDone         damageTaken         allyDamageTaken
+    { "Stoic",   none(),             none(),             scaled<30, 0>(),    none()          },
+    { "Warrior", scaled<30, 16>(),   none(),             none(),             none()          },
+    { "Comrade", none(),             none(),             none(),             scaled<20, 0>() },
+    { "Healer",  none(),             scaled<16, 0>(),    none(),             none()          },
+    { "Knight",  scaled<30, 16>(),   none(),             scaled<30, 0>(),    none()          },
+};
+
+// Number of modes in limitModes
+static const int MODE_COUNT = sizeof(limitModes) / sizeof(limitModes[0]);
+
+/**
+ * @brief Gets a limit mode by its index
+ *
+ * @param mode The mode index, as returned by LimitBreakConfig::getActorMode
+ * @return const LimitMode* The mode, or nullptr if the index is not a mode
+ */
+inline const LimitMode* getMode(int mode) {
+    return (mode >= 0 && mode < MODE_COUNT) ? &limitModes[mode] : nullptr;
+}
+
+/**
+ * @brief Formats a gain rule for debug messages
+ *
+ * @param rule The rule
+ * @param amount The amount the gain was calculated from
+ * @param maxHp The max HP the amount was related to
+ * @param multiplier The equipment multiplier used
+ * @return std::string The formula with the values filled in
+ */
+std::string describe(const GainRule& rule, int amount, int maxHp, float multiplier) {
+    std::string formula = "(" + std::to_string(amount) + " * " + std::to_string(rule.factor) + ") / " +
+                          std::to_string(maxHp) + " * " + std::to_string(multiplier);
+    if (rule.cap > 0) {
+        formula = "min(" + std::to_string(rule.cap) + ", " + formula + ")";
+    }
+    return formula;
+}
+} // namespace LimitBreakModes
@@ -12,16 +12,20 @@
 // Standard library headers
 #include <algorithm>  // For std::min, std::max
 #include <map>        // For storing configurations and state data
-#include <tuple>      // For storing actor configurations
 #include <string>     // For text processing
 #include <sstream>    // For string formatting
-#include <vector>     // For storing animation frames
+#include <vector>     // For storing animation frames and actor profiles
 #include <windows.h>  // For MessageBox
 #include <fstream>    // For file operations
+#include <string.h>   // For memcpy, memset, memcmp
 
 // Main implementation file - contains all namespaced code
 #include "limit_break.cpp"
 
+// Opt-in callback profiler and trace recorder
+#include "../common/profiler.cpp"
+#include "../common/trace_recorder.cpp"
+
 // ========================================================================
 // DynRPG plugin entry points - global callback functions
 // These are called by the DynRPG system and forward to our implementation
@@ -37,9 +41,23 @@
  *       Loads all configuration from DynRPG.ini
  */
 bool onStartup(char *pluginName) {
+    Profiler::start(pluginName);
+    TraceRecorder::start(pluginName);
     return LimitBreak::onStartup(pluginName);
 }
 
+/**
+ * @brief DynRPG callback: Game initialization finished
+ * 
+ * @note Called once before the title screen is shown
+ *       Preloads the Ultimate Limit Bar images for the session
+ */
+void onInitFinished() {
+    TraceRecorder::Call trace(TraceRecorder::TR_INIT_FINISHED);
+    Profiler::Scope scope(Profiler::PC_ON_INIT_FINISHED);
+    LimitBreak::onInitFinished();
+}
+
 /**
  * @brief DynRPG callback: Battle status window drawing
  * 
@@ -53,7 +71,9 @@ bool onStartup(char *pluginName) {
  * @note Used to detect when the Limit command is selected
  */
 bool onDrawBattleStatusWindow(int x, int selection, bool selActive, bool isTargetSelection, bool isVisible) {
-    return LimitBreak::onDrawBattleStatusWindow(x, selection, selActive, isTargetSelection, isVisible);
+    TraceRecorder::Call trace(TraceRecorder::TR_DRAW_BATTLE_STATUS_WINDOW, x, selection, selActive, isTargetSelection, isVisible);
+    Profiler::Scope scope(Profiler::PC_ON_DRAW_BATTLE_STATUS_WINDOW);
+    return trace.result(LimitBreak::onDrawBattleStatusWindow(x, selection, selActive, isTargetSelection, isVisible));
 }
 
 /**
@@ -69,7 +89,10 @@ bool onDrawBattleStatusWindow(int x, int selection, bool selActive, bool isTarge
  * @note Used to draw the ultimate limit bar
  */
 bool onDrawBattleActionWindow(int* x, int* y, int selection, bool selActive, bool isVisible) {
-    return LimitBreak::onDrawBattleActionWindow(x, y, selection, selActive, isVisible);
+    TraceRecorder::Call trace(TraceRecorder::TR_DRAW_BATTLE_ACTION_WINDOW, *x, *y, selection, selActive, isVisible);
+    trace.outputs(x, y);
+    Profiler::Scope scope(Profiler::PC_ON_DRAW_BATTLE_ACTION_WINDOW);
+    return trace.result(LimitBreak::onDrawBattleActionWindow(x, y, selection, selActive, isVisible));
 }
 
 /**
@@ -83,7 +106,9 @@ bool onDrawBattleActionWindow(int* x, int* y, int selection, bool selActive, boo
  *       Also sets up damage monitoring for limit gain calculation
  */
 bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
-    return LimitBreak::onDoBattlerAction(battler, firstTry);
+    TraceRecorder::Call trace(TraceRecorder::TR_DO_BATTLER_ACTION, battler, firstTry);
+    Profiler::Scope scope(Profiler::PC_ON_DO_BATTLER_ACTION);
+    return trace.result(LimitBreak::onDoBattlerAction(battler, firstTry));
 }
 
 /**
@@ -96,7 +121,9 @@ bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
  * @note Used to start damage monitoring for multi-hit attacks and skills
  */
 bool onBattlerActionDone(RPG::Battler* battler, bool success) {
-    return LimitBreak::onBattlerActionDone(battler, success);
+    TraceRecorder::Call trace(TraceRecorder::TR_BATTLER_ACTION_DONE, battler, success);
+    Profiler::Scope scope(Profiler::PC_ON_BATTLER_ACTION_DONE);
+    return trace.result(LimitBreak::onBattlerActionDone(battler, success));
 }
 
 /**
@@ -108,9 +135,27 @@ bool onBattlerActionDone(RPG::Battler* battler, bool success) {
  *       Also monitors battle start/end to properly initialize and cleanup
  */
 void onFrame(RPG::Scene scene) {
+    TraceRecorder::Call trace(TraceRecorder::TR_FRAME, scene);
+    Profiler::Scope scope(Profiler::PC_ON_FRAME);
     LimitBreak::onFrame(scene);
 }
 
+/**
+ * @brief DynRPG callback: Variable set by an event
+ * 
+ * @param id The ID of the variable being set
+ * @param value The new value of the variable
+ * @return bool Always returns true to continue normal processing
+ * 
+ * @note Used to keep the ultimate limit bar in sync with limit values
+ *       changed by events during battle
+ */
+bool onSetVariable(int id, int value) {
+    TraceRecorder::Call trace(TraceRecorder::TR_SET_VARIABLE, id, value);
+    Profiler::Scope scope(Profiler::PC_ON_SET_VARIABLE);
+    return trace.result(LimitBreak::onSetVariable(id, value));
+}
+
 /**
  * @brief DynRPG callback: Game exit
  * 
@@ -118,4 +163,16 @@ void onFrame(RPG::Scene scene) {
  */
 void onExit() {
     LimitBreak::onExit();
+    Profiler::stop();
+    TraceRecorder::stop();
+}
+
+/**
+ * @brief DynRPG callback: Screen drawn
+ * 
+ * @note Used to draw the profiler overlay while it is enabled
+ *       and its switch is ON
+ */
+void onDrawScreen() {
+    Profiler::drawOverlay();
 }
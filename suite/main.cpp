@@ -0,0 +1,201 @@
+/**
+ * @file main.cpp
+ * @brief Entry point for the plugin suite for RPG Maker 2003.
+ * @details This file contains DynRPG callback functions that serve as entry
+ *          points from the game engine into the suite. The Suite namespace
+ *          forwards each callback to the modules that subscribed to it.
+ */
+
+// Core DynRPG header
+#include <DynRPG/DynRPG.h>
+
+// Standard library headers
+#include <algorithm>  // For std::min, std::max
+#include <fstream>    // For file operations
+#include <limits>     // For numeric limits
+#include <map>        // For storing configurations and state data
+#include <sstream>    // For string formatting
+#include <string>     // For text processing
+#include <vector>     // For subscription tables and module state
+#include <iostream>   // For console output
+#include <ctype.h>    // For tolower
+#include <errno.h>    // For strtol range errors
+#include <limits.h>   // For INT_MAX, INT_MIN
+#include <stdio.h>    // For freopen
+#include <stdlib.h>   // For atoi, strtol
+#include <string.h>   // For memcpy, memset, strncpy
+#include <stdint.h>   // For standard integer types
+#include <windows.h>  // For Windows API
+
+// Main implementation file - contains all modules and the dispatcher
+#include "suite.cpp"
+
+// Opt-in callback profiler and trace recorder
+#include "../common/profiler.cpp"
+#include "../common/trace_recorder.cpp"
+
+/**
+ * @defgroup callbacks DynRPG Plugin Callbacks
+ * @brief Global callback functions called by the DynRPG system
+ * @{
+ */
+
+/**
+ * @brief Starts the configured suite modules.
+ * @param pluginName Name of the plugin section in DynRPG.ini.
+ * @return True if all configured modules started, false otherwise.
+ * @see Suite::onStartup
+ */
+bool onStartup(char *pluginName) {
+    Profiler::start(pluginName);
+    TraceRecorder::start(pluginName);
+    return Suite::onStartup(pluginName);
+}
+
+/**
+ * @brief Called after the game has been initialized.
+ * @see Suite::onInitFinished
+ */
+void onInitFinished() {
+    TraceRecorder::Call trace(TraceRecorder::TR_INIT_FINISHED);
+    Profiler::Scope scope(Profiler::PC_ON_INIT_FINISHED);
+    Suite::onInitFinished();
+}
+
+/**
+ * @brief Called when a new game is started.
+ * @see Suite::onNewGame
+ */
+void onNewGame() {
+    TraceRecorder::Call trace(TraceRecorder::TR_NEW_GAME);
+    Profiler::Scope scope(Profiler::PC_ON_NEW_GAME);
+    Suite::onNewGame();
+}
+
+/**
+ * @brief Called when a game is loaded.
+ * @param id Save slot ID.
+ * @param data Plugin save data.
+ * @param length Length of the save data.
+ * @see Suite::onLoadGame
+ */
+void onLoadGame(int id, char* data, int length) {
+    TraceRecorder::Call trace(TraceRecorder::TR_LOAD_GAME, id, length);
+    Profiler::Scope scope(Profiler::PC_ON_LOAD_GAME);
+    Suite::onLoadGame(id, data, length);
+}
+
+/**
+ * @brief Performs cleanup when the plugin is unloaded.
+ * @see Suite::onExit
+ */
+void onExit() {
+    Suite::onExit();
+    Profiler::stop();
+    TraceRecorder::stop();
+}
+
+/**
+ * @brief Processes frame updates during gameplay.
+ * @param scene Current game scene.
+ * @see Suite::onFrame
+ */
+void onFrame(RPG::Scene scene) {
+    TraceRecorder::Call trace(TraceRecorder::TR_FRAME, scene);
+    Profiler::Scope scope(Profiler::PC_ON_FRAME);
+    Suite::onFrame(scene);
+}
+
+/**
+ * @brief Processes variable changes during gameplay.
+ * @param id Variable ID being changed.
+ * @param value New value of the variable.
+ * @return True to allow the change, false to prevent it.
+ * @see Suite::onSetVariable
+ */
+bool onSetVariable(int id, int value) {
+    TraceRecorder::Call trace(TraceRecorder::TR_SET_VARIABLE, id, value);
+    Profiler::Scope scope(Profiler::PC_ON_SET_VARIABLE);
+    return trace.result(Suite::onSetVariable(id, value));
+}
+
+/**
+ * @brief Processes comment commands during event execution.
+ * @param text Raw comment text.
+ * @param parsedData Parsed comment data.
+ * @param nextScriptLine Next script line.
+ * @param scriptData Script data.
+ * @param eventId Event ID.
+ * @param pageId Page ID.
+ * @param lineId Line ID.
+ * @param nextLineId Next line ID.
+ * @return False if command was handled, true to let other plugins handle it.
+ * @see Suite::onComment
+ */
+bool onComment(const char *text, const RPG::ParsedCommentData *parsedData,
+              RPG::EventScriptLine *nextScriptLine, RPG::EventScriptData *scriptData,
+              int eventId, int pageId, int lineId, int *nextLineId) {
+    TraceRecorder::Call trace(parsedData);
+    Profiler::Scope scope(Profiler::PC_ON_COMMENT);
+    return trace.result(Suite::onComment(text, parsedData, nextScriptLine, scriptData, eventId, pageId, lineId, nextLineId));
+}
+
+/**
+ * @brief Called before a battler performs an action.
+ * @param battler The acting battler.
+ * @param firstTry True on the first call for this action.
+ * @return False to be called again next frame.
+ * @see Suite::onDoBattlerAction
+ */
+bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
+    TraceRecorder::Call trace(TraceRecorder::TR_DO_BATTLER_ACTION, battler, firstTry);
+    Profiler::Scope scope(Profiler::PC_ON_DO_BATTLER_ACTION);
+    return trace.result(Suite::onDoBattlerAction(battler, firstTry));
+}
+
+/**
+ * @brief Called after a battler performed an action.
+ * @param battler The acting battler.
+ * @param success Whether the action succeeded.
+ * @return False to be called again next frame.
+ * @see Suite::onBattlerActionDone
+ */
+bool onBattlerActionDone(RPG::Battler* battler, bool success) {
+    TraceRecorder::Call trace(TraceRecorder::TR_BATTLER_ACTION_DONE, battler, success);
+    Profiler::Scope scope(Profiler::PC_ON_BATTLER_ACTION_DONE);
+    return trace.result(Suite::onBattlerActionDone(battler, success));
+}
+
+/**
+ * @brief Called when the battle status window is drawn.
+ * @return False to skip the default drawing.
+ * @see Suite::onDrawBattleStatusWindow
+ */
+bool onDrawBattleStatusWindow(int x, int selection, bool selActive, bool isTargetSelection, bool isVisible) {
+    TraceRecorder::Call trace(TraceRecorder::TR_DRAW_BATTLE_STATUS_WINDOW, x, selection, selActive, isTargetSelection, isVisible);
+    Profiler::Scope scope(Profiler::PC_ON_DRAW_BATTLE_STATUS_WINDOW);
+    return trace.result(Suite::onDrawBattleStatusWindow(x, selection, selActive, isTargetSelection, isVisible));
+}
+
+/**
+ * @brief Called when the battle action window is drawn.
+ * @return False to skip the default drawing.
+ * @see Suite::onDrawBattleActionWindow
+ */
+bool onDrawBattleActionWindow(int* x, int* y, int selection, bool selActive, bool isVisible) {
+    TraceRecorder::Call trace(TraceRecorder::TR_DRAW_BATTLE_ACTION_WINDOW, *x, *y, selection, selActive, isVisible);
+    trace.outputs(x, y);
+    Profiler::Scope scope(Profiler::PC_ON_DRAW_BATTLE_ACTION_WINDOW);
+    return trace.result(Suite::onDrawBattleActionWindow(x, y, selection, selActive, isVisible));
+}
+
+/**
+ * @brief Called after the screen was drawn.
+ * @note Draws the profiler overlay while it is enabled and its switch is ON.
+ * @see Profiler::drawOverlay
+ */
+void onDrawScreen() {
+    Profiler::drawOverlay();
+}
+
+/** @} */ // end of callbacks group
@@ -0,0 +1,453 @@
+/**
+ * @file suite.cpp
+ * @brief Combined callback dispatcher for the plugin suite build.
+ * @details Compiles bare_handed, direct_skills, dynamic_quickpatch and limit_break
+ *          into one DLL. Each plugin is wrapped in its own namespace so their
+ *          Debug namespaces and helpers do not collide, and the Suite namespace
+ *          forwards every DynRPG callback only to the modules that need it:
+ *          - onFrame goes to modules subscribed to the current scene, plus
+ *            every module on the first frame of a new scene
+ *          - onSetVariable goes to modules that use the variable ID
+ *          - onComment goes to modules that own the command, looked up in a
+ *            case-insensitive hash table without building strings
+ */
+
+// Shared code is included once at global scope; the include guards keep
+// the plugin files from pulling it into their wrapper namespaces.
+#include "../common/async_log.cpp"
+#include "../common/ini_cache.cpp"
+#include "../common/party_snapshot.cpp"
+#include "../common/sprite_timeline.cpp"
+
+/** @brief The BareHanded plugin, compiled as a suite module. */
+namespace BareHandedModule
+{
+#include "../bare_handed/bare_handed.cpp"
+}
+
+/** @brief The DirectSkills plugin, compiled as a suite module. */
+namespace DirectSkillsModule
+{
+#include "../direct_skills/direct_skills.cpp"
+}
+
+/** @brief The DynamicQuickPatch plugin, compiled as a suite module. */
+namespace DynamicQuickPatchModule
+{
+#include "../dynamic_quickpatch/dynamic_quickpatch.cpp"
+}
+
+/** @brief The LimitBreak plugin, compiled as a suite module. */
+namespace LimitBreakModule
+{
+#include "../limit_break/limit_break.cpp"
+}
+
+/**
+ * @namespace Suite
+ * @brief Dispatches DynRPG callbacks to the suite modules.
+ */
+namespace Suite
+{
+    /** @brief Module flags used in subscription masks. */
+    enum Module {
+        MODULE_BARE_HANDED = 1,
+        MODULE_DIRECT_SKILLS = 2,
+        MODULE_DYNAMIC_QUICKPATCH = 4,
+        MODULE_LIMIT_BREAK = 8
+    };
+
+    /** @brief Number of scene IDs covered by the scene subscription table. */
+    const int SUITE_SCENE_COUNT = 16;
+
+    /** @brief Size of the comment command hash table (must be a power of two). */
+    const int SUITE_COMMAND_SLOTS = 16;
+
+    /** @brief Modules whose DynRPG.ini section exists and that started successfully. */
+    static int enabledModules = 0;
+
+    /** @brief Modules that need every frame, indexed by scene. */
+    static unsigned char sceneSubscribers[SUITE_SCENE_COUNT];
+
+    /** @brief Scene of the previous frame, -1 before the first frame. */
+    static int lastScene = -1;
+
+    /** @brief Modules that use a variable, indexed by variable ID. */
+    static std::vector<unsigned char> variableSubscribers;
+
+    /** @brief One entry of the comment command hash table. */
+    struct CommentCommand {
+        uint32_t hash;          ///< Hash of the lowercase command name
+        const char* name;       ///< Lowercase command name, nullptr for empty slots
+        unsigned char modules;  ///< Modules handling the command
+    };
+
+    /** @brief Comment commands handled by the modules. */
+    static CommentCommand commandTable[SUITE_COMMAND_SLOTS];
+
+    /**
+     * @brief Hashes a command name case-insensitively (FNV-1a).
+     * @param text The command name.
+     * @return The hash.
+     */
+    uint32_t hashCommand(const char* text) {
+        uint32_t hash = 2166136261u;
+        for (; *text; ++text) {
+            hash ^= static_cast<unsigned char>(tolower(*text));
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Compares a command with a lowercase name, ignoring the command's case.
+     * @param command The command from the comment.
+     * @param name The lowercase command name.
+     * @return True if both are equal.
+     */
+    bool commandEquals(const char* command, const char* name) {
+        for (; *command && *name; ++command, ++name) {
+            if (tolower(*command) != *name) {
+                return false;
+            }
+        }
+        return *command == *name;
+    }
+
+    /**
+     * @brief Adds a comment command to the hash table.
+     * @param name The lowercase command name.
+     * @param module The module handling it.
+     */
+    void addCommand(const char* name, unsigned char module) {
+        uint32_t hash = hashCommand(name);
+        for (int probe = 0; probe < SUITE_COMMAND_SLOTS; ++probe) {
+            CommentCommand& slot = commandTable[(hash + probe) & (SUITE_COMMAND_SLOTS - 1)];
+            if (!slot.name) {
+                slot.hash = hash;
+                slot.name = name;
+                slot.modules = module;
+                return;
+            }
+            if (slot.hash == hash && commandEquals(slot.name, name)) {
+                slot.modules |= module;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Finds the modules handling a comment command.
+     * @param command The command from the comment.
+     * @return The module mask, 0 if no module handles the command.
+     */
+    unsigned char findCommand(const char* command) {
+        uint32_t hash = hashCommand(command);
+        for (int probe = 0; probe < SUITE_COMMAND_SLOTS; ++probe) {
+            const CommentCommand& slot = commandTable[(hash + probe) & (SUITE_COMMAND_SLOTS - 1)];
+            if (!slot.name) {
+                return 0;
+            }
+            if (slot.hash == hash && commandEquals(command, slot.name)) {
+                return slot.modules;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Subscribes a module to a variable.
+     * @param variableId The variable ID.
+     * @param module The module flag.
+     */
+    void subscribeVariable(int variableId, unsigned char module) {
+        if (variableId <= 0) {
+            return;
+        }
+        if (static_cast<size_t>(variableId) >= variableSubscribers.size()) {
+            variableSubscribers.resize(variableId + 1, 0);
+        }
+        variableSubscribers[variableId] |= module;
+    }
+
+    /**
+     * @brief Subscribes a module to a scene.
+     * @param scene The scene.
+     * @param module The module flag.
+     */
+    void subscribeScene(RPG::Scene scene, unsigned char module) {
+        if (scene >= 0 && scene < SUITE_SCENE_COUNT) {
+            sceneSubscribers[scene] |= module;
+        }
+    }
+
+    /**
+     * @brief Builds the scene, variable and command subscriptions of the enabled modules.
+     * @details Reads the variable IDs from the loaded module configurations, so it
+     *          must run after the modules have started.
+     */
+    void buildSubscriptions() {
+        memset(sceneSubscribers, 0, sizeof(sceneSubscribers));
+        memset(commandTable, 0, sizeof(commandTable));
+        variableSubscribers.clear();
+
+        if (enabledModules & MODULE_BARE_HANDED) {
+            subscribeScene(RPG::SCENE_MAP, MODULE_BARE_HANDED);
+            subscribeScene(RPG::SCENE_MENU, MODULE_BARE_HANDED);
+            subscribeScene(RPG::SCENE_SHOP, MODULE_BARE_HANDED);
+
+            int maxVariableId = static_cast<int>(BareHandedModule::BareHandedConfig::weaponVariableBits.size()) * 32;
+            for (int id = 1; id < maxVariableId; ++id) {
+                if (BareHandedModule::BareHandedConfig::isWeaponVariable(id)) {
+                    subscribeVariable(id, MODULE_BARE_HANDED);
+                }
+            }
+
+            addCommand("unequipbarehand", MODULE_BARE_HANDED);
+            addCommand("updatebarehand", MODULE_BARE_HANDED);
+        }
+
+        if (enabledModules & MODULE_DIRECT_SKILLS) {
+            subscribeScene(RPG::SCENE_BATTLE, MODULE_DIRECT_SKILLS);
+
+            for (auto const& pair : DirectSkillsModule::DirectSkillsConfig::commandToSkillMap) {
+                if (pair.second < 0) {
+                    subscribeVariable(-pair.second, MODULE_DIRECT_SKILLS);
+                }
+            }
+        }
+
+        if (enabledModules & MODULE_DYNAMIC_QUICKPATCH) {
+            subscribeScene(RPG::SCENE_MAP, MODULE_DYNAMIC_QUICKPATCH);
+
+            // Memory watches are swept in every scene
+            if (!DynamicQuickPatchModule::DynamicQuickPatchConfig::getWatches().empty()) {
+                for (int scene = 0; scene < SUITE_SCENE_COUNT; ++scene) {
+                    subscribeScene(static_cast<RPG::Scene>(scene), MODULE_DYNAMIC_QUICKPATCH);
+                }
+            }
+
+            int maxVariableId = DynamicQuickPatchModule::DynamicQuickPatchConfig::getMaxVariableId();
+            for (int id = 1; id <= maxVariableId; ++id) {
+                if (DynamicQuickPatchModule::DynamicQuickPatchConfig::hasPatchForVariable(id)) {
+                    subscribeVariable(id, MODULE_DYNAMIC_QUICKPATCH);
+                }
+            }
+        }
+
+        if (enabledModules & MODULE_LIMIT_BREAK) {
+            subscribeScene(RPG::SCENE_BATTLE, MODULE_LIMIT_BREAK);
+
+            subscribeVariable(LimitBreakModule::LimitBreakConfig::ultimateLimitVarId, MODULE_LIMIT_BREAK);
+            for (auto const& profile : LimitBreakModule::LimitBreakConfig::actorProfiles) {
+                if (profile.configured) {
+                    subscribeVariable(profile.limitVarId, MODULE_LIMIT_BREAK);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Starts one module if DynRPG.ini has a section for it.
+     * @param sectionName The module's DynRPG.ini section, as used by the standalone plugin.
+     * @param module The module flag.
+     * @param startup The module's onStartup function.
+     * @return False if the module failed to start.
+     */
+    bool startModule(const char* sectionName, Module module, bool (*startup)(char*)) {
+        if (!IniCache::hasSection(sectionName)) {
+            return true; // Module not configured, leave it disabled
+        }
+
+        char name[32];
+        strncpy(name, sectionName, sizeof(name) - 1);
+        name[sizeof(name) - 1] = '\0';
+
+        if (!startup(name)) {
+            return false;
+        }
+
+        enabledModules |= module;
+        return true;
+    }
+
+    /**
+     * @brief Starts all configured modules.
+     * @param pluginName Name of the suite's own section in DynRPG.ini (unused).
+     * @return False if any configured module failed to start.
+     * @details Every module reads its usual section ([bare_handed], [direct_skills],
+     *          [dynamic_quickpatch], [limit_break]); a module without a section is
+     *          not started and receives no callbacks.
+     */
+    bool onStartup(char *pluginName) {
+        (void)pluginName;
+        enabledModules = 0;
+
+        // The modules share one debug log; it is stopped once in onExit
+        AsyncLog::setHostOwned(true);
+
+        bool result = startModule("bare_handed", MODULE_BARE_HANDED, BareHandedModule::BareHanded::onStartup);
+        result = startModule("direct_skills", MODULE_DIRECT_SKILLS, DirectSkillsModule::DirectSkills::onStartup) && result;
+        result = startModule("dynamic_quickpatch", MODULE_DYNAMIC_QUICKPATCH, DynamicQuickPatchModule::DynamicQuickPatch::onStartup) && result;
+        result = startModule("limit_break", MODULE_LIMIT_BREAK, LimitBreakModule::LimitBreak::onStartup) && result;
+
+        buildSubscriptions();
+        return result;
+    }
+
+    /**
+     * @brief Forwards game initialization to the modules.
+     */
+    void onInitFinished() {
+        if (enabledModules & MODULE_LIMIT_BREAK) LimitBreakModule::LimitBreak::onInitFinished();
+    }
+
+    /**
+     * @brief Forwards a new game to the modules.
+     */
+    void onNewGame() {
+        if (enabledModules & MODULE_DYNAMIC_QUICKPATCH) DynamicQuickPatchModule::DynamicQuickPatch::onNewGame();
+    }
+
+    /**
+     * @brief Forwards a loaded game to the modules.
+     * @param id Save slot ID.
+     * @param data Plugin save data.
+     * @param length Length of the save data.
+     */
+    void onLoadGame(int id, char* data, int length) {
+        if (enabledModules & MODULE_DYNAMIC_QUICKPATCH) DynamicQuickPatchModule::DynamicQuickPatch::onLoadGame(id, data, length);
+    }
+
+    /**
+     * @brief Forwards a frame to the modules subscribed to the scene.
+     * @param scene The current scene.
+     * @note On the first frame of a new scene every module is called, so
+     *       modules can react to leaving their scenes.
+     */
+    void onFrame(RPG::Scene scene) {
+        int modules;
+        if (scene != lastScene) {
+            lastScene = scene;
+            modules = enabledModules;
+        } else {
+            modules = (scene >= 0 && scene < SUITE_SCENE_COUNT) ? (sceneSubscribers[scene] & enabledModules) : 0;
+        }
+
+        // Every module reads the same party slots during this frame
+        PartySnapshot::capture();
+        if (modules & MODULE_BARE_HANDED) BareHandedModule::BareHanded::onFrame(scene);
+        if (modules & MODULE_DIRECT_SKILLS) DirectSkillsModule::DirectSkills::onFrame(scene);
+        if (modules & MODULE_DYNAMIC_QUICKPATCH) DynamicQuickPatchModule::DynamicQuickPatch::onFrame(scene);
+        if (modules & MODULE_LIMIT_BREAK) LimitBreakModule::LimitBreak::onFrame(scene);
+        PartySnapshot::release();
+    }
+
+    /**
+     * @brief Forwards a variable change to the modules using the variable.
+     * @param id Variable ID being changed.
+     * @param value New value of the variable.
+     * @return False if any module blocks the change.
+     */
+    bool onSetVariable(int id, int value) {
+        if (id <= 0 || static_cast<size_t>(id) >= variableSubscribers.size()) {
+            return true;
+        }
+
+        int modules = variableSubscribers[id] & enabledModules;
+        if (!modules) {
+            return true;
+        }
+
+        bool result = true;
+        if (modules & MODULE_BARE_HANDED) result = BareHandedModule::BareHanded::onSetVariable(id, value) && result;
+        if (modules & MODULE_DIRECT_SKILLS) result = DirectSkillsModule::DirectSkills::onSetVariable(id, value) && result;
+        if (modules & MODULE_DYNAMIC_QUICKPATCH) result = DynamicQuickPatchModule::DynamicQuickPatch::onSetVariable(id, value) && result;
+        if (modules & MODULE_LIMIT_BREAK) result = LimitBreakModule::LimitBreak::onSetVariable(id, value) && result;
+        return result;
+    }
+
+    /**
+     * @brief Forwards a comment command to the modules owning it.
+     * @return False if a module handled the command.
+     */
+    bool onComment(const char *text, const RPG::ParsedCommentData *parsedData,
+                   RPG::EventScriptLine *nextScriptLine, RPG::EventScriptData *scriptData,
+                   int eventId, int pageId, int lineId, int *nextLineId) {
+        if (parsedData->command[0] == '\0') {
+            return true; // Not a command
+        }
+
+        int modules = findCommand(parsedData->command) & enabledModules;
+        if (!modules) {
+            return true;
+        }
+
+        bool result = true;
+        if (modules & MODULE_BARE_HANDED) {
+            result = BareHandedModule::BareHanded::onComment(text, parsedData, nextScriptLine, scriptData,
+                                                             eventId, pageId, lineId, nextLineId) && result;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Forwards a battler action to the battle modules.
+     * @return False if any module asks to be called again.
+     * @note direct_skills runs first, so limit_break sees the replaced action,
+     *       the same order as the standalone DLLs.
+     */
+    bool onDoBattlerAction(RPG::Battler* battler, bool firstTry) {
+        bool result = true;
+        if (enabledModules & MODULE_DIRECT_SKILLS) result = DirectSkillsModule::DirectSkills::onDoBattlerAction(battler, firstTry) && result;
+        if (enabledModules & MODULE_LIMIT_BREAK) result = LimitBreakModule::LimitBreak::onDoBattlerAction(battler, firstTry) && result;
+        return result;
+    }
+
+    /**
+     * @brief Forwards a finished battler action to the battle modules.
+     * @return False if any module asks to be called again.
+     */
+    bool onBattlerActionDone(RPG::Battler* battler, bool success) {
+        bool result = true;
+        if (enabledModules & MODULE_DIRECT_SKILLS) result = DirectSkillsModule::DirectSkills::onBattlerActionDone(battler, success) && result;
+        if (enabledModules & MODULE_LIMIT_BREAK) result = LimitBreakModule::LimitBreak::onBattlerActionDone(battler, success) && result;
+        return result;
+    }
+
+    /**
+     * @brief Forwards battle status window drawing to the modules.
+     */
+    bool onDrawBattleStatusWindow(int x, int selection, bool selActive, bool isTargetSelection, bool isVisible) {
+        if (!(enabledModules & MODULE_LIMIT_BREAK)) return true;
+        return LimitBreakModule::LimitBreak::onDrawBattleStatusWindow(x, selection, selActive, isTargetSelection, isVisible);
+    }
+
+    /**
+     * @brief Forwards battle action window drawing to the modules.
+     */
+    bool onDrawBattleActionWindow(int* x, int* y, int selection, bool selActive, bool isVisible) {
+        if (!(enabledModules & MODULE_LIMIT_BREAK)) return true;
+        return LimitBreakModule::LimitBreak::onDrawBattleActionWindow(x, y, selection, selActive, isVisible);
+    }
+
+    /**
+     * @brief Shuts down all started modules.
+     */
+    void onExit() {
+        if (enabledModules & MODULE_LIMIT_BREAK) LimitBreakModule::LimitBreak::onExit();
+        if (enabledModules & MODULE_DYNAMIC_QUICKPATCH) DynamicQuickPatchModule::DynamicQuickPatch::onExit();
+        if (enabledModules & MODULE_DIRECT_SKILLS) DirectSkillsModule::DirectSkills::onExit();
+        if (enabledModules & MODULE_BARE_HANDED) BareHandedModule::BareHanded::onExit();
+
+        // The modules only detached from the shared log above; stop it once
+        // now that nothing writes to it, then let them release their consoles
+        AsyncLog::setHostOwned(false);
+        AsyncLog::stop();
+        if (enabledModules & MODULE_LIMIT_BREAK) LimitBreakModule::Dialog::CloseTrace();
+        if (enabledModules & MODULE_DYNAMIC_QUICKPATCH) DynamicQuickPatchModule::Debug::cleanupConsole();
+        if (enabledModules & MODULE_DIRECT_SKILLS) DirectSkillsModule::Debug::cleanupConsole();
+        if (enabledModules & MODULE_BARE_HANDED) BareHandedModule::Debug::cleanupConsole();
+        enabledModules = 0;
+    }
+} // namespace Suite